@@ -82,17 +82,26 @@ COMMON_SRC = \
             fc/rc_controls.c \
             fc/rc_modes.c \
             flight/position.c \
+            flight/actuator_log.c \
             flight/failsafe.c \
+            flight/flat_piro.c \
+            flight/governor.c \
             flight/gps_rescue.c \
             flight/gyroanalyse.c \
             flight/imu.c \
             flight/interpolated_setpoint.c \
+            flight/loop_profile.c \
             flight/mixer.c \
+            flight/mixer_plan.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
             flight/rpm_filter.c \
+            flight/servo_calib.c \
+            flight/servo_curve.c \
+            flight/servo_slew.c \
             flight/servos.c \
             flight/servos_tricopter.c \
+            flight/swash.c \
             io/serial_4way.c \
             io/serial_4way_avrootloader.c \
             io/serial_4way_stk500v2.c \
@@ -226,9 +235,13 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/rc.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
+            flight/flat_piro.c \
+            flight/governor.c \
             flight/gyroanalyse.c \
             flight/imu.c \
+            flight/loop_profile.c \
             flight/mixer.c \
+            flight/mixer_plan.c \
             flight/pid.c \
             flight/rpm_filter.c \
             rx/ibus.c \
@@ -60,6 +60,7 @@
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
+#include "flight/governor.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
@@ -86,12 +87,13 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 2);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .p_ratio = 32,
     .device = DEFAULT_BLACKBOX_DEVICE,
     .record_acc = 1,
+    .record_gov = 1,
     .mode = BLACKBOX_MODE_NORMAL
 );
 
@@ -216,6 +218,20 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
 #endif
     {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI},
 
+    // HF3D:  Governor feedforward battery voltage compensation factor * 1000
+    {"govVbatComp", -1, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(GOV_VBAT_COMP)},
+    // HF3D:  Motor driven tail torque precompensation * 1000
+    {"tailPrecomp", -1, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(TAIL_PRECOMP)},
+    // HF3D:  Governor headspeed (rpm), setpoint and rate limited setpoint (rpm), PID sum and feedforwards * 1000, status flags
+    {"govHeadspeed", -1, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govSetpoint",  0, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govSetpoint",  1, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govPidSum",   -1, SIGNED,   .Ipredict = PREDICT(0),      .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govFF",        0, SIGNED,   .Ipredict = PREDICT(0),      .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govFF",        1, SIGNED,   .Ipredict = PREDICT(0),      .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govFF",        2, SIGNED,   .Ipredict = PREDICT(0),      .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+    {"govStatus",   -1, UNSIGNED, .Ipredict = PREDICT(0),      .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(GOVERNOR)},
+
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
     {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
     {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
@@ -319,6 +335,13 @@ typedef struct blackboxMainState_s {
     int32_t surfaceRaw;
 #endif
     uint16_t rssi;
+    uint16_t govVbatComp;
+    uint16_t tailPrecomp;
+    uint16_t govHeadspeed;
+    uint16_t govSetpoint[2];
+    int16_t govPidSum;
+    int16_t govFF[3];
+    uint8_t govStatus;
 } blackboxMainState_t;
 
 typedef struct blackboxGpsState_s {
@@ -468,6 +491,15 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
     case FLIGHT_LOG_FIELD_CONDITION_DEBUG:
         return debugMode != DEBUG_NONE;
 
+    case FLIGHT_LOG_FIELD_CONDITION_GOV_VBAT_COMP:
+        return mixerConfig()->gov_vbat_comp && isBatteryVoltageConfigured();
+
+    case FLIGHT_LOG_FIELD_CONDITION_TAIL_PRECOMP:
+        return getMotorCount() > 1 && (mixerConfig()->tail_precomp_throttle_gain || mixerConfig()->tail_precomp_collective_gain || mixerConfig()->tail_precomp_accel_gain);
+
+    case FLIGHT_LOG_FIELD_CONDITION_GOVERNOR:
+        return getMotorCount() > 0 && mixerConfig()->gov_max_headspeed && blackboxConfig()->record_gov;
+
     case FLIGHT_LOG_FIELD_CONDITION_NEVER:
         return false;
 
@@ -598,6 +630,23 @@ static void writeIntraframe(void)
         blackboxWriteUnsignedVB(blackboxCurrent->rssi);
     }
 
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GOV_VBAT_COMP)) {
+        blackboxWriteUnsignedVB(blackboxCurrent->govVbatComp);
+    }
+
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TAIL_PRECOMP)) {
+        blackboxWriteUnsignedVB(blackboxCurrent->tailPrecomp);
+    }
+
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GOVERNOR)) {
+        blackboxWriteUnsignedVB(blackboxCurrent->govHeadspeed);
+        blackboxWriteUnsignedVB(blackboxCurrent->govSetpoint[0]);
+        blackboxWriteUnsignedVB(blackboxCurrent->govSetpoint[1]);
+        blackboxWriteSignedVB(blackboxCurrent->govPidSum);
+        blackboxWriteSigned16VBArray(blackboxCurrent->govFF, 3);
+        blackboxWriteUnsignedVB(blackboxCurrent->govStatus);
+    }
+
     blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
         blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
@@ -740,6 +789,27 @@ static void writeInterframe(void)
 
     blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
 
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GOV_VBAT_COMP)) {
+        blackboxWriteSignedVB((int32_t) blackboxCurrent->govVbatComp - blackboxLast->govVbatComp);
+    }
+
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TAIL_PRECOMP)) {
+        blackboxWriteSignedVB((int32_t) blackboxCurrent->tailPrecomp - blackboxLast->tailPrecomp);
+    }
+
+    // The governor runs decimated on fresh RPM data, so these deltas are mostly zero and pack into a single tag byte
+    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_GOVERNOR)) {
+        deltas[0] = (int32_t) blackboxCurrent->govHeadspeed - blackboxLast->govHeadspeed;
+        deltas[1] = (int32_t) blackboxCurrent->govSetpoint[0] - blackboxLast->govSetpoint[0];
+        deltas[2] = (int32_t) blackboxCurrent->govSetpoint[1] - blackboxLast->govSetpoint[1];
+        deltas[3] = blackboxCurrent->govPidSum - blackboxLast->govPidSum;
+        for (int x = 0; x < 3; x++) {
+            deltas[4 + x] = blackboxCurrent->govFF[x] - blackboxLast->govFF[x];
+        }
+        deltas[7] = (int32_t) blackboxCurrent->govStatus - blackboxLast->govStatus;
+        blackboxWriteTag8_8SVB(deltas, 8);
+    }
+
     //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
     blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
@@ -1067,6 +1137,20 @@ static void loadMainState(timeUs_t currentTimeUs)
 
     blackboxCurrent->rssi = getRssi();
 
+    blackboxCurrent->govVbatComp = lrintf(mixerGetGovVbatCompensation() * 1000);
+    blackboxCurrent->tailPrecomp = lrintf(mixerGetTailPrecompensation() * 1000);
+
+    governorTelemetry_t governor;
+    governorGetTelemetry(mixerGetGovernorState(), &governor);
+    blackboxCurrent->govHeadspeed = governor.headspeed;
+    blackboxCurrent->govSetpoint[0] = governor.setpoint;
+    blackboxCurrent->govSetpoint[1] = governor.setpointLimited;
+    blackboxCurrent->govPidSum = governor.pidSum;
+    blackboxCurrent->govFF[0] = governor.collectiveFF;
+    blackboxCurrent->govFF[1] = governor.collectivePulseFF;
+    blackboxCurrent->govFF[2] = governor.cyclicFF;
+    blackboxCurrent->govStatus = governor.status;
+
 #ifdef USE_SERVOS
     //Tail servo for tricopters
     blackboxCurrent->servo[5] = servo[5];
@@ -1473,6 +1557,11 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
             blackboxWriteSignedVB(data->inflightAdjustment.newValue);
         }
         break;
+    case FLIGHT_LOG_EVENT_GOV_BAILOUT:
+        blackboxWrite(data->govBailout.active);
+        blackboxWriteUnsignedVB(data->govBailout.headspeed);
+        blackboxWriteUnsignedVB(data->govBailout.time);
+        break;
     case FLIGHT_LOG_EVENT_LOGGING_RESUME:
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
@@ -43,6 +43,7 @@ typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT = 13,
     FLIGHT_LOG_EVENT_LOGGING_RESUME = 14,
     FLIGHT_LOG_EVENT_FLIGHTMODE = 30, // Add new event type for flight mode status.
+    FLIGHT_LOG_EVENT_GOV_BAILOUT = 31, // HF3D:  Governor autorotation bailout start / end
     FLIGHT_LOG_EVENT_LOG_END = 255
 } FlightLogEvent;
 
@@ -50,6 +51,7 @@ typedef struct blackboxConfig_s {
     uint16_t p_ratio; // I-frame interval / P-frame interval
     uint8_t device;
     uint8_t record_acc;
+    uint8_t record_gov;             // HF3D:  log the governor fields when the governor is enabled
     uint8_t mode;
 } blackboxConfig_t;
 
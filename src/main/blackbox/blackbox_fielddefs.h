@@ -48,6 +48,10 @@ typedef enum FlightLogFieldCondition {
     FLIGHT_LOG_FIELD_CONDITION_ACC,
     FLIGHT_LOG_FIELD_CONDITION_DEBUG,
 
+    FLIGHT_LOG_FIELD_CONDITION_GOV_VBAT_COMP,
+    FLIGHT_LOG_FIELD_CONDITION_TAIL_PRECOMP,
+    FLIGHT_LOG_FIELD_CONDITION_GOVERNOR,
+
     FLIGHT_LOG_FIELD_CONDITION_NEVER,
 
     FLIGHT_LOG_FIELD_CONDITION_FIRST = FLIGHT_LOG_FIELD_CONDITION_ALWAYS,
@@ -125,6 +129,12 @@ typedef struct flightLogEvent_inflightAdjustment_s {
     bool floatFlag;
 } flightLogEvent_inflightAdjustment_t;
 
+typedef struct flightLogEvent_govBailout_s {
+    uint8_t active;             // 1 = bailout started, 0 = bailout ended
+    uint16_t headspeed;         // rpm
+    uint16_t time;              // bailout duration in ms, on end
+} flightLogEvent_govBailout_t;
+
 typedef struct flightLogEvent_loggingResume_s {
     uint32_t logIteration;
     uint32_t currentTime;
@@ -137,6 +147,7 @@ typedef union flightLogEventData_u {
     flightLogEvent_flightMode_t flightMode; // New event data
     flightLogEvent_inflightAdjustment_t inflightAdjustment;
     flightLogEvent_loggingResume_t loggingResume;
+    flightLogEvent_govBailout_t govBailout;
 } flightLogEventData_t;
 
 typedef struct flightLogEvent_s {
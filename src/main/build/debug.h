@@ -86,7 +86,7 @@ typedef enum {
     DEBUG_SDIO,
     DEBUG_CURRENT_SENSOR,
     DEBUG_USB,
-    DEBUG_SMARTAUDIO,           // HF3D: Using this for governor, to change name should update Configurator and BB Explorer debug lists to keep them in sync
+    DEBUG_SMARTAUDIO,
     DEBUG_RTH,
     DEBUG_ITERM_RELAX,
     DEBUG_ACRO_TRAINER,
@@ -112,6 +112,7 @@ typedef enum {
     DEBUG_FF_LIMIT,
     DEBUG_FF_INTERPOLATED,
     DEBUG_BLACKBOX_OUTPUT,
+    DEBUG_SWASH_LOAD,
     DEBUG_COUNT
 } debugType_e;
 
@@ -100,6 +100,7 @@ bool cliMode = false;
 
 #include "flight/failsafe.h"
 #include "flight/imu.h"
+#include "flight/loop_profile.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
@@ -814,6 +815,9 @@ static void cliPrintVarRange(const clivalue_t *var)
     break;
     case (MODE_ARRAY): {
         cliPrintLinef("Array length: %d", var->config.array.length);
+        if (var->config.array.max) {
+            cliPrintLinef("Allowed range: %d - %d", var->config.array.min, var->config.array.max);
+        }
     }
     break;
     case (MODE_BITSET): {
@@ -2149,6 +2153,85 @@ static void cliServo(char *cmdline)
 
     }
 }
+
+// HF3D:  Servo linearisation curves
+static void printServoCurveLine(dumpFlags_t dumpMask, bool equalsDefault, unsigned index, const servoCurve_t *curve, bool isDefault)
+{
+    const char *format = "servocurve %u %d %d %d %d %d %d %d %d %d";
+    STATIC_ASSERT(SERVO_CURVE_POINTS == 9, servo_curve_format_mismatch);
+
+    const int16_t *p = curve->point;
+    if (isDefault) {
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format, index, p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]);
+    } else {
+        cliDumpPrintLinef(dumpMask, equalsDefault, format, index, p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]);
+    }
+}
+
+static void printServoCurve(dumpFlags_t dumpMask, const servoCurve_t *curves, const servoCurve_t *defaultCurves, const char *headingStr)
+{
+    headingStr = cliPrintSectionHeading(dumpMask, false, headingStr);
+    for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        bool equalsDefault = false;
+        if (defaultCurves) {
+            equalsDefault = !memcmp(&curves[i], &defaultCurves[i], sizeof(curves[i]));
+            headingStr = cliPrintSectionHeading(dumpMask, !equalsDefault, headingStr);
+            printServoCurveLine(dumpMask, equalsDefault, i, &defaultCurves[i], true);
+        }
+        printServoCurveLine(dumpMask, equalsDefault, i, &curves[i], false);
+    }
+}
+
+static void cliServoCurve(char *cmdline)
+{
+    if (isEmpty(cmdline)) {
+        printServoCurve(DUMP_MASTER, servoCurves(0), NULL, NULL);
+        return;
+    }
+
+    const int index = atoi(cmdline);
+    const char *ptr = nextArg(cmdline);
+    if (index < 0 || index >= MAX_SUPPORTED_SERVOS || !ptr) {
+        cliShowParseError();
+        return;
+    }
+
+    servoCurve_t *curve = servoCurvesMutable(index);
+
+    if (strncasecmp(ptr, "reset", 5) == 0) {
+        servoCurveReset(curve);
+    } else if (strncasecmp(ptr, "arm", 3) == 0) {
+        // Generate the curve from the servo arm angle at full travel
+        ptr = nextArg(ptr);
+        const int angle = ptr ? atoi(ptr) : -1;
+        if (angle < 0 || angle > SERVO_CURVE_ARM_ANGLE_MAX) {
+            cliShowArgumentRangeError("ARM ANGLE", 0, SERVO_CURVE_ARM_ANGLE_MAX);
+            return;
+        }
+        servoCurveGenerateArm(curve, angle);
+    } else {
+        // Measured points, from -SERVO_CURVE_RANGE to +SERVO_CURVE_RANGE command
+        servoCurve_t points;
+        int count = 0;
+        while (ptr && count < SERVO_CURVE_POINTS) {
+            const int value = atoi(ptr);
+            if (value < -SERVO_CURVE_POINT_MAX || value > SERVO_CURVE_POINT_MAX) {
+                cliShowArgumentRangeError("POINT", -SERVO_CURVE_POINT_MAX, SERVO_CURVE_POINT_MAX);
+                return;
+            }
+            points.point[count++] = value;
+            ptr = nextArg(ptr);
+        }
+        if (count != SERVO_CURVE_POINTS || ptr) {
+            cliShowParseError();
+            return;
+        }
+        *curve = points;
+    }
+
+    servosCurveInit();
+    printServoCurveLine(0, false, index, curve, false);
+}
 #endif
 
 #ifdef USE_SERVOS
@@ -3670,6 +3753,128 @@ static void cliServoInputOverride(char *cmdline)
     }
 }
 
+#ifdef USE_SERVOS
+static void printServoCalibration(void)
+{
+    if (!servoCalibIsActive()) {
+        cliPrintLinef("Servo calibration is off.");
+        return;
+    }
+
+    const int step = servoCalibGetStep();
+    cliPrintLinef("Step %d of %d: roll %d pitch %d collective %d", step + 1, SERVO_CALIB_STEPS,
+        servoCalibGrid[step][SWASH_INPUT_ROLL], servoCalibGrid[step][SWASH_INPUT_PITCH], servoCalibGrid[step][SWASH_INPUT_COLLECTIVE]);
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        cliPrintLinef(" Servo %d trim %d pulse %d", i, servoCalibGetTrim(i), servoCalibGetPulse(i));
+    }
+}
+
+static void cliServoCalibration(char *cmdline)
+{
+    if (isEmpty(cmdline)) {
+        printServoCalibration();
+        return;
+    }
+
+    if (strncasecmp(cmdline, "start", 5) == 0) {
+        if (!servoCalibStart()) {
+            cliPrintErrorLinef("CALIBRATION NEEDS THE HELI MIXER AND DISARMED");
+            return;
+        }
+    } else if (strncasecmp(cmdline, "stop", 4) == 0) {
+        servoCalibStop();
+    } else if (strncasecmp(cmdline, "trim", 4) == 0) {
+        const char *ptr = nextArg(cmdline);
+        const int index = ptr ? atoi(ptr) : -1;
+        ptr = ptr ? nextArg(ptr) : NULL;
+        if (index < 0 || index >= SWASH_SERVO_COUNT || !ptr) {
+            cliShowParseError();
+            return;
+        }
+        const int trim = atoi(ptr);
+        if (trim < -SERVO_CALIB_TRIM_MAX || trim > SERVO_CALIB_TRIM_MAX) {
+            cliShowArgumentRangeError("TRIM", -SERVO_CALIB_TRIM_MAX, SERVO_CALIB_TRIM_MAX);
+            return;
+        }
+        if (!servoCalibSetTrim(index, trim)) {
+            cliPrintErrorLinef("CALIBRATION IS NOT RUNNING");
+            return;
+        }
+    } else if (strncasecmp(cmdline, "next", 4) == 0) {
+        switch (servoCalibNext()) {
+        case SERVO_CALIB_STEP_DONE:
+            break;
+        case SERVO_CALIB_FINISHED:
+            cliPrintLinef("Calibration done, servo settings updated. Use 'save' to keep them.");
+            for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+                cliPrintLinef(" Servo %d middle %d rate %d%s", i, servoParams(i)->middle, servoParams(i)->rate,
+                    (servoParams(i)->reversedSources & (1 << INPUT_RC_AUX1)) ? " reversed" : "");
+            }
+            return;
+        default:
+            cliPrintErrorLinef("CALIBRATION FAILED");
+            return;
+        }
+    } else {
+        cliShowParseError();
+        return;
+    }
+
+    printServoCalibration();
+}
+#endif
+
+#ifdef USE_LOOP_PROFILE
+static void printLoopProfileMicros(uint32_t cycles)
+{
+    const unsigned hundredths = (uint64_t)cycles * 100 / loopProfileGetCyclesPerMicro();
+
+    cliPrintf(" %5u.%02u", hundredths / 100, hundredths % 100);
+}
+
+static void printLoopProfile(void)
+{
+    cliPrintLinef("# loop profile %s, %u cycles/us", loopProfileIsActive() ? "running" : "stopped", (unsigned)loopProfileGetCyclesPerMicro());
+    cliPrintLine("#  stage      count   min/us   avg/us   max/us |   <1   <2   <4   <8  <16  <32  <64 <128 <256 more %");
+
+    for (int i = 0; i < LOOP_PROFILE_STAGE_COUNT; i++) {
+        const loopProfileStats_t *stats = loopProfileGetStats(i);
+
+        cliPrintf("%8s %10u", loopProfileStageNames[i], (unsigned)stats->count);
+        if (stats->count) {
+            printLoopProfileMicros(stats->min);
+            printLoopProfileMicros(loopProfileGetAverage(i));
+            printLoopProfileMicros(stats->max);
+            cliPrint(" |");
+            for (int j = 0; j < LOOP_PROFILE_BUCKETS; j++) {
+                cliPrintf(" %4u", (unsigned)((stats->histogram[j] * 100ULL + stats->count / 2) / stats->count));
+            }
+        }
+        cliPrintLinefeed();
+    }
+}
+
+static void cliLoopProfile(char *cmdline)
+{
+    if (isEmpty(cmdline)) {
+        printLoopProfile();
+        return;
+    }
+
+    if (strncasecmp(cmdline, "start", 5) == 0) {
+        loopProfileStart();
+    } else if (strncasecmp(cmdline, "stop", 4) == 0) {
+        loopProfileStop();
+    } else if (strncasecmp(cmdline, "reset", 5) == 0) {
+        loopProfileReset();
+    } else {
+        cliShowParseError();
+        return;
+    }
+
+    printLoopProfile();
+}
+#endif
 
 #ifndef MINIMAL_CLI
 static void cliPlaySound(char *cmdline)
@@ -4046,6 +4251,52 @@ uint16_t cliGetSettingIndex(char *name, uint8_t length)
     return valueTableEntryCount;
 }
 
+// HF3D:  Renamed settings, still accepted by set so that older diffs restore.
+//   An alias of an array setting writes its first element.
+typedef struct cliSettingAlias_s {
+    const char *name;
+    const char *target;
+} cliSettingAlias_t;
+
+static const cliSettingAlias_t settingAliases[] = {
+    { "gov_gear_ratio", "motor_gear_ratio" },
+};
+
+static uint16_t cliGetSettingAliasIndex(char *name, uint8_t length)
+{
+    for (unsigned i = 0; i < ARRAYLEN(settingAliases); i++) {
+        const char *aliasName = settingAliases[i].name;
+
+        if (strncasecmp(name, aliasName, strlen(aliasName)) == 0 && length == strlen(aliasName)) {
+            const char *target = settingAliases[i].target;
+            return cliGetSettingIndex((char *)target, strlen(target));
+        }
+    }
+    return valueTableEntryCount;
+}
+
+// HF3D:  Check every element of an array setting before any of them is stored
+static bool isArrayInRange(const clivalue_t *var, char *valPtr)
+{
+    if (!var->config.array.max) {
+        return true;
+    }
+
+    for (int i = 0; i < var->config.array.length && valPtr; i++) {
+        valPtr = skipSpace(valPtr);
+        const int value = atoi(valPtr);
+        if (value < var->config.array.min || value > var->config.array.max) {
+            return false;
+        }
+        valPtr = strchr(valPtr, ',');
+        if (valPtr) {
+            valPtr++;
+        }
+    }
+
+    return true;
+}
+
 STATIC_UNIT_TESTED void cliSet(char *cmdline)
 {
     const uint32_t len = strlen(cmdline);
@@ -4069,7 +4320,10 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
         eqptr++;
         eqptr = skipSpace(eqptr);
 
-        const uint16_t index = cliGetSettingIndex(cmdline, variableNameLength);
+        uint16_t index = cliGetSettingIndex(cmdline, variableNameLength);
+        if (index >= valueTableEntryCount) {
+            index = cliGetSettingAliasIndex(cmdline, variableNameLength);
+        }
         if (index >= valueTableEntryCount) {
             cliPrintErrorLinef("INVALID NAME");
             return;
@@ -4130,6 +4384,10 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
                 const uint8_t arrayLength = val->config.array.length;
                 char *valPtr = eqptr;
 
+                if (!isArrayInRange(val, eqptr)) {
+                    break;
+                }
+
                 int i = 0;
                 while (i < arrayLength && valPtr != NULL) {
                     // skip spaces
@@ -4188,14 +4446,17 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
                     }
 
                     // find next comma (or end of string)
-                    valPtr = strchr(valPtr, ',') + 1;
+                    valPtr = strchr(valPtr, ',');
+                    if (valPtr) {
+                        valPtr++;
+                    }
 
                     i++;
                 }
-            }
 
-            // mark as changed
-            valueChanged = true;
+                // mark as changed
+                valueChanged = true;
+            }
 
             break;
         case MODE_STRING: {
@@ -5580,18 +5841,10 @@ static void cliDshotTelemetryInfo(char *cmdline)
         cliPrintLine("=====   =======   ======   =====");
 #endif
         for (uint8_t i = 0; i < getMotorCount(); i++) {
-            // HF3D TODO:  Make motorPoleCount an array for differnet main/tail pole counts, update CLI/MSP telemetry/LUA/configurator to match
-            if (i == 1) {         // Tail motor
-                cliPrintf("%5d   %7d   %6d   %5d   ", i,
+            cliPrintf("%5d   %7d   %6d   %5d   ", i,
                       (int)getDshotTelemetry(i) * 100,
-                      (int)getDshotTelemetry(i) * 100 * 2 / 12,
-                      (int)getDshotTelemetry(i) * 100 * 2 / 12 / 60);
-            } else {            // Main/other motor
-                cliPrintf("%5d   %7d   %6d   %5d   ", i,
-                          (int)getDshotTelemetry(i) * 100,
-                          (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount,
-                          (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount / 60);
-            }
+                      (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount[i],
+                      (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount[i] / 60);
 #ifdef USE_DSHOT_TELEMETRY_STATS
             if (isDshotMotorTelemetryActive(i)) {
                 const int calcPercent = getDshotTelemetryMotorInvalidPercent(i);
@@ -5728,6 +5981,8 @@ static void printConfig(char *cmdline, bool doDiff)
                 servoMixHeadingStr = NULL;
             }
             printServoMix(dumpMask, customServoMixers_CopyArray, customServoMixers(0), servoMixHeadingStr);
+
+            printServoCurve(dumpMask, servoCurves_CopyArray, servoCurves(0), "servo curve");
 #endif
 #endif
 
@@ -5975,6 +6230,9 @@ const clicmd_t cmdTable[] = {
 #endif
 #if defined(USE_BOARD_INFO)
     CLI_COMMAND_DEF("manufacturer_id", "get / set the id of the board manufacturer", "[manufacturer id]", cliManufacturerId),
+#endif
+#ifdef USE_LOOP_PROFILE
+    CLI_COMMAND_DEF("loopprofile", "pid loop stage timing", "[start | stop | reset]", cliLoopProfile),
 #endif
     CLI_COMMAND_DEF("map", "configure rc channel order", "[<map>]", cliMap),
     CLI_COMMAND_DEF("mcu_id", "id of the microcontroller", NULL, cliMcuId),
@@ -6020,6 +6278,11 @@ const clicmd_t cmdTable[] = {
 #endif
 #ifdef USE_SERVOS
     CLI_COMMAND_DEF("servo", "configure servos", NULL, cliServo),
+    CLI_COMMAND_DEF("servocal", "swash servo calibration", "start | stop | next\r\n"
+        "\ttrim <servo> <us>", cliServoCalibration),
+    CLI_COMMAND_DEF("servocurve", "servo linearisation curves", "<servo> <point> ... <point>\r\n"
+        "\t<servo> arm <angle>\r\n"
+        "\t<servo> reset", cliServoCurve),
     CLI_COMMAND_DEF("servo_position",  "get servo positions/set servo position offsets", "<index> [<value>]", cliServoPosition),
     CLI_COMMAND_DEF("servo_input_override",  "get/set servo input overrides (collective/roll/pitch/yaw)", "<index> [<value>]", cliServoInputOverride),
 #endif
@@ -47,6 +47,7 @@
 #include "fc/rc_controls.h"
 
 #include "flight/failsafe.h"
+#include "flight/flat_piro.h"
 #include "flight/gps_rescue.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
@@ -457,6 +458,28 @@ const char * const lookupTableOsdDisplayPortDevice[] = {
     "NONE", "AUTO", "MAX7456", "MSP", "FRSKYOSD"
 };
 
+static const char * const lookupTableGovLoadMap[] = {
+    "OFF", "ON", "LEARN"
+};
+
+static const char * const lookupTablePiroCompMode[] = {
+    "OFF", "FIXED", "AUTO"
+};
+
+static const char * const lookupTableRotorDir[] = {
+    "CW", "CCW"
+};
+
+#ifdef USE_SERVOS
+static const char * const lookupTableSwashType[] = {
+    "SMIX", "120", "135", "140", "90", "CUSTOM"
+};
+
+static const char * const lookupTableSwashRingMode[] = {
+    "OFF", "CIRCULAR", "ELLIPTICAL", "QUADRANT"
+};
+#endif
+
 #ifdef USE_OSD
 static const char * const lookupTableOsdLogoOnArming[] = {
     "OFF", "ON", "FIRST_ARMING",
@@ -578,6 +601,13 @@ const lookupTableEntry_t lookupTables[] = {
     LOOKUP_TABLE_ENTRY(lookupTableInterpolatedSetpoint),
     LOOKUP_TABLE_ENTRY(lookupTableDshotBitbangedTimer),
     LOOKUP_TABLE_ENTRY(lookupTableOsdDisplayPortDevice),
+    LOOKUP_TABLE_ENTRY(lookupTableGovLoadMap),
+    LOOKUP_TABLE_ENTRY(lookupTablePiroCompMode),
+    LOOKUP_TABLE_ENTRY(lookupTableRotorDir),
+#ifdef USE_SERVOS
+    LOOKUP_TABLE_ENTRY(lookupTableSwashType),
+    LOOKUP_TABLE_ENTRY(lookupTableSwashRingMode),
+#endif
 
 #ifdef USE_OSD
     LOOKUP_TABLE_ENTRY(lookupTableOsdLogoOnArming),
@@ -645,7 +675,7 @@ const clivalue_t valueTable[] = {
     { "acc_trim_roll",              VAR_INT16  | MASTER_VALUE, .config.minmax = { -300, 300 }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, accelerometerTrims.values.roll) },
 
     // 4 elements are output for the ACC calibration - The 3 axis values and the 4th representing whether calibration has been performed
-    { "acc_calibration",            VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array.length = 4, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, accZero.raw) },
+    { "acc_calibration",            VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array = { 4 }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, accZero.raw) },
 #endif
 
 // PG_COMPASS_CONFIG
@@ -660,7 +690,7 @@ const clivalue_t valueTable[] = {
     { "mag_spi_device",             VAR_UINT8  | HARDWARE_VALUE, .config.minmaxUnsigned = { 0, SPIDEV_COUNT }, PG_COMPASS_CONFIG, offsetof(compassConfig_t, mag_spi_device) },
     { "mag_hardware",               VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_MAG_HARDWARE }, PG_COMPASS_CONFIG, offsetof(compassConfig_t, mag_hardware) },
     { "mag_declination",            VAR_INT16  | MASTER_VALUE, .config.minmax = { -18000, 18000 }, PG_COMPASS_CONFIG, offsetof(compassConfig_t, mag_declination) },
-    { "mag_calibration",            VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array.length = XYZ_AXIS_COUNT, PG_COMPASS_CONFIG, offsetof(compassConfig_t, magZero.raw) },
+    { "mag_calibration",            VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array = { XYZ_AXIS_COUNT }, PG_COMPASS_CONFIG, offsetof(compassConfig_t, magZero.raw) },
 #endif
 
 // PG_BAROMETER_CONFIG
@@ -744,6 +774,7 @@ const clivalue_t valueTable[] = {
     { "blackbox_p_ratio",           VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, INT16_MAX }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, p_ratio) },
     { "blackbox_device",            VAR_UINT8  | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_BLACKBOX_DEVICE }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, device) },
     { "blackbox_record_acc",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, record_acc) },
+    { "blackbox_record_gov",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, record_gov) },
     { "blackbox_mode",              VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_BLACKBOX_MODE }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, mode) },
 #endif
 
@@ -768,7 +799,11 @@ const clivalue_t valueTable[] = {
     { "motor_pwm_protocol",         VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_MOTOR_PWM_PROTOCOL }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, dev.motorPwmProtocol) },
     { "motor_pwm_rate",             VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 200, 32000 }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, dev.motorPwmRate) },
     { "motor_pwm_inversion",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, dev.motorPwmInversion) },
-    { "motor_poles",                VAR_UINT8 | MASTER_VALUE, .config.minmaxUnsigned = { 4, UINT8_MAX }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, motorPoleCount) },
+    { "motor_poles",                VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_MOTORS, MOTOR_POLE_COUNT_MIN, UINT8_MAX }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, motorPoleCount) },
+    // HF3D:  Motor turns per rotor turn * 100, main motor to main rotor and tail motor to tail rotor
+    { "motor_gear_ratio",           VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_MOTORS, MOTOR_GEAR_RATIO_MIN, MOTOR_GEAR_RATIO_MAX }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, motorGearRatio) },
+    // HF3D:  0 = AUTO (DShot telemetry, else ESC sensor), 1 = DSHOT telemetry, 2 = ESC sensor, 3 = NONE
+    { "motor_rpm_source",           VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_MOTORS, RPM_SOURCE_AUTO, RPM_SOURCE_NONE }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, motorRpmSource) },
 
 // PG_THROTTLE_CORRECTION_CONFIG
     { "thr_corr_value",             VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0,  150 }, PG_THROTTLE_CORRECTION_CONFIG, offsetof(throttleCorrectionConfig_t, throttle_correction_value) },
@@ -845,7 +880,6 @@ const clivalue_t valueTable[] = {
     { "crashflip_motor_percent",    VAR_UINT8 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 100 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, crashflip_motor_percent) },
     // HF3D:  Governor settings
     { "gov_max_headspeed",          VAR_UINT16 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 10000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_max_headspeed) },
-    { "gov_gear_ratio",             VAR_UINT16 |  MASTER_VALUE,  .config.minmaxUnsigned = { 100, 3000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_gear_ratio) },
     // HF3D TODO:  Move these governor settings to profiles eventually
     { "gov_p_gain",                 VAR_UINT16 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_p_gain) },
     { "gov_i_gain",                 VAR_UINT16 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_i_gain) },
@@ -853,7 +887,24 @@ const clivalue_t valueTable[] = {
     { "gov_collective_ff_gain",     VAR_UINT16 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_collective_ff_gain) },
     { "gov_collective_ff_impulse_gain",  VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_collective_ff_impulse_gain) },
     { "gov_collective_ff_impulse_freq",  VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_collective_ff_impulse_freq) },
-    { "spoolup_time",               VAR_UINT8 |  MASTER_VALUE,  .config.minmaxUnsigned = { 1, 15 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, spoolup_time) },
+    { "spoolup_time",               VAR_UINT16|  MASTER_VALUE,  .config.minmaxUnsigned = { 1, 15 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, spoolup_time) },
+    { "gov_vbat_comp",              VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_vbat_comp) },
+    { "tail_precomp_throttle_gain",   VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_precomp_throttle_gain) },
+    { "tail_precomp_collective_gain", VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_precomp_collective_gain) },
+    { "tail_precomp_accel_gain",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_precomp_accel_gain) },
+    { "gov_bailout_time",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 50 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_bailout_time) },
+    { "gov_bailout_min_headspeed",  VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_bailout_min_headspeed) },
+    { "main_rotor_dir",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_ROTOR_DIR }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, main_rotor_dir) },
+
+// PG_GOVERNOR_LOAD_MAP
+    // HF3D:  Governor steady state throttle (0.5% units) vs. collective (0-100% in 10% steps), one row per headspeed (% of gov_max_headspeed)
+    { "gov_load_map",               VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_GOV_LOAD_MAP }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, mode) },
+    { "gov_load_map_50",            VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[0]) },
+    { "gov_load_map_60",            VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[1]) },
+    { "gov_load_map_70",            VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[2]) },
+    { "gov_load_map_80",            VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[3]) },
+    { "gov_load_map_90",            VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[4]) },
+    { "gov_load_map_100",           VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { GOV_LOAD_MAP_COLLECTIVE_POINTS, 0, GOV_LOAD_MAP_THROTTLE_MAX }, PG_GOVERNOR_LOAD_MAP, offsetof(governorLoadMap_t, throttle[5]) },
 
 // PG_MOTOR_3D_CONFIG
     { "3d_deadband_low",            VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_RANGE_MIDDLE }, PG_MOTOR_3D_CONFIG, offsetof(flight3DConfig_t, deadband3d_low) },
@@ -868,10 +919,26 @@ const clivalue_t valueTable[] = {
 #ifdef USE_SERVOS
     // HF3D TODO:  Servo center pulse no longer used.  Port is initialized to 0 pulse width until servo mixer provides a desired output.  Consider removing this parameter.
     { "servo_center_pulse",         VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_PULSE_MAX }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoCenterPulse) },
-    { "servo_pwm_rate",             VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 50, 493 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoPwmRate) },
+    { "servo_pwm_rate",             VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 50, SERVO_PWM_RATE_MAX }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoPwmRate) },
     { "servo_lowpass_hz",           VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 400}, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_lowpass_freq) },
     { "tri_unarmed_servo",          VAR_INT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SERVO_CONFIG, offsetof(servoConfig_t, tri_unarmed_servo) },
     { "channel_forwarding_start",   VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { AUX1, MAX_SUPPORTED_RC_CHANNEL_COUNT }, PG_SERVO_CONFIG, offsetof(servoConfig_t, channelForwardingStartChannel) },
+    { "swash_type",                 VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_SWASH_TYPE }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_type) },
+    { "swash_servo_angle",          VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array = { SWASH_SERVO_COUNT }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_servo_angle) },
+    { "swash_ring_mode",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_SWASH_RING_MODE }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_ring_mode) },
+    { "swash_ring_limit",           VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { SWASH_RING_LIMIT_COUNT }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_ring_limit) },
+    { "servo_rate_limit",           VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_SERVOS }, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_rate_limit) },
+    { "servo_accel_limit",          VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_SERVOS }, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_accel_limit) },
+    { "servo_narrow_band",          VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { MAX_SUPPORTED_SERVOS, 0, 1 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_narrow_band) },
+    { "collective_curve",           VAR_INT16  | MASTER_VALUE | MODE_ARRAY, .config.array = { SERVO_CURVE_POINTS }, PG_SERVO_CONFIG, offsetof(servoConfig_t, collective_curve.point) },
+    { "collective_min",             VAR_INT16  | MASTER_VALUE, .config.minmax = { -COLLECTIVE_RANGE, COLLECTIVE_RANGE }, PG_SERVO_CONFIG, offsetof(servoConfig_t, collective_min) },
+    { "collective_max",             VAR_INT16  | MASTER_VALUE, .config.minmax = { -COLLECTIVE_RANGE, COLLECTIVE_RANGE }, PG_SERVO_CONFIG, offsetof(servoConfig_t, collective_max) },
+    { "collective_stall_limit",     VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, collective_stall_limit) },
+    { "collective_stall_headspeed", VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, collective_stall_headspeed) },
+    { "swash_load_comp",            VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { SWASH_SERVO_COUNT * SWASH_RING_LIMIT_COUNT }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_load_comp) },
+    { "swash_phase",                VAR_INT16  | MASTER_VALUE, .config.minmax = { -SWASH_PHASE_MAX, SWASH_PHASE_MAX }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_phase) },
+    { "swash_phase_low",            VAR_INT16  | MASTER_VALUE, .config.minmax = { -SWASH_PHASE_MAX, SWASH_PHASE_MAX }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_phase_low) },
+    { "swash_phase_low_headspeed",  VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 99 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, swash_phase_low_headspeed) },
 #endif
 
 // PG_CONTROLRATE_PROFILES
@@ -1097,9 +1164,22 @@ const clivalue_t valueTable[] = {
     { "yaw_collective_ff_impulse_gain", VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 2000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawColPulseKf) },
     { "yaw_cyclic_ff_gain",             VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 1000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawCycKf) },
     { "yaw_base_thrust",                VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 3000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawBaseThrust) },
+    { "roll_collective_ff_gain",        VAR_INT16 | PROFILE_VALUE, .config.minmax = { -2000, 2000 }, PG_PID_PROFILE, offsetof(pidProfile_t, rollColKf) },
+    { "roll_collective_ff_impulse_gain", VAR_INT16 | PROFILE_VALUE, .config.minmax = { -2000, 2000 }, PG_PID_PROFILE, offsetof(pidProfile_t, rollColPulseKf) },
+    { "pitch_collective_ff_gain",       VAR_INT16 | PROFILE_VALUE, .config.minmax = { -2000, 2000 }, PG_PID_PROFILE, offsetof(pidProfile_t, pitchColKf) },
+    { "pitch_collective_ff_impulse_gain", VAR_INT16 | PROFILE_VALUE, .config.minmax = { -2000, 2000 }, PG_PID_PROFILE, offsetof(pidProfile_t, pitchColPulseKf) },
     { "rescue_collective",              VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 50, 500 },PG_PID_PROFILE, offsetof(pidProfile_t, rescue_collective) },
     { "error_decay_always",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_PID_PROFILE, offsetof(pidProfile_t, error_decay_always) },
     { "error_decay_rate",               VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 45 },PG_PID_PROFILE, offsetof(pidProfile_t, error_decay_rate) },
+    { "hs_gain_mode",                   VAR_UINT8  | PROFILE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_PID_PROFILE, offsetof(pidProfile_t, hs_gain_mode) },
+    { "hs_gain_headspeed",              VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array = { HEADSPEED_GAIN_POINTS }, PG_PID_PROFILE, offsetof(pidProfile_t, hs_gain_headspeed) },
+    { "hs_gain_roll",                   VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array = { HEADSPEED_GAIN_POINTS }, PG_PID_PROFILE, offsetof(pidProfile_t, hs_gain[FD_ROLL]) },
+    { "hs_gain_pitch",                  VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array = { HEADSPEED_GAIN_POINTS }, PG_PID_PROFILE, offsetof(pidProfile_t, hs_gain[FD_PITCH]) },
+    { "hs_gain_yaw",                    VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array = { HEADSPEED_GAIN_POINTS }, PG_PID_PROFILE, offsetof(pidProfile_t, hs_gain[FD_YAW]) },
+    { "piro_comp_mode",                 VAR_UINT8  | PROFILE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_PIRO_COMP_MODE }, PG_PID_PROFILE, offsetof(pidProfile_t, piro_comp_mode) },
+    { "piro_comp_delay",                VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_PID_PROFILE, offsetof(pidProfile_t, piro_comp_delay) },
+    { "flat_piro_tilt",                 VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, FLAT_PIRO_TILT_MAX }, PG_PID_PROFILE, offsetof(pidProfile_t, flat_piro_tilt) },
+    { "flat_piro_headspeed",            VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 10000 }, PG_PID_PROFILE, offsetof(pidProfile_t, flat_piro_headspeed) },
     
 // PG_TELEMETRY_CONFIG
 #ifdef USE_TELEMETRY
@@ -1118,7 +1198,10 @@ const clivalue_t valueTable[] = {
     { "pid_in_tlm",                 VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = {TABLE_OFF_ON }, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, pidValuesAsTelemetry) },
     { "report_cell_voltage",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, report_cell_voltage) },
 #if defined(USE_TELEMETRY_IBUS)
-    { "ibus_sensor",                VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = IBUS_SENSOR_COUNT, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, flysky_sensors)},
+    { "ibus_sensor",                VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array = { IBUS_SENSOR_COUNT }, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, flysky_sensors)},
+#endif
+#ifdef USE_TELEMETRY_CRSF
+    { "crsf_gov_rate",              VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 50 }, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, crsf_gov_rate) },
 #endif
 #ifdef USE_TELEMETRY_MAVLINK
     // Support for misusing the heading field in MAVlink to indicate mAh drawn for Connex Prosight OSD
@@ -1360,7 +1443,7 @@ const clivalue_t valueTable[] = {
     { "osd_gps_sats_show_hdop",     VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_OSD_CONFIG, offsetof(osdConfig_t, gps_sats_show_hdop) },
     { "osd_displayport_device",     VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OSD_DISPLAYPORT_DEVICE }, PG_OSD_CONFIG, offsetof(osdConfig_t, displayPortDevice) },
 
-    { "osd_rcchannels",             VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = OSD_RCCHANNELS_COUNT, PG_OSD_CONFIG, offsetof(osdConfig_t, rcChannels) },
+    { "osd_rcchannels",             VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { OSD_RCCHANNELS_COUNT }, PG_OSD_CONFIG, offsetof(osdConfig_t, rcChannels) },
     { "osd_camera_frame_width",     VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { OSD_CAMERA_FRAME_MIN_WIDTH, OSD_CAMERA_FRAME_MAX_WIDTH }, PG_OSD_CONFIG, offsetof(osdConfig_t, camera_frame_width) },
     { "osd_camera_frame_height",    VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { OSD_CAMERA_FRAME_MIN_HEIGHT, OSD_CAMERA_FRAME_MAX_HEIGHT }, PG_OSD_CONFIG, offsetof(osdConfig_t, camera_frame_height) },
 #endif // end of #ifdef USE_OSD
@@ -1400,9 +1483,9 @@ const clivalue_t valueTable[] = {
     { "displayport_msp_col_adjust", VAR_INT8    | MASTER_VALUE, .config.minmax = { -6, 0 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, colAdjust) },
     { "displayport_msp_row_adjust", VAR_INT8    | MASTER_VALUE, .config.minmax = { -3, 0 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, rowAdjust) },
     { "displayport_msp_serial",     VAR_INT8    | MASTER_VALUE, .config.minmax = { SERIAL_PORT_NONE, SERIAL_PORT_IDENTIFIER_MAX }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, displayPortSerial) },
-    { "displayport_msp_attrs",      VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 4, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, attrValues) },
+    { "displayport_msp_attrs",      VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { 4 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, attrValues) },
 #ifdef USE_DISPLAYPORT_MSP_VENDOR_SPECIFIC
-    { "displayport_msp_vendor_init", VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 253, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, vendorInit) },
+    { "displayport_msp_vendor_init", VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { 253 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, vendorInit) },
     { "displayport_msp_vendor_init_length", VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 0, 252 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, vendorInitLength) },
 #endif // USE_DISPLAYPORT_MSP_VENDOR_SPECIFIC
 #endif
@@ -1424,9 +1507,9 @@ const clivalue_t valueTable[] = {
 
 #ifdef USE_RX_FRSKY_SPI
     { "frsky_spi_autobind",             VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, autoBind) },
-    { "frsky_spi_tx_id",                VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 2, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindTxId) },
+    { "frsky_spi_tx_id",                VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { 2 }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindTxId) },
     { "frsky_spi_offset",               VAR_INT8    | MASTER_VALUE, .config.minmax = { -127, 127 }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindOffset) },
-    { "frsky_spi_bind_hop_data",        VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 50, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindHopData) },
+    { "frsky_spi_bind_hop_data",        VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array = { 50 }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindHopData) },
     { "frsky_x_rx_num",                 VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT8_MAX }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, rxNum) },
     { "frsky_spi_a1_source",            VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_RX_FRSKY_SPI_A1_SOURCE }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, a1Source) },
     { "cc2500_spi_chip_detect",         VAR_UINT8   | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, chipDetectEnabled) },
@@ -1440,9 +1523,9 @@ const clivalue_t valueTable[] = {
 
 // PG_PINIO_CONFIG
 #ifdef USE_PINIO
-    { "pinio_config", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array.length = PINIO_COUNT, PG_PINIO_CONFIG, offsetof(pinioConfig_t, config) },
+    { "pinio_config", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array = { PINIO_COUNT }, PG_PINIO_CONFIG, offsetof(pinioConfig_t, config) },
 #ifdef USE_PINIOBOX
-    { "pinio_box", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array.length = PINIO_COUNT, PG_PINIOBOX_CONFIG, offsetof(pinioBoxConfig_t, permanentId) },
+    { "pinio_box", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array = { PINIO_COUNT }, PG_PINIOBOX_CONFIG, offsetof(pinioBoxConfig_t, permanentId) },
 #endif
 #endif
 
@@ -1500,7 +1583,7 @@ const clivalue_t valueTable[] = {
 #endif
 #ifdef USE_RX_SPEKTRUM
     { "spektrum_spi_protocol",     VAR_UINT8 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT8_MAX }, PG_RX_SPEKTRUM_SPI_CONFIG, offsetof(spektrumConfig_t, protocol) },
-    { "spektrum_spi_mfg_id",       VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array.length = 4, PG_RX_SPEKTRUM_SPI_CONFIG, offsetof(spektrumConfig_t, mfgId) },
+    { "spektrum_spi_mfg_id",       VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array = { 4 }, PG_RX_SPEKTRUM_SPI_CONFIG, offsetof(spektrumConfig_t, mfgId) },
     { "spektrum_spi_num_channels", VAR_UINT8 | MASTER_VALUE, .config.minmaxUnsigned = { 0, DSM_MAX_CHANNEL_COUNT }, PG_RX_SPEKTRUM_SPI_CONFIG, offsetof(spektrumConfig_t, numChannels) },
 #endif
 
@@ -1522,7 +1605,7 @@ const clivalue_t valueTable[] = {
 
 #ifdef USE_RX_FLYSKY
     { "flysky_spi_tx_id",       VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_FLYSKY_CONFIG, offsetof(flySkyConfig_t, txId) },
-    { "flysky_spi_rf_channels", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array.length = 16, PG_FLYSKY_CONFIG, offsetof(flySkyConfig_t, rfChannelMap) },
+    { "flysky_spi_rf_channels", VAR_UINT8 | MASTER_VALUE | MODE_ARRAY, .config.array = { 16 }, PG_FLYSKY_CONFIG, offsetof(flySkyConfig_t, rfChannelMap) },
 #endif
 
 #ifdef USE_PERSISTENT_STATS
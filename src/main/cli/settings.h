@@ -130,6 +130,13 @@ typedef enum {
     TABLE_INTERPOLATED_SP,
     TABLE_DSHOT_BITBANGED_TIMER,
     TABLE_OSD_DISPLAYPORT_DEVICE,
+    TABLE_GOV_LOAD_MAP,
+    TABLE_PIRO_COMP_MODE,
+    TABLE_ROTOR_DIR,
+#ifdef USE_SERVOS
+    TABLE_SWASH_TYPE,
+    TABLE_SWASH_RING_MODE,
+#endif
 #ifdef USE_OSD
     TABLE_OSD_LOGO_ON_ARMING,
 #endif
@@ -193,6 +200,8 @@ typedef struct cliLookupTableConfig_s {
 
 typedef struct cliArrayLengthConfig_s {
     const uint8_t length;
+    const uint8_t min;                        // HF3D: element range, not checked when max is 0
+    const uint16_t max;
 } cliArrayLengthConfig_t;
 
 typedef struct cliStringLengthConfig_s {
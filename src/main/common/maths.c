@@ -180,12 +180,40 @@ int scaleRange(int x, int srcFrom, int srcTo, int destFrom, int destTo) {
     return (a / b) + destFrom;
 }
 
+// Piecewise linear interpolation in a table with non-decreasing x values, clamped to the end points
+float interpolateTablef(float x, const float *xTable, const float *yTable, int count)
+{
+    if (x <= xTable[0]) {
+        return yTable[0];
+    }
+    for (int i = 1; i < count; i++) {
+        if (x < xTable[i]) {
+            return scaleRangef(x, xTable[i - 1], xTable[i], yTable[i - 1], yTable[i]);
+        }
+    }
+    return yTable[count - 1];
+}
+
 float scaleRangef(float x, float srcFrom, float srcTo, float destFrom, float destTo) {
     float a = (destTo - destFrom) * (x - srcFrom);
     float b = srcTo - srcFrom;
     return (a / b) + destFrom;
 }
 
+// Fast 1/sqrt(x) for x > 0, bit level initial guess and one Newton step.
+//   Relative error is below 0.18%, and the result is never larger than the exact value,
+//   so a vector scaled by it never ends up longer than the intended length.
+float invSqrtf(float x)
+{
+    union {
+        float f;
+        uint32_t i;
+    } conv = { .f = x };
+
+    conv.i = 0x5f3759df - (conv.i >> 1);
+    return conv.f * (1.5f - 0.5f * x * conv.f * conv.f);
+}
+
 // Normalize a vector
 void normalizeV(struct fp_vector *src, struct fp_vector *dest)
 {
@@ -110,6 +110,8 @@ float degreesToRadians(int16_t degrees);
 
 int scaleRange(int x, int srcFrom, int srcTo, int destFrom, int destTo);
 float scaleRangef(float x, float srcFrom, float srcTo, float destFrom, float destTo);
+float interpolateTablef(float x, const float *xTable, const float *yTable, int count);
+float invSqrtf(float x);
 
 void normalizeV(struct fp_vector *src, struct fp_vector *dest);
 
@@ -268,6 +268,43 @@ static void validateAndFixConfig(void)
         motorConfigMutable()->dev.motorPwmRate = BRUSHLESS_MOTORS_PWM_RATE;
     }
 
+    // HF3D:  Per-motor arrays from an older or corrupted config
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        if (motorConfig()->motorPoleCount[i] < MOTOR_POLE_COUNT_MIN) {
+            motorConfigMutable()->motorPoleCount[i] = MOTOR_POLE_COUNT_MIN;
+        }
+        motorConfigMutable()->motorGearRatio[i] = constrain(motorConfig()->motorGearRatio[i], MOTOR_GEAR_RATIO_MIN, MOTOR_GEAR_RATIO_MAX);
+        if (motorConfig()->motorRpmSource[i] > RPM_SOURCE_NONE) {
+            motorConfigMutable()->motorRpmSource[i] = RPM_SOURCE_AUTO;
+        }
+    }
+
+#ifdef USE_SERVOS
+    // HF3D:  Servo frame rates above 493Hz are for narrow band servos, the longest servo pulse must still fit in the frame
+    int maxServoPulse = 0;
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        if (servoConfig()->dev.ioTags[i]) {
+            const int pulse = servoConfig()->servo_narrow_band[i] ? servoParams(i)->max / SERVO_NARROW_BAND_DIV : servoParams(i)->max;
+            maxServoPulse = MAX(maxServoPulse, pulse);
+        }
+    }
+    if (maxServoPulse > 0) {
+        const uint16_t maxServoRate = 1000000 / (maxServoPulse + SERVO_FRAME_MIN_GAP);
+        if (servoConfig()->dev.servoPwmRate > maxServoRate) {
+            servoConfigMutable()->dev.servoPwmRate = maxServoRate;
+        }
+    }
+
+    // HF3D:  The collective curve points aren't range checked by the CLI
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        servoConfigMutable()->collective_curve.point[i] = constrain(servoConfig()->collective_curve.point[i], -COLLECTIVE_RANGE, COLLECTIVE_RANGE);
+    }
+    if (servoConfig()->collective_min > servoConfig()->collective_max) {
+        servoConfigMutable()->collective_min = -COLLECTIVE_RANGE;
+        servoConfigMutable()->collective_max = COLLECTIVE_RANGE;
+    }
+#endif
+
     validateAndFixGyroConfig();
 
 #if defined(USE_MAG)
@@ -141,6 +141,12 @@ uint16_t getDshotTelemetry(uint8_t index)
     return dshotTelemetryState.motorState[index].telemetryValue;
 }
 
+// HF3D:  Number of valid telemetry frames received, counts a new frame even when the value didn't change
+uint32_t getDshotTelemetryUpdateCount(uint8_t index)
+{
+    return dshotTelemetryState.motorState[index].updateCount;
+}
+
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
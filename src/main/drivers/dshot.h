@@ -65,6 +65,7 @@ extern bool useDshotTelemetry;
 typedef struct dshotTelemetryMotorState_s {
     uint16_t telemetryValue;
     bool telemetryActive;
+    uint32_t updateCount;       // HF3D:  Valid telemetry frames received
 } dshotTelemetryMotorState_t;
 
 
@@ -84,6 +85,7 @@ void updateDshotTelemetryQuality(dshotTelemetryQuality_t *qualityStats, bool pac
 #endif
 
 uint16_t getDshotTelemetry(uint8_t index);
+uint32_t getDshotTelemetryUpdateCount(uint8_t index);
 bool isDshotMotorTelemetryActive(uint8_t motorIndex);
 bool isDshotTelemetryActive(void);
 
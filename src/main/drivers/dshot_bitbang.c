@@ -476,6 +476,7 @@ static bool bbUpdateStart(void)
             if (value != BB_INVALID) {
                 dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
                 dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
+                dshotTelemetryState.motorState[motorIndex].updateCount++;
                 if (motorIndex < 2) {
                     // erpm/100 (value) should never exceed ~32,767 (3.27M erpm)
                     DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, (int16_t) value);   
@@ -63,7 +63,7 @@ motorDevice_t *motorPwmDevInit(const struct motorDevConfig_s *motorDevConfig, ui
 typedef struct servoDevConfig_s {
     // PWM values, in milliseconds, common range is 1000-2000 (1ms to 2ms)
     uint16_t servoCenterPulse;              // HF3D TODO:  This was the value the servos are initialized to momentarily, but is no longer used.  Remove?
-    uint16_t servoPwmRate;                  // The update rate of servo outputs (50-498Hz)
+    uint16_t servoPwmRate;                  // The update rate of servo outputs (50-560Hz, above 493Hz for narrow band servos)
     ioTag_t  ioTags[MAX_SUPPORTED_SERVOS];
 } servoDevConfig_t;
 
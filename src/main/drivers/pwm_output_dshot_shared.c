@@ -233,6 +233,7 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
                 if (value != 0xffff) {
                     dshotTelemetryState.motorState[i].telemetryValue = value;
                     dshotTelemetryState.motorState[i].telemetryActive = true;
+                    dshotTelemetryState.motorState[i].updateCount++;
                     if (i < 2) {
                         // erpm/100 (value) should never exceed ~32,767 (3.27M erpm)
                         DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, (int16_t) value);
@@ -63,6 +63,7 @@
 #include "flight/gyroanalyse.h"
 #endif
 #include "flight/imu.h"
+#include "flight/loop_profile.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
@@ -417,6 +418,9 @@ void disarm(void)
         statsOnDisarm();
 #endif
 
+        // HF3D:  Keep the governor load map learned during the flight
+        mixerSaveGovernorLoadMap();
+
         // if ARMING_DISABLED_RUNAWAY_TAKEOFF is set then we want to play it's beep pattern instead
         if (!(getArmingDisableFlags() & (ARMING_DISABLED_RUNAWAY_TAKEOFF | ARMING_DISABLED_CRASH_DETECTED))) {
             beeper(BEEPER_DISARMING);      // emit disarm tone
@@ -988,8 +992,10 @@ static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
     if (debugMode == DEBUG_PIDLOOP) {startTime = micros();}
+    LOOP_PROFILE_BEGIN(pidStartCycles);
     // PID - note this is function pointer set by setPIDController()
     pidController(currentPidProfile, currentTimeUs);
+    LOOP_PROFILE_END(LOOP_PROFILE_PID, pidStartCycles);
     DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
 
 #ifdef USE_RUNAWAY_TAKEOFF
@@ -1044,6 +1050,7 @@ static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
     if (debugMode == DEBUG_PIDLOOP) {
         startTime = micros();
     }
+    LOOP_PROFILE_BEGIN(subprocStartCycles);
 
 #if defined(USE_GPS) || defined(USE_MAG)
     if (sensors(SENSOR_GPS) || sensors(SENSOR_MAG)) {
@@ -1059,6 +1066,7 @@ static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
     UNUSED(currentTimeUs);
 #endif
 
+    LOOP_PROFILE_END(LOOP_PROFILE_SUBPROC, subprocStartCycles);
     DEBUG_SET(DEBUG_PIDLOOP, 3, micros() - startTime);
 }
 
@@ -1086,16 +1094,22 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
         startTime = micros();
     }
 
+    LOOP_PROFILE_BEGIN(mixerStartCycles);
     mixTable(currentTimeUs, currentPidProfile->vbatPidCompensation);
+    LOOP_PROFILE_END(LOOP_PROFILE_MIXER, mixerStartCycles);
 
 #ifdef USE_SERVOS
     // motor outputs are used as sources for servo mixing, so motors must be calculated using mixTable() before servos.
     if (isMixerUsingServos()) {
+        LOOP_PROFILE_BEGIN(servoStartCycles);
         writeServos();
+        LOOP_PROFILE_END(LOOP_PROFILE_SERVO, servoStartCycles);
     }
 #endif
 
+    LOOP_PROFILE_BEGIN(motorStartCycles);
     writeMotors();
+    LOOP_PROFILE_END(LOOP_PROFILE_MOTOR, motorStartCycles);
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
     if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
@@ -1112,6 +1126,7 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
+    LOOP_PROFILE_BEGIN(rcStartCycles);
 
     // If we're armed, at minimum throttle, and we do arming via the
     // sticks, do not process yaw input from the rx.  We do this so the
@@ -1130,6 +1145,7 @@ static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
     }
 
     processRcCommand();
+    LOOP_PROFILE_END(LOOP_PROFILE_RC, rcStartCycles);
 }
 
 // Function for loop trigger
@@ -1141,6 +1157,8 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     if (lockMainPID() != 0) return;
 #endif
 
+    LOOP_PROFILE_BEGIN(loopStartCycles);
+
     // DEBUG_PIDLOOP, timings for:
     // 0 - gyroUpdate()
     // 1 - subTaskPidController()
@@ -1156,6 +1174,8 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
         subTaskPidSubprocesses(currentTimeUs);
     }
 
+    LOOP_PROFILE_END(LOOP_PROFILE_TOTAL, loopStartCycles);
+
     if (debugMode == DEBUG_CYCLETIME) {
         debug[0] = getTaskDeltaTime(TASK_SELF);
         debug[1] = averageSystemLoadPercent;
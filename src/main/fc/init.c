@@ -88,6 +88,7 @@
 
 #include "flight/failsafe.h"
 #include "flight/imu.h"
+#include "flight/loop_profile.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
@@ -702,6 +703,10 @@ void init(void)
     pidAudioInit();
 #endif
 
+#ifdef USE_LOOP_PROFILE
+    loopProfileInit(clockMicrosToCycles(1));
+#endif
+
 #ifdef USE_SERVOS
     servosInit();
     servoConfigureOutput();
@@ -74,6 +74,7 @@ typedef enum {
     BOXACROTRAINER,
     BOXVTXCONTROLDISABLE,
 //    BOXLAUNCHCONTROL,     // HF3D: Removed.
+    BOXAUTOROTATION,        // HF3D
     CHECKBOX_ITEM_COUNT
 } boxId_e;
 
@@ -0,0 +1,82 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_ACTUATOR_LOG
+
+#include "flight/actuator_log.h"
+
+static actuatorLogEntry_t actuatorLog[ACTUATOR_LOG_SIZE];
+static unsigned actuatorLogHead;            // next entry to write
+static unsigned actuatorLogCount;
+static bool actuatorLogFrozen;
+
+void actuatorLogReset(void)
+{
+    actuatorLogHead = 0;
+    actuatorLogCount = 0;
+    actuatorLogFrozen = false;
+}
+
+void actuatorLogWrite(const actuatorLogEntry_t *entry)
+{
+    if (actuatorLogFrozen) {
+        return;
+    }
+
+    actuatorLog[actuatorLogHead] = *entry;
+    actuatorLogHead = (actuatorLogHead + 1) % ACTUATOR_LOG_SIZE;
+    if (actuatorLogCount < ACTUATOR_LOG_SIZE) {
+        actuatorLogCount++;
+    }
+}
+
+void actuatorLogFreeze(void)
+{
+    actuatorLogFrozen = true;
+}
+
+bool actuatorLogIsFrozen(void)
+{
+    return actuatorLogFrozen;
+}
+
+unsigned actuatorLogGetCount(void)
+{
+    return actuatorLogCount;
+}
+
+// Entry 0 is the oldest
+const actuatorLogEntry_t *actuatorLogGetEntry(unsigned index)
+{
+    if (index >= actuatorLogCount) {
+        return NULL;
+    }
+
+    return &actuatorLog[(actuatorLogHead + ACTUATOR_LOG_SIZE - actuatorLogCount + index) % ACTUATOR_LOG_SIZE];
+}
+
+#endif // USE_ACTUATOR_LOG
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HF3D:  Actuator snapshot log.
+//   A RAM ring buffer of the servo and motor outputs at every servo update, for looking at actuator saturation
+//   after the flight at a higher rate than blackbox can afford. Recording stops on disarm or a crash so the
+//   last moments before it are kept, and starts again from empty on the next arming.
+
+#define ACTUATOR_LOG_SIZE       256         // entries, 8kB
+#define ACTUATOR_LOG_SERVOS     8
+#define ACTUATOR_LOG_MOTORS     4
+
+typedef struct actuatorLogEntry_s {
+    uint32_t time;                          // us
+    int16_t servo[ACTUATOR_LOG_SERVOS];     // us, after the filter and the slew limit
+    uint16_t motor[ACTUATOR_LOG_MOTORS];    // motor output value
+    uint16_t swashRing;                     // cyclic relative to the swash ring, permille
+    uint8_t servoClamped;                   // servo at its min or max, bit per servo
+    uint8_t servoSaturated;                 // servo behind its rate limit, bit per servo
+} actuatorLogEntry_t;
+
+void actuatorLogReset(void);
+void actuatorLogWrite(const actuatorLogEntry_t *entry);
+void actuatorLogFreeze(void);
+bool actuatorLogIsFrozen(void);
+unsigned actuatorLogGetCount(void);
+const actuatorLogEntry_t *actuatorLogGetEntry(unsigned index);
@@ -0,0 +1,53 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/flat_piro.h"
+#include "flight/mixer.h"
+
+void flatPiroInit(flatPiro_t *piro, uint8_t rotorDir, uint8_t tilt, uint16_t refHeadspeed)
+{
+    const float angle = MIN(tilt, FLAT_PIRO_TILT_MAX) * 0.1f * RAD;
+    const float tanTilt = sin_approx(angle) / cos_approx(angle);
+
+    // Clockwise rotor torque turns the body nose left, the tail pushes left against it and the disc leans right
+    piro->tanTilt = (rotorDir == ROTOR_DIR_CCW) ? -tanTilt : tanTilt;
+    piro->refHeadspeed = refHeadspeed;
+}
+
+float flatPiroApply(const flatPiro_t *piro, float yawRate, float headspeed, float collective)
+{
+    // Lean to the other side with negative thrust, none in between
+    float tanTilt = piro->tanTilt * constrainf(collective / FLAT_PIRO_COLLECTIVE_FADE, -1.0f, 1.0f);
+
+    // Without a headspeed measurement the lean stays as set
+    if (piro->refHeadspeed > 0 && headspeed > 0) {
+        tanTilt *= constrainf(piro->refHeadspeed / headspeed, FLAT_PIRO_HS_RATIO_MIN, FLAT_PIRO_HS_RATIO_MAX);
+    }
+
+    return yawRate * tanTilt;
+}
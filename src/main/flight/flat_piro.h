@@ -0,0 +1,48 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// HF3D:  Flat pirouette compensation.
+//   In a hover the main shaft leans away from the tail thrust, right for a clockwise main rotor seen from above.
+//   The tail thrust turns with the heli, so the lean has to stay on the same side of the heli while it pirouettes.
+//   Yawing about the leaning shaft doesn't move the lean at all, so the heli has to pitch along with the yaw
+//   rotation: pitch rate = yaw rate * tan(lean). Rates use the PID axis directions, positive pitch is nose down
+//   and positive yaw is nose left.
+//   The tail thrust follows the main rotor torque, which goes up as the headspeed drops at constant rotor power,
+//   so the lean can optionally be scaled by the reference headspeed over the measured headspeed.
+//   Inverted, the rotor thrust points the other way through the disc, so the disc has to lean the other way
+//   for the same sideways force. The lean follows the sign of the collective and fades to zero around zero
+//   collective, where the rotor has no thrust to tilt and the sign flips.
+
+#define FLAT_PIRO_TILT_MAX          200         // 0.1 degrees
+#define FLAT_PIRO_HS_RATIO_MIN      0.5f
+#define FLAT_PIRO_HS_RATIO_MAX      2.0f
+#define FLAT_PIRO_COLLECTIVE_FADE   50.0f       // rcCommand, lean fades out below this much collective either way
+
+typedef struct flatPiro_s {
+    float tanTilt;              // tangent of the lean, positive to the right
+    float refHeadspeed;         // rpm the lean was set at, 0 = lean doesn't depend on headspeed
+} flatPiro_t;
+
+void flatPiroInit(flatPiro_t *piro, uint8_t rotorDir, uint8_t tilt, uint16_t refHeadspeed);
+float flatPiroApply(const flatPiro_t *piro, float yawRate, float headspeed, float collective);
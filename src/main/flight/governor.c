@@ -0,0 +1,455 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/governor.h"
+
+#define GOV_SPOOLED_MIN_HEADSPEED       1000.0f     // rpm below which the heli is not considered spooled up
+#define GOV_SPOOLED_SETPOINT_RATIO      0.97f       // headspeed within 3% of setpoint ends the spool-up
+#define GOV_SPOOLED_MAX_THROTTLE        0.90f       // throttle at which the spool-up is ended regardless of headspeed
+#define GOV_ACTIVE_MIN_THROTTLE         0.50f       // governor is used above 50% throttle
+#define GOV_I_TERM_LIMIT                50.0f
+
+#define GOV_SPOOL_LOCK_TIME             5.5f        // must be a little longer than any of the checks below
+#define GOV_SPOOL_RESET_TIME            3.0f        // headspeed must be low for this long before requiring a slow spool-up
+#define GOV_SPOOL_RECOVERY_TIME         5.0f        // throttle back within this time after a throttle cut always bails out (glitch, accidental hold)
+
+#define GOV_BAILOUT_MAX_TIME            3.0f        // bailout is ended after this long even if the setpoint wasn't reached
+
+#define GOV_LOAD_MAP_MIN_HEADSPEED      0.5f        // first headspeed point, fraction of max headspeed
+#define GOV_LOAD_MAP_HEADSPEED_STEP     0.1f
+#define GOV_LOAD_MAP_COLLECTIVE_STEP    10.0f       // collective stick percent
+#define GOV_LOAD_MAP_LEARN_CUTOFF       0.2f        // Hz
+#define GOV_LOAD_MAP_LEARN_MAX_ERROR    0.01f       // only learn when headspeed is within 1% of the setpoint
+
+#define GOV_VBAT_FILTER_CUTOFF          0.5f        // Hz
+#define GOV_VBAT_COMP_MIN               0.80f
+#define GOV_VBAT_COMP_MAX               1.33f       // same limit as vbat_pid_gain
+
+void governorReset(governorState_t *state)
+{
+    state->spooledUp = false;
+    // Behave as if the last spool-up lock happened long ago
+    state->spoolEndTimer = GOV_SPOOL_LOCK_TIME;
+    state->lastSpoolThrottle = 0;
+    state->headspeed = 0;
+    state->setpoint = 0;
+    state->setpointLimited = 0;
+    state->bailout = false;
+    state->bailoutTimer = 0;
+    state->bailoutTime = 0;
+    state->idleTimer = GOV_SPOOL_RECOVERY_TIME;
+    state->baseThrottle = 0;
+    state->loadMapValid = false;
+    state->I = 0;
+    state->pidSum = 0;
+    state->collectiveFF = 0;
+    state->collectivePulseFF = 0;
+    state->cyclicFF = 0;
+    state->vbatFiltered = 0;
+    state->vbatCompensation = 1.0f;
+    state->throttle = 0;
+}
+
+void governorInit(governorState_t *state, const governorSettings_t *settings)
+{
+    memset(state, 0, sizeof(*state));
+    state->settings = *settings;
+    governorReset(state);
+}
+
+void governorLoadMapLoad(governorState_t *state, const governorLoadMap_t *map)
+{
+    for (int i = 0; i < GOV_LOAD_MAP_HEADSPEED_POINTS; i++) {
+        for (int j = 0; j < GOV_LOAD_MAP_COLLECTIVE_POINTS; j++) {
+            state->loadMap[i][j] = MIN(map->throttle[i][j], GOV_LOAD_MAP_THROTTLE_MAX) / GOV_LOAD_MAP_SCALE;
+        }
+    }
+    state->loadMapChanged = false;
+}
+
+// Returns true if the map was changed by learning since it was last loaded or stored
+bool governorLoadMapStore(governorState_t *state, governorLoadMap_t *map)
+{
+    const bool changed = state->loadMapChanged;
+
+    for (int i = 0; i < GOV_LOAD_MAP_HEADSPEED_POINTS; i++) {
+        for (int j = 0; j < GOV_LOAD_MAP_COLLECTIVE_POINTS; j++) {
+            const float value = state->loadMap[i][j];
+            // Learned cells never round down to the empty value
+            map->throttle[i][j] = (value > 0) ? constrain(lrintf(value * GOV_LOAD_MAP_SCALE), 1, GOV_LOAD_MAP_THROTTLE_MAX) : 0;
+        }
+    }
+    state->loadMapChanged = false;
+
+    return changed;
+}
+
+typedef struct governorLoadMapIndex_s {
+    int headspeed;
+    int collective;
+    float headspeedFraction;
+    float collectiveFraction;
+} governorLoadMapIndex_t;
+
+static void governorLoadMapGetIndex(governorLoadMapIndex_t *index, float headspeedRatio, float collective)
+{
+    const float h = constrainf((headspeedRatio - GOV_LOAD_MAP_MIN_HEADSPEED) / GOV_LOAD_MAP_HEADSPEED_STEP, 0, GOV_LOAD_MAP_HEADSPEED_POINTS - 1);
+    const float c = constrainf(fabsf(collective) / GOV_LOAD_MAP_COLLECTIVE_STEP, 0, GOV_LOAD_MAP_COLLECTIVE_POINTS - 1);
+
+    index->headspeed = MIN((int)h, GOV_LOAD_MAP_HEADSPEED_POINTS - 2);
+    index->collective = MIN((int)c, GOV_LOAD_MAP_COLLECTIVE_POINTS - 2);
+    index->headspeedFraction = h - index->headspeed;
+    index->collectiveFraction = c - index->collective;
+}
+
+// Bilinear interpolation between the four surrounding points, fails if any of them hasn't been learned yet
+static bool governorLoadMapLookup(const governorState_t *state, const governorLoadMapIndex_t *index, float *throttle)
+{
+    const float *row0 = state->loadMap[index->headspeed];
+    const float *row1 = state->loadMap[index->headspeed + 1];
+    const int j = index->collective;
+
+    if (row0[j] <= 0 || row0[j + 1] <= 0 || row1[j] <= 0 || row1[j + 1] <= 0) {
+        return false;
+    }
+
+    const float t0 = row0[j] + (row0[j + 1] - row0[j]) * index->collectiveFraction;
+    const float t1 = row1[j] + (row1[j + 1] - row1[j]) * index->collectiveFraction;
+    *throttle = t0 + (t1 - t0) * index->headspeedFraction;
+
+    return true;
+}
+
+// Move the four surrounding points towards the steady state throttle, weighted by their share of the estimate
+//   Points that haven't been learned yet are seeded with the target
+static void governorLoadMapLearn(governorState_t *state, const governorLoadMapIndex_t *index, bool estimateValid, float estimate, float target, float dt)
+{
+    const float RC = 1.0f / (2.0f * M_PIf * GOV_LOAD_MAP_LEARN_CUTOFF);
+    const float k = dt / (RC + dt);
+    const float error = target - estimate;
+
+    for (int i = 0; i < 2; i++) {
+        const float wh = i ? index->headspeedFraction : 1.0f - index->headspeedFraction;
+        float *row = state->loadMap[index->headspeed + i];
+
+        for (int j = 0; j < 2; j++) {
+            const float wc = j ? index->collectiveFraction : 1.0f - index->collectiveFraction;
+            float *point = &row[index->collective + j];
+
+            if (*point <= 0) {
+                *point = target;
+            } else if (estimateValid) {
+                *point = constrainf(*point + error * wh * wc * k, 1.0f / GOV_LOAD_MAP_SCALE, 1.0f);
+            }
+        }
+    }
+    state->loadMapChanged = true;
+}
+
+// Throttle delivers power in proportion to the battery voltage, so scale the feedforward up as the pack sags
+//   The PI terms are left alone, and the base throttle and load map are kept at the reference voltage
+static void governorUpdateVbatCompensation(governorState_t *state, const governorInputs_t *inputs, float dt)
+{
+    const float reference = state->settings.vbatCellVoltage * inputs->cellCount;
+
+    if (reference > 0 && inputs->voltage > 0) {
+        if (state->vbatFiltered <= 0) {
+            state->vbatFiltered = inputs->voltage;
+        } else {
+            const float RC = 1.0f / (2.0f * M_PIf * GOV_VBAT_FILTER_CUTOFF);
+            state->vbatFiltered += (inputs->voltage - state->vbatFiltered) * dt / (RC + dt);
+        }
+        state->vbatCompensation = constrainf(reference / state->vbatFiltered, GOV_VBAT_COMP_MIN, GOV_VBAT_COMP_MAX);
+    } else {
+        state->vbatCompensation = 1.0f;
+    }
+}
+
+static void governorUpdateSetpoint(governorState_t *state, const governorInputs_t *inputs, float dt)
+{
+    const governorSettings_t *settings = &state->settings;
+
+    // Use governor if throttle setting is >50%
+    // HF3D TODO:  Check !isDshotMotorTelemetryActive(i)
+    if (inputs->throttle > GOV_ACTIVE_MIN_THROTTLE && settings->maxHeadspeed > 0) {
+
+        // Set the user requested governor headspeed setting
+        state->setpoint = inputs->throttle * settings->maxHeadspeed;
+
+        // If we don't have a non-zero rate limited setpoint yet, set it to the headspeed
+        if (state->setpointLimited <= 0) {
+            state->setpointLimited = inputs->headspeed;
+
+            // Throttle is back while the rotor is still spooled up (autorotation, throttle hold, failsafe or RPM glitch)
+            //   Recover quickly to the setpoint instead of spooling up again.
+            if (state->spooledUp && settings->bailoutRampRate > 0 && inputs->headspeed > 0 &&
+                (inputs->autorotation || state->idleTimer < GOV_SPOOL_RECOVERY_TIME ||
+                 inputs->headspeed > state->setpoint * settings->bailoutMinHeadspeed)) {
+                state->bailout = true;
+                state->bailoutTimer = 0;
+            }
+        }
+        state->idleTimer = 0;
+
+        // If ramp is set to 5s then this will allow 20% change in 1 second, or 10% headspeed in 0.5 seconds.
+        const float govRampRate = (state->bailout ? settings->bailoutRampRate : settings->rampRate) * settings->maxHeadspeed * dt;
+        state->setpointLimited = constrainf(state->setpoint, state->setpointLimited - govRampRate, state->setpointLimited + govRampRate);
+
+        // Bailout ends when the setpoint is reached, and is bounded in time
+        if (state->bailout) {
+            state->bailoutTimer += dt;
+            if (state->setpointLimited == state->setpoint || state->bailoutTimer >= GOV_BAILOUT_MAX_TIME) {
+                state->bailout = false;
+                state->bailoutTime = state->bailoutTimer;
+            }
+        }
+    } else {
+        // Throttle is less than 50%, don't use governor.
+        state->setpoint = 0;
+        state->setpointLimited = 0;
+        state->bailout = false;
+        state->idleTimer = MIN(state->idleTimer + dt, GOV_SPOOL_RECOVERY_TIME);
+    }
+
+    if (inputs->headspeed == 0) {
+        // Disable governor if main motor RPM is not available
+        state->setpoint = 0;
+        state->setpointLimited = 0;
+        state->bailout = false;
+    }
+}
+
+static float governorUpdateSpoolup(governorState_t *state, const governorInputs_t *inputs, float throttle, float dt)
+{
+    const float headspeed = inputs->headspeed;
+
+    // Determine spoolup status
+    if (headspeed < GOV_SPOOLED_MIN_HEADSPEED && state->spoolEndTimer > GOV_SPOOL_RESET_TIME) {
+        // Require heli to spin up slowly if it's been more than 3 seconds since we last had a headspeed below 1000 rpm
+        state->spooledUp = false;
+
+    } else if (!state->setpoint && throttle <= state->lastSpoolThrottle) {
+        // Governor is disabled, running on throttle % only.
+        // If user spools up above 1000rpm, then lowers throttle below the last spool target, allow the heli to be considered spooled up
+        state->spooledUp = true;
+        state->lastSpoolThrottle = throttle;
+        // HF3D TODO:  lastSpoolThrottle can only go down here, so when the governor turns on it may get a very low
+        //   base throttle and the I-term has to wind up the entire amount.
+
+    } else if (!state->spooledUp && state->setpoint && headspeed > state->setpoint * GOV_SPOOLED_SETPOINT_RATIO) {
+        // Governor is enabled and headspeed is within 3% of the setpoint
+        state->spooledUp = true;
+        state->baseThrottle = state->lastSpoolThrottle / state->vbatCompensation;
+        state->setpointLimited = state->setpoint * GOV_SPOOLED_SETPOINT_RATIO;
+
+    } else if (!state->spooledUp && state->setpoint && state->lastSpoolThrottle > GOV_SPOOLED_MAX_THROTTLE) {
+        // Governor is enabled, and we've hit 90% throttle trying to get within 97% the requested headspeed.
+        // HF3D TODO:  Flag and alert user that gov_max_headspeed is set too high.
+        state->spooledUp = true;
+        state->baseThrottle = state->lastSpoolThrottle / state->vbatCompensation;
+        state->setpointLimited = headspeed;
+    }
+
+    // Handle ramping of throttle
+    if (throttle == 0.0f || !inputs->armed) {
+        // Don't reset spooledUp flag because we want throttle to respond quickly if user drops throttle in normal mode
+        //   or re-arms while blades are still spinning > 1000rpm.  spooledUp will reset anyway if RPM < 1000
+        state->lastSpoolThrottle = 0.0f;
+
+    } else if (!state->setpoint && !state->spooledUp && state->lastSpoolThrottle < throttle) {
+        // Governor is disabled, running on throttle % only.
+        throttle = state->lastSpoolThrottle + state->settings.rampRate * dt;
+        state->lastSpoolThrottle = throttle;
+
+    } else if (state->setpoint && !state->spooledUp && headspeed < state->setpoint) {
+        // Governor is enabled, running on headspeed.
+        throttle = state->lastSpoolThrottle + state->settings.rampRate * dt;
+        state->lastSpoolThrottle = throttle;
+    }
+
+    return throttle;
+}
+
+static float governorUpdateController(governorState_t *state, const governorInputs_t *inputs, float throttle, float dt)
+{
+    const governorSettings_t *settings = &state->settings;
+
+    // Calculate error as a percentage of the max headspeed, since 100% throttle should be close to max headspeed
+    const float govError = (state->setpointLimited - inputs->headspeed) / settings->maxHeadspeed;
+    const float govIChange = settings->Ki * govError * dt;
+
+    // Steady state throttle estimate from the load map, or the base throttle and linear collective feedforward if not learned yet
+    governorLoadMapIndex_t loadMapIndex;
+    float estimate = 0;
+    bool loadMapValid = false;
+    if (settings->loadMapMode != GOV_LOAD_MAP_OFF) {
+        governorLoadMapGetIndex(&loadMapIndex, state->setpointLimited / settings->maxHeadspeed, inputs->collective);
+        loadMapValid = governorLoadMapLookup(state, &loadMapIndex, &estimate);
+    }
+    if (!loadMapValid) {
+        estimate = state->baseThrottle + state->collectiveFF;
+    }
+
+    // if gov_p_gain = 10 (Kp = 1), we will get 1% change in throttle for 1% error in headspeed
+    const float govP = settings->Kp * govError;
+    // if gov_i_gain = 10 (Ki = 1), we will get 1% change in throttle for 1% error in headspeed after 1 second
+    state->I = constrainf(state->I + govIChange, -GOV_I_TERM_LIMIT, GOV_I_TERM_LIMIT);
+    state->pidSum = govP + state->I;
+
+    const float vbatComp = state->vbatCompensation;
+    throttle = (estimate + state->collectivePulseFF + state->cyclicFF) * vbatComp + state->pidSum;
+
+    // Remove last addition to I-term to prevent further wind-up if it was moving us towards this over-control
+    bool saturated = true;
+    if (throttle > 1.0f) {
+        if (govError > 0.0f) {
+            state->I -= govIChange;
+        }
+        throttle = 1.0f;
+    } else if (throttle < 0.0f) {
+        // HF3D TODO:  What if I-term was at contraints before we did this?
+        if (govError < 0.0f) {
+            state->I -= govIChange;
+        }
+        throttle = 0.0f;
+    } else {
+        saturated = false;
+    }
+
+    // Learn the steady state throttle for this operating point while holding headspeed
+    if (settings->loadMapMode == GOV_LOAD_MAP_LEARN && !saturated &&
+            state->setpointLimited == state->setpoint && fabsf(govError) < GOV_LOAD_MAP_LEARN_MAX_ERROR) {
+        const float target = estimate + state->I / vbatComp;
+        governorLoadMapLearn(state, &loadMapIndex, loadMapValid, estimate, target, dt);
+
+        // Move the change in the estimate out of the I-term, so that learning doesn't cause a throttle step
+        float newEstimate;
+        loadMapValid = governorLoadMapLookup(state, &loadMapIndex, &newEstimate);
+        if (loadMapValid) {
+            state->I -= (newEstimate - estimate) * vbatComp;
+        }
+    }
+    state->loadMapValid = loadMapValid;
+
+    // Slowly adapt the base throttle over time (LPF) as a fallback in case we lose RPM data.
+    //   Same as pt1FilterGain(), default cutoff of 0.05Hz (20s)
+    // HF3D TODO:  If always flying at high collective pitch, the collective FF will end up adding into the base throttle.
+    const float RC = 1.0f / (2.0f * M_PIf * settings->baseThrottleCutoff);
+    const float baseThrottleChange = (throttle / vbatComp - state->baseThrottle) * dt / (RC + dt);
+    state->baseThrottle += baseThrottleChange;
+    // Adjust the I-term to account for the base throttle adjustment we just made, if it's in use
+    if (!loadMapValid) {
+        state->I -= baseThrottleChange * vbatComp;
+    }
+
+    // Track the governor throttle signal when the governor is active
+    state->lastSpoolThrottle = throttle;
+
+    return throttle;
+}
+
+float governorUpdate(governorState_t *state, const governorInputs_t *inputs, float dt)
+{
+    const governorSettings_t *settings = &state->settings;
+    float throttle = inputs->throttle;
+
+    state->headspeed = inputs->headspeed;
+    state->spoolEndTimer = MIN(state->spoolEndTimer + dt, GOV_SPOOL_LOCK_TIME);
+
+    // Some logic to help us come back from a stage 1 failsafe / glitch / RPM loss / accidental throttle hold quickly
+    // Lock in our spooledUp state for a few seconds after throttle = 0 when we were just spooledUp on the last pass through
+    // Also gives us a few second window if we lose headspeed signal... in that case we'll fall back to the commanded throttle value
+    if (state->spooledUp && (throttle == 0.0f || inputs->headspeed < GOV_SPOOLED_MIN_HEADSPEED) && state->spoolEndTimer >= GOV_SPOOL_LOCK_TIME) {
+        state->spoolEndTimer = 0;
+    }
+
+    governorUpdateVbatCompensation(state, inputs, dt);
+
+    governorUpdateSetpoint(state, inputs, dt);
+
+    throttle = governorUpdateSpoolup(state, inputs, throttle, dt);
+
+    // Feedforward
+    //   Collective: reasonable value would be 0.15 throttle addition for 12-degree collective throw
+    //   Cyclic:     additional torque is required when adding cyclic pitch, just like collective (although less)
+    state->collectiveFF = settings->collectiveKf * inputs->collective;
+    state->collectivePulseFF = settings->collectivePulseKf * inputs->collectiveHPF;
+    state->cyclicFF = settings->cyclicKf * inputs->swashRing;
+
+    if (state->spooledUp && state->setpointLimited) {
+        throttle = governorUpdateController(state, inputs, throttle, dt);
+    }
+
+    state->throttle = throttle;
+
+    return throttle;
+}
+
+static uint8_t governorGetStatusFlags(const governorState_t *state)
+{
+    uint8_t flags = 0;
+
+    if (state->spooledUp) {
+        flags |= GOV_STATUS_SPOOLED_UP;
+    }
+    if (state->bailout) {
+        flags |= GOV_STATUS_BAILOUT;
+    }
+    if (state->loadMapValid) {
+        flags |= GOV_STATUS_LOAD_MAP;
+    }
+    if (state->spooledUp && state->setpointLimited) {
+        flags |= GOV_STATUS_ACTIVE;
+    }
+
+    return flags;
+}
+
+static uint16_t governorScaleUnsigned(float value)
+{
+    return lrintf(constrainf(value, 0, UINT16_MAX));
+}
+
+static int16_t governorScaleSigned(float value)
+{
+    return lrintf(constrainf(value * 1000.0f, INT16_MIN, INT16_MAX));
+}
+
+void governorGetTelemetry(const governorState_t *state, governorTelemetry_t *telemetry)
+{
+    telemetry->headspeed = governorScaleUnsigned(state->headspeed);
+    telemetry->setpoint = governorScaleUnsigned(state->setpoint);
+    telemetry->setpointLimited = governorScaleUnsigned(state->setpointLimited);
+    telemetry->throttle = governorScaleUnsigned(state->throttle * 1000.0f);
+    telemetry->pidSum = governorScaleSigned(state->pidSum);
+    telemetry->collectiveFF = governorScaleSigned(state->collectiveFF);
+    telemetry->collectivePulseFF = governorScaleSigned(state->collectivePulseFF);
+    telemetry->cyclicFF = governorScaleSigned(state->cyclicFF);
+    telemetry->status = governorGetStatusFlags(state);
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HF3D:  Main motor spool-up and headspeed governor.
+//   The governor holds all of its state in governorState_t and is advanced by governorUpdate() once per PID loop.
+//   All timers are driven from the loop time (dt, in seconds) so the behaviour is independent of the PID loop rate.
+
+// Steady state throttle map, indexed by headspeed setpoint and collective
+//   Learned in flight and used as the primary throttle estimate instead of the base throttle when available
+#define GOV_LOAD_MAP_HEADSPEED_POINTS   6       // 50% .. 100% of max headspeed in 10% steps
+#define GOV_LOAD_MAP_COLLECTIVE_POINTS  11      // 0% .. 100% collective stick in 10% steps
+#define GOV_LOAD_MAP_SCALE              200.0f  // stored throttle in 0.5% steps, 0 = not learned
+#define GOV_LOAD_MAP_THROTTLE_MAX       200     // stored value of 100% throttle
+
+typedef enum {
+    GOV_LOAD_MAP_OFF = 0,
+    GOV_LOAD_MAP_ON,
+    GOV_LOAD_MAP_LEARN,
+} governorLoadMapMode_e;
+
+// Compact governor status, shared by the blackbox, MSP and telemetry
+typedef enum {
+    GOV_STATUS_SPOOLED_UP   = (1 << 0),
+    GOV_STATUS_BAILOUT      = (1 << 1),
+    GOV_STATUS_LOAD_MAP     = (1 << 2),
+    GOV_STATUS_ACTIVE       = (1 << 3),     // setpoint is being tracked by the PID controller
+} governorStatusFlags_e;
+
+typedef struct governorLoadMap_s {
+    uint8_t mode;
+    uint8_t throttle[GOV_LOAD_MAP_HEADSPEED_POINTS][GOV_LOAD_MAP_COLLECTIVE_POINTS];
+} governorLoadMap_t;
+
+// Gains and limits, already scaled from the user settings
+typedef struct governorSettings_s {
+    float maxHeadspeed;         // rpm at 100% throttle, 0 disables the governor
+    float rampRate;             // throttle fraction per second while spooling up (1 / spoolup_time)
+    float Kp;                   // throttle fraction per fraction of maxHeadspeed error
+    float Ki;                   // throttle fraction per second per fraction of maxHeadspeed error
+    float cyclicKf;             // throttle fraction per swash ring fraction
+    float collectiveKf;         // throttle fraction per collective stick percent
+    float collectivePulseKf;    // throttle fraction per high-passed collective stick percent
+    float baseThrottleCutoff;   // Hz, adaptation rate of the base (fallback) throttle
+    uint8_t loadMapMode;        // governorLoadMapMode_e
+    float vbatCellVoltage;      // V, reference cell voltage for the feedforward voltage compensation, 0 disables it
+    float bailoutRampRate;      // fraction of maxHeadspeed per second during an autorotation bailout, 0 disables bailouts
+    float bailoutMinHeadspeed;  // fraction of the setpoint, headspeed above this when throttle returns starts a bailout
+} governorSettings_t;
+
+// Per-loop inputs
+typedef struct governorInputs_s {
+    float throttle;             // requested throttle 0..1
+    float headspeed;            // measured main rotor rpm, 0 if not available
+    float collective;           // collective stick percent
+    float collectiveHPF;        // high-passed collective stick percent
+    float swashRing;            // combined cyclic deflection 0..1
+    float voltage;              // latest battery voltage (V), 0 if not available
+    uint8_t cellCount;
+    bool autorotation;          // autorotation mode, throttle returning always starts a bailout
+    bool armed;
+} governorInputs_t;
+
+typedef struct governorState_s {
+    governorSettings_t settings;
+
+    bool spooledUp;
+    float spoolEndTimer;        // seconds since the spool-up was last locked in at low throttle / headspeed
+    float lastSpoolThrottle;
+
+    float headspeed;            // headspeed input of the last update
+    float setpoint;             // requested headspeed
+    float setpointLimited;      // rate limited headspeed setpoint
+
+    bool bailout;               // fast recovery to the setpoint after an autorotation
+    float bailoutTimer;         // seconds since the bailout started
+    float bailoutTime;          // duration of the last bailout
+    float idleTimer;            // seconds since the governor was last active (throttle cut)
+
+    float baseThrottle;         // slowly adapted throttle, used as fallback if headspeed is lost
+    float loadMap[GOV_LOAD_MAP_HEADSPEED_POINTS][GOV_LOAD_MAP_COLLECTIVE_POINTS];
+    bool loadMapChanged;
+    bool loadMapValid;          // load map was used for the throttle estimate on the last update
+    float I;
+    float pidSum;
+    float collectiveFF;
+    float collectivePulseFF;
+    float cyclicFF;
+
+    float vbatFiltered;
+    float vbatCompensation;     // feedforward gain for the battery voltage sag, 1.0 = no compensation
+
+    float throttle;             // output throttle 0..1
+} governorState_t;
+
+void governorInit(governorState_t *state, const governorSettings_t *settings);
+void governorReset(governorState_t *state);
+float governorUpdate(governorState_t *state, const governorInputs_t *inputs, float dt);
+
+// Integer snapshot of the governor state, shared by the blackbox, MSP and telemetry
+typedef struct governorTelemetry_s {
+    uint16_t headspeed;         // rpm
+    uint16_t setpoint;          // rpm
+    uint16_t setpointLimited;   // rpm
+    uint16_t throttle;          // output throttle * 1000
+    int16_t pidSum;             // * 1000
+    int16_t collectiveFF;       // * 1000
+    int16_t collectivePulseFF;  // * 1000
+    int16_t cyclicFF;           // * 1000
+    uint8_t status;             // governorStatusFlags_e
+} governorTelemetry_t;
+
+void governorGetTelemetry(const governorState_t *state, governorTelemetry_t *telemetry);
+
+void governorLoadMapLoad(governorState_t *state, const governorLoadMap_t *map);
+bool governorLoadMapStore(governorState_t *state, governorLoadMap_t *map);
@@ -0,0 +1,114 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LOOP_PROFILE
+
+#include "common/maths.h"
+
+#include "flight/loop_profile.h"
+
+const char * const loopProfileStageNames[LOOP_PROFILE_STAGE_COUNT] = {
+    "GYRO", "FILTER", "RC", "PID", "MIXER", "SERVO", "MOTOR", "SUBPROC", "TOTAL"
+};
+
+static loopProfileStats_t loopProfileStats[LOOP_PROFILE_STAGE_COUNT];
+static uint32_t loopProfileCyclesPerMicro = 1;
+static bool loopProfileActive;
+
+void loopProfileInit(uint32_t cyclesPerMicro)
+{
+    loopProfileCyclesPerMicro = MAX(cyclesPerMicro, 1U);
+    loopProfileActive = false;
+    loopProfileReset();
+}
+
+void loopProfileReset(void)
+{
+    memset(loopProfileStats, 0, sizeof(loopProfileStats));
+    for (int i = 0; i < LOOP_PROFILE_STAGE_COUNT; i++) {
+        loopProfileStats[i].min = UINT32_MAX;
+    }
+}
+
+void loopProfileStart(void)
+{
+    loopProfileActive = true;
+}
+
+void loopProfileStop(void)
+{
+    loopProfileActive = false;
+}
+
+bool loopProfileIsActive(void)
+{
+    return loopProfileActive;
+}
+
+uint32_t loopProfileGetCyclesPerMicro(void)
+{
+    return loopProfileCyclesPerMicro;
+}
+
+void loopProfileRecord(loopProfileStage_e stage, uint32_t cycles)
+{
+    if (!loopProfileActive) {
+        return;
+    }
+
+    loopProfileStats_t *stats = &loopProfileStats[stage];
+
+    stats->count++;
+    stats->sum += cycles;
+    if (cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+
+    // Bucket n > 0 holds [2^(n-1), 2^n) us, the last one everything above
+    const uint32_t micros = cycles / loopProfileCyclesPerMicro;
+    const unsigned bucket = micros ? MIN(32U - __builtin_clz(micros), LOOP_PROFILE_BUCKETS - 1U) : 0;
+
+    stats->histogram[bucket]++;
+}
+
+const loopProfileStats_t *loopProfileGetStats(loopProfileStage_e stage)
+{
+    return &loopProfileStats[stage];
+}
+
+uint32_t loopProfileGetAverage(loopProfileStage_e stage)
+{
+    const loopProfileStats_t *stats = &loopProfileStats[stage];
+
+    return stats->count ? stats->sum / stats->count : 0;
+}
+
+#endif // USE_LOOP_PROFILE
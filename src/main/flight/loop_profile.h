@@ -0,0 +1,74 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/system.h"
+
+// HF3D:  PID loop profiler.
+//   Cycle counts of every stage from the gyro to the motors, kept as min/avg/max and a histogram per stage.
+//   Recording is started and stopped from the CLI or MSP, and costs a counter read per stage while stopped.
+
+#define LOOP_PROFILE_BUCKETS    10          // <1us, 1-2us, 2-4us ... 128-256us, >=256us
+
+typedef enum {
+    LOOP_PROFILE_GYRO = 0,                  // gyro read and scaling
+    LOOP_PROFILE_FILTER,                    // gyro filters and dynamic notch analysis
+    LOOP_PROFILE_RC,                        // rc command processing
+    LOOP_PROFILE_PID,                       // pid controller
+    LOOP_PROFILE_MIXER,                     // mixer
+    LOOP_PROFILE_SERVO,                     // servo outputs
+    LOOP_PROFILE_MOTOR,                     // motor outputs
+    LOOP_PROFILE_SUBPROC,                   // mag hold and blackbox
+    LOOP_PROFILE_TOTAL,                     // whole loop, gyro only loops included
+    LOOP_PROFILE_STAGE_COUNT
+} loopProfileStage_e;
+
+typedef struct loopProfileStats_s {
+    uint32_t count;
+    uint32_t min;                           // cycles
+    uint32_t max;                           // cycles
+    uint64_t sum;                           // cycles
+    uint32_t histogram[LOOP_PROFILE_BUCKETS];
+} loopProfileStats_t;
+
+extern const char * const loopProfileStageNames[LOOP_PROFILE_STAGE_COUNT];
+
+void loopProfileInit(uint32_t cyclesPerMicro);
+void loopProfileReset(void);
+void loopProfileStart(void);
+void loopProfileStop(void);
+bool loopProfileIsActive(void);
+uint32_t loopProfileGetCyclesPerMicro(void);
+void loopProfileRecord(loopProfileStage_e stage, uint32_t cycles);
+const loopProfileStats_t *loopProfileGetStats(loopProfileStage_e stage);
+uint32_t loopProfileGetAverage(loopProfileStage_e stage);
+
+#ifdef USE_LOOP_PROFILE
+#define LOOP_PROFILE_BEGIN(start)           const uint32_t start = getCycleCounter()
+#define LOOP_PROFILE_END(stage, start)      loopProfileRecord(stage, getCycleCounter() - (start))
+#else
+#define LOOP_PROFILE_BEGIN(start)           do {} while (0)
+#define LOOP_PROFILE_END(stage, start)      do {} while (0)
+#endif
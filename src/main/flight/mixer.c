@@ -25,6 +25,9 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+#include "blackbox/blackbox_fielddefs.h"
+
 #include "build/build_config.h"
 #include "build/debug.h"
 
@@ -50,12 +53,15 @@
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 #include "fc/core.h"
+#include "fc/dispatch.h"
 #include "fc/rc.h"
 
 #include "flight/failsafe.h"
 #include "flight/imu.h"
+#include "flight/governor.h"
 #include "flight/gps_rescue.h"
 #include "flight/mixer.h"
+#include "flight/mixer_plan.h"
 #include "flight/mixer_tricopter.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
@@ -66,7 +72,7 @@
 #include "sensors/battery.h"
 #include "sensors/gyro.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 5);
 
 #define DYN_LPF_THROTTLE_STEPS           100
 #define DYN_LPF_THROTTLE_UPDATE_DELAY_US 5000 // minimum of 5ms between updates
@@ -76,18 +82,29 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .yaw_motors_reversed = false,
     .crashflip_motor_percent = 0,
     .gov_max_headspeed = 7000,
-    .gov_gear_ratio = 100,
     .gov_p_gain = 0,
     .gov_i_gain = 0,
     .gov_cyclic_ff_gain = 0,
     .gov_collective_ff_gain = 0,
     .gov_collective_ff_impulse_gain = 0,
     .gov_collective_ff_impulse_freq = 100,
-    .spoolup_time = 5
+    .spoolup_time = 5,
+    .gov_vbat_comp = false,
+    .tail_precomp_throttle_gain = 0,
+    .tail_precomp_collective_gain = 0,
+    .tail_precomp_accel_gain = 0,
+    .gov_bailout_time = 7,
+    .gov_bailout_min_headspeed = 50,
+    .main_rotor_dir = ROTOR_DIR_CW,
 );
 
 PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, customMotorMixer, PG_MOTOR_MIXER, 0);
 
+// HF3D:  Governor load map, empty by default
+PG_REGISTER(governorLoadMap_t, governorLoadMap, PG_GOVERNOR_LOAD_MAP, 0);
+
+#define GOV_LOAD_MAP_SAVE_DELAY_US 500000 // Let disarming complete and save the load map after this time
+
 #define PWM_RANGE_MID 1500
 
 static FAST_RAM_ZERO_INIT uint8_t motorCount;
@@ -293,6 +310,11 @@ FAST_RAM_ZERO_INIT float motorOutputHigh, motorOutputLow;
 
 static FAST_RAM_ZERO_INIT float disarmMotorOutput, deadbandMotor3dHigh, deadbandMotor3dLow;
 static FAST_RAM_ZERO_INIT float rcCommandThrottleRange;
+
+// HF3D:  Motor output limits, rebuilt only when the endpoints or failsafe change
+static FAST_RAM_ZERO_INIT mixerPlan_t mixerPlan;
+static FAST_RAM_ZERO_INIT bool mixerPlanValid;
+
 #ifdef USE_DYN_IDLE
 static FAST_RAM_ZERO_INIT float idleMaxIncrease;
 static FAST_RAM_ZERO_INIT float idleThrottleOffset;
@@ -300,17 +322,26 @@ static FAST_RAM_ZERO_INIT float idleMinMotorRps;
 static FAST_RAM_ZERO_INIT float idleP;
 #endif
 // Governor & Spool-up
-static FAST_RAM_ZERO_INIT float rampRate;  // = 0.0002f     // Used for spool-up logic.  Default is 5 seconds at 1kHz.
-static FAST_RAM_ZERO_INIT uint16_t govMaxHeadspeed;
+static FAST_RAM_ZERO_INIT governorState_t governor;
 static FAST_RAM_ZERO_INIT float govGearRatio;
-static FAST_RAM_ZERO_INIT float govKp;
-static FAST_RAM_ZERO_INIT float govKi;
-static FAST_RAM_ZERO_INIT float govCycKf;
-static FAST_RAM_ZERO_INIT float govColKf;
-static FAST_RAM_ZERO_INIT float govColPulseKf;
-static FAST_RAM_ZERO_INIT float govColPulseFc;
-static FAST_RAM_ZERO_INIT float govColPulseFilterGain;   
-static FAST_RAM_ZERO_INIT float govBaseThrottleFilterGain;   // Used for governor failure
+static FAST_RAM_ZERO_INIT float govUpdateTime;          // seconds since the last governor update
+static FAST_RAM_ZERO_INIT uint32_t govRpmSamples;       // main motor RPM sample count at the last governor update
+static FAST_RAM_ZERO_INIT bool govArmed;
+static FAST_RAM_ZERO_INIT float govThrottle;            // governor output, held between updates
+static FAST_RAM_ZERO_INIT bool govBailout;
+
+// Tail motor torque precompensation
+static FAST_RAM_ZERO_INIT float tailPrecompThrottleGain;
+static FAST_RAM_ZERO_INIT float tailPrecompCollectiveGain;
+static FAST_RAM_ZERO_INIT float tailPrecompAccelGain;
+static FAST_RAM_ZERO_INIT float tailPrecompHeadspeed;
+static FAST_RAM_ZERO_INIT float tailPrecompHeadspeedRate;   // fraction of gov_max_headspeed per second, filtered
+static FAST_RAM_ZERO_INIT float tailPrecomp;                // motor driven tail feedforward 0..1
+
+#define TAIL_PRECOMP_ACCEL_CUTOFF   5.0f    // Hz, headspeed change rate filter
+
+// HF3D:  The governor runs on fresh headspeed data, but at least this often (no RPM source, or RPM unchanged)
+#define GOV_MAX_UPDATE_INTERVAL     0.02f
 
 uint8_t getMotorCount(void)
 {
@@ -360,6 +391,8 @@ void initEscEndpoints(void)
     motorInitEndpoints(motorOutputLimit, &motorOutputLow, &motorOutputHigh, &disarmMotorOutput, &deadbandMotor3dHigh, &deadbandMotor3dLow);
 
     rcCommandThrottleRange = PWM_RANGE_MAX - PWM_RANGE_MIN;
+
+    mixerPlanValid = false;
 }
 
 // called from init at FC startup.
@@ -381,38 +414,45 @@ void mixerInit(mixerMode_e mixerMode)
 #endif
     
     // Initialize governor settings
-    // Determine rampRate that will increase throttle on each loop to go from 0% throttle to 100% throttle in rampTime seconds
-    // We're stealing the mmix throttle% section on motor 0 to be our ramp-up time instead. 
-    // rampTime is how many seconds to go from 0rpm to 100% pwm output
-    // mmix 1 throttle = 5.0 ==> 5 seconds to spool up from 0% to 100% throttle
-    //   activemixer.throttle = floating point value between 0-1.00
-    // targetPidLooptime is in units of microseconds...  (8kHz => targetPidLooptime = 125)
-    //   5 seconds = @ 8kHz ==> 40,000 loops for full spool-up from 0% to 100%
-    //rampRate = targetPidLooptime / (currentMixer[0].throttle * 1e6f);    
-    //rampRate = 0.000025f;    // HF3D TODO:  Figure out why the line of code above doesn't work.
-        // targetPidLooptime should be (uint32_t) 125
-        // currentMixer[0].throttle should be  (float) 5.0
-        // 1e6f should be 1000000
-        // SO WHY DOESN'T IT WORK?????  Result should be 0.000025f, but instead the stupid heli just won't spool up.
-    
-    rampRate = 0.000025f;
-    //rampRate = pidGetDT() / (float)mixerConfig()->spoolup_time;
-    // HF3D TODO:  lol... rampRate STILL not working.  Wtf.
-    govMaxHeadspeed = mixerConfig()->gov_max_headspeed;     // stays uint16_t
-    govGearRatio = (float)mixerConfig()->gov_gear_ratio / 100.0f;
-    govKp = (float)mixerConfig()->gov_p_gain / 10.0f;
-    govKi = (float)mixerConfig()->gov_i_gain / 10.0f;
-    govCycKf = (float)mixerConfig()->gov_cyclic_ff_gain / 100.0f;
-    govColKf = (float)mixerConfig()->gov_collective_ff_gain / 10000.0f;
-    govColPulseKf = (float)mixerConfig()->gov_collective_ff_impulse_gain / 10000.0f;
-    govColPulseFc = (float)mixerConfig()->gov_collective_ff_impulse_freq / 100.0f;     // Setting is frequency in Hz / 100
-    
-    // Setup filter for governor base throttle & Collective Impulse Feedforward
-    // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
-    //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
-    //   k = dT / (RC + dT);                  ==>  k = 0.0000393 for 8kHz
-    govBaseThrottleFilterGain = pidGetDT() / (pidGetDT() + (1 / ( 2 * 3.14159f * 0.05f)));
-    govColPulseFilterGain = pidGetDT() / (pidGetDT() + (1 / ( 2 * 3.14159f * govColPulseFc)));
+    // spoolup_time is how many seconds to go from 0% to 100% throttle output while spooling up
+    const governorSettings_t governorSettings = {
+        .maxHeadspeed = mixerConfig()->gov_max_headspeed,
+        .rampRate = 1.0f / MAX(mixerConfig()->spoolup_time, 1),
+        .Kp = (float)mixerConfig()->gov_p_gain / 10.0f,
+        .Ki = (float)mixerConfig()->gov_i_gain / 10.0f,
+        .cyclicKf = (float)mixerConfig()->gov_cyclic_ff_gain / 100.0f,
+        .collectiveKf = (float)mixerConfig()->gov_collective_ff_gain / 10000.0f,
+        .collectivePulseKf = (float)mixerConfig()->gov_collective_ff_impulse_gain / 10000.0f,
+        .baseThrottleCutoff = 0.05f,
+        .loadMapMode = governorLoadMap()->mode,
+        // Feedforward is compensated relative to a full pack
+        .vbatCellVoltage = mixerConfig()->gov_vbat_comp ? batteryConfig()->vbatfullcellvoltage / 100.0f : 0.0f,
+        .bailoutRampRate = mixerConfig()->gov_bailout_time ? 10.0f / mixerConfig()->gov_bailout_time : 0.0f,
+        .bailoutMinHeadspeed = mixerConfig()->gov_bailout_min_headspeed / 100.0f,
+    };
+    governorInit(&governor, &governorSettings);
+    governorLoadMapLoad(&governor, governorLoadMap());
+    govUpdateTime = 0;
+    govThrottle = 0;
+    govArmed = false;
+    govBailout = false;
+    if (governorLoadMap()->mode == GOV_LOAD_MAP_LEARN) {
+        // Learned load map is saved after disarming
+        dispatchEnable();
+    }
+
+    govGearRatio = (float)motorConfig()->motorGearRatio[0] / 100.0f;
+
+    // Motor driven tail torque precompensation
+    //   Throttle gain is tail throttle per main motor throttle * 1000
+    //   Collective gain is tail throttle per collective stick percent * 10000
+    //   Accel gain is tail throttle per (fraction of gov_max_headspeed per second) * 1000
+    tailPrecompThrottleGain = mixerConfig()->tail_precomp_throttle_gain / 1000.0f;
+    tailPrecompCollectiveGain = mixerConfig()->tail_precomp_collective_gain / 10000.0f;
+    tailPrecompAccelGain = mixerConfig()->tail_precomp_accel_gain / 1000.0f;
+    tailPrecompHeadspeed = 0;
+    tailPrecompHeadspeedRate = 0;
+    tailPrecomp = 0;
 }
 
 
@@ -506,6 +546,7 @@ static FAST_RAM_ZERO_INIT float throttle = 0;
 static FAST_RAM_ZERO_INIT float mixerThrottle = 0;
 static FAST_RAM_ZERO_INIT float motorOutputMin;
 static FAST_RAM_ZERO_INIT float motorRangeMin;
+static FAST_RAM_ZERO_INIT float motorRangeMinBase;     // HF3D:  motorRangeMin without the dynamic idle increase
 static FAST_RAM_ZERO_INIT float motorRangeMax;
 static FAST_RAM_ZERO_INIT float motorOutputRange;
 static FAST_RAM_ZERO_INIT int8_t motorOutputMixSign;
@@ -622,6 +663,7 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
             // keep iterm zero for 250ms after motor reversal
             pidResetIterm();
         }
+        motorRangeMinBase = motorRangeMin;
     } else {
         throttle = rcCommand[THROTTLE] - PWM_RANGE_MIN + throttleAngleCorrection;
 #ifdef USE_DYN_IDLE
@@ -647,6 +689,7 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
         currentThrottleInputRange = rcCommandThrottleRange;
         // motorOutputLow includes the increase from digitalIdleOffset!
         // if DynIdle not used:  motorRangeMinIncrease = 0
+        motorRangeMinBase = motorOutputLow;
         motorRangeMin = motorOutputLow + motorRangeMinIncrease * (motorOutputHigh - motorOutputLow);
         motorRangeMax = motorOutputHigh;
         motorOutputMin = motorRangeMin;
@@ -664,20 +707,49 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
     //    Essentially just converting throttle from a value in microseconds to a float between 0.0 and 1.0
 }
 
-// HF3D TODO:  Move governor logic to separate source file
-static FAST_RAM_ZERO_INIT float lastSpoolThrottle = 0;
-static FAST_RAM_ZERO_INIT uint8_t spooledUp = 0;
-static FAST_RAM_ZERO_INIT float governorSetpoint;
-static FAST_RAM_ZERO_INIT float governorSetpointLimited = 0.0f;
-static FAST_RAM_ZERO_INIT float govBaseThrottle;
-static FAST_RAM_ZERO_INIT float govPidSum = 0;
-static FAST_RAM_ZERO_INIT float govI = 0;
-static FAST_RAM_ZERO_INIT float govCollectiveFF = 0;
-static FAST_RAM_ZERO_INIT float govCollectivePulseFF = 0;
-static FAST_RAM_ZERO_INIT timeMs_t lastSpoolEndTime = 0;
+static void blackboxLogGovernorBailoutEvent(float headspeed)
+{
+#ifndef USE_BLACKBOX
+    UNUSED(headspeed);
+#else
+    if (blackboxConfig()->device) {
+        flightLogEvent_govBailout_t eventData;
+        eventData.active = governor.bailout;
+        eventData.headspeed = constrain(lrintf(headspeed), 0, UINT16_MAX);
+        eventData.time = governor.bailout ? 0 : constrain(lrintf(governor.bailoutTime * 1000), 0, UINT16_MAX);
+        blackboxLogEvent(FLIGHT_LOG_EVENT_GOV_BAILOUT, (flightLogEventData_t*)&eventData);
+    }
+#endif
+}
+
+// HF3D:  The plan is keyed on the range without the dynamic idle increase, which moves every loop under dynamic idle.
+//   The increase is applied to the tail motor output in applyMixToMotors() instead.
+static void mixerUpdatePlan(void)
+{
+    const bool failsafe = failsafeIsActive();
+
+    if (!mixerPlanValid || failsafe != mixerPlan.inputs.failsafe ||
+        motorRangeMinBase != mixerPlan.inputs.rangeMin || motorRangeMax != mixerPlan.inputs.rangeMax) {
+        const mixerPlanInputs_t inputs = {
+#ifdef USE_DSHOT
+            .dshot = isMotorProtocolDshot(),
+            .dshotMinOutput = DSHOT_MIN_THROTTLE,
+#endif
+            .failsafe = failsafe,
+            .disarmOutput = disarmMotorOutput,
+            .outputHigh = motorOutputHigh,
+            .rangeMin = motorRangeMinBase,
+            .rangeMax = motorRangeMax,
+        };
+        mixerPlanBuild(&mixerPlan, &inputs);
+        mixerPlanValid = true;
+    }
+}
 
 static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t *activeMixer)
 {
+    mixerUpdatePlan();
+
     // HF3D: Re-wrote this section for main and optional tail motor use.  No longer valid for multirotors.
     //   Main motor must be motor[0] (Motor 0)
     //     * Use resource assignment to reassign output pin on board for main motor ESC to Motor 1
@@ -691,264 +763,65 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t
     // Handle MAIN motor (motor[0]) throttle output & spool-up
     if (motorCount > 0) {
 
-        // Calculate headspeed
+        // HF3D:  Headspeed only changes when a new RPM sample arrives (DShot telemetry, or ~100Hz ESC sensor),
+        //   so the governor runs as a decimated stage on fresh RPM data and its output is held in between.
+        //   The governor is driven by the real time between updates, so its gains don't depend on pid_process_denom.
+        //   Arming changes and throttle cut are always handled immediately.
 #ifdef USE_RPM_FILTER
-        float mainMotorRPM = rpmGetFilteredMotorRPM(0);    // Get filtered main motor rpm from rpm_filter's source
+        const uint32_t rpmSamples = rpmGetMotorSampleCount(0);
 #else
-        float mainMotorRPM = 0.0f;
-#endif        
-        float headspeed = mainMotorRPM / govGearRatio;
-        
-        // Some logic to help us come back from a stage 1 failsafe / glitch / RPM loss / accidental throttle hold quickly
-        // We're going to use this time to lock in our spooledUp state for a few seconds after throttle = 0 when we were just spooledUp on the last pass through
-        // Also gives us a few second window if we lose headspeed signal... in that case we'll fall back to the commanded throttle value
-        if (spooledUp && (throttle == 0.0f || headspeed < 1000.0f) && cmp32(millis(), lastSpoolEndTime) > 5500) {
-            // Time check above must be set just a little longer than any of the lastSpoolEndTime checks below.
-            // HF3D TODO:  Maybe change the throttle check above to something >0.0f or add some more logic to allow for a faster ramp for autorotation bailout of some kind?
-            lastSpoolEndTime = millis();
-        }
-                
-        // Determine governor setpoint (use governor if throttle setting is >50%)
-        // HF3D TODO:  Check !isDshotMotorTelemetryActive(i)
-        if (throttle > 0.50 && govMaxHeadspeed > 0) {
-
-            // Set the user requested governor headspeed setting
-            governorSetpoint = throttle * (float)govMaxHeadspeed;
-            
-            // If we don't have a non-zero rate limited setpoint yet, set it to the headspeed
-            if (governorSetpointLimited <= 0) {
-                governorSetpointLimited = headspeed;
-            }
-            
-            // Increment or decrement the rate limited governor setpoint if needed
-            // If ramp is set to 5s then this will allow 20% change in 1 second, or 10% headspeed in 0.5 seconds.
-            float govRampRate = rampRate * (float)govMaxHeadspeed;
-            // Check to see if we've been spooledUp recently .  If so, increase our govRampRate greatly to help recover from temporary loss of throttle signal.
-            // HF3D TODO:  If someone immediately plugged in their heli, armed, and took off throttle hold we could accidentally hit this fast governor ramp.  That would be crazy... but possible I guess?
-            if ( spooledUp && cmp32(millis(), lastSpoolEndTime) < 5000 ) {
-                govRampRate *= 7.0f;
-            }
-            if ((governorSetpoint - governorSetpointLimited) > govRampRate) {
-                // Setpoint is higher than the rate limited setpoint, so increment limited setpoint higher
-                governorSetpointLimited = constrainf(governorSetpointLimited + govRampRate, governorSetpointLimited, governorSetpoint);                
-            
-            } else if ((governorSetpointLimited - governorSetpoint) > govRampRate)  {
-                // Setpoint is lower than the rate limited setpoint, so decrement limited setpoint lower
-                governorSetpointLimited = constrainf(governorSetpointLimited - govRampRate, governorSetpoint, governorSetpointLimited);
-            }
-        } else {
-            // Throttle is less than 50%, don't use governor.
-            governorSetpoint = 0;
-            governorSetpointLimited = 0;
-        }
+        const uint32_t rpmSamples = 0;
+#endif
+        const bool armed = ARMING_FLAG(ARMED);
 
-        if (headspeed == 0) {
-            // Disable governor if main motor RPM is not available
-            governorSetpoint = 0;
-            governorSetpointLimited = 0;
-        }
-    
-        //----------------- Spoolup Logic ----------------
-        // MVP:  If Main Motor RPM <1000, then reset spooledUp flag and use spooledUp logic
-        // HF3D TODO:  Add auto-rotation mode that ignores this check, or at least decreases the ramp time significantly.
-        // HF3D TODO:  Clean-up spool-up logic that allows for 2 modes:  Spool on throttle % only (no RPM telemetry), and Spool on Governor (Headspeed)
-        //    May be easier to just have 2 sets of code... 1 for spooling on governor and one for spooling without governor??
-        // HF3D TODO:
-        //  Idea for RPM-based spool-up logic when governor is active...
-        //  Bring throttle up to ~25%.  If no RPM detected, then disarm.
-        //  Once RPM is detected, start tracking PWM vs. RPM.  
-        //  If there becomes a large discrepency between PWM ramp and RPM ramp, then stop ramping PWM until ratio comes back in line.
-        //  This will prevent the "lag" that sometimes occurs where we end up ramping PWM into oblivion and then the ESC "catches up" later on.
-        //  See 4/9/20 log #7
-
-        // Spool-up using governorSetpoint (not the rate limited GovernorSetpoint)
-        // Determine spoolup status
-        if (headspeed < 1000.0f && cmp32(millis(), lastSpoolEndTime) > 3000) {
-            // Require heli to spin up slowly if it's been more than 3 seconds since we last had a headspeed below 1000 rpm
-            spooledUp = 0;
-
-        } else if (!governorSetpoint && throttle <= lastSpoolThrottle) {
-            // Governor is disabled, running on throttle % only.
-            // If user spools up above 1000rpm, then lowers throttle below the last spool target, allow the heli to be considered spooled up
-            spooledUp = 1;
-            lastSpoolThrottle = throttle;        // Allow spool target to reduce with throttle freely even if already spooledUp.
-            // HF3D TODO:  There's a bug with this block....
-            //   If you spool up above 1000 and then come back below that throttle setting (normal mode)
-            //   lastSpoolThrottle will ONLY go down since that's all it's allowed to do here.
-            //   Then when the governor turns on it gets this really low lastSpoolThrottle value (maybe even zero)
-            //      and then throttle drops to zero and the i-term has to wind up the entire amount.
-            
-        } else if (!spooledUp && governorSetpoint && (headspeed > governorSetpoint*0.97)) {
-            // Governor is enabled, running on headspeed
-            // If headspeed is within 3% of governorSetpoint, consider the heli to be spooled up
-            spooledUp = 1;
-            // Set the governor's base throttle % to our last spooled throttle value
-            govBaseThrottle = lastSpoolThrottle;
-            // Jump the rate limited Setpoint up to the setpoint.
-            governorSetpointLimited = governorSetpoint*0.97f;
-        
-        } else if (!spooledUp && governorSetpoint && (lastSpoolThrottle > 0.90f)) {
-            // Governor is enabled, and we've hit 90% throttle trying to get within 97% the requested headspeed.
-            // HF3D TODO:  Flag and alert user in the logs and/or with beep tones after flight that govMaxHeadspeed is set too high.
-            spooledUp = 1;
-            govBaseThrottle = lastSpoolThrottle;
-            governorSetpointLimited = headspeed;
-        }
+        govUpdateTime += pidGetDT();
 
-        // Handle ramping of throttle
-        // HF3D TODO:  Eventually add a "govEnabled" user setting flag.  If the user doesn't have the governor enabled then we need to not use headspeed to perform our spooledUp check.
-        //   Right now we have governor enabled all of of the time, but eventually the code needs to support running with or without an RPM signal (gov or no gov)
-        // Skip spooling logic if no throttle signal or if we're disarmed
-        if ((throttle == 0.0f) || !ARMING_FLAG(ARMED)) {
-            // Don't reset spooledUp flag because we want throttle to respond quickly if user drops throttle in normal mode or re-arms while blades are still spinning > 1000rpm
-            //   spooledUp flag will reset anyway if RPM < 1000
-            lastSpoolThrottle = 0.0f;         // Require re-spooling to start from zero if RPM<1000 and throttle=0 or disarmed
-        
-        // If not spooled up and throttle is higher than our last spooled-up output, spool some more
-        } else if (!governorSetpoint && !spooledUp && (lastSpoolThrottle < throttle)) {
-            // Governor is disabled, running on throttle % only.
-            throttle = lastSpoolThrottle + rampRate;    // rampRate defined in mixerConfigureOutput up above
-            lastSpoolThrottle = throttle;
-
-        // If not spooled up and headspeed is lower than our governorSetpoint, spool some more
-        } else if (governorSetpoint && !spooledUp && (headspeed < governorSetpoint)) {
-            // Governor is enabled, running on headspeed.
-            throttle = lastSpoolThrottle + rampRate;    // rampRate defined in mixerConfigureOutput up above
-            lastSpoolThrottle = throttle;
-        
-        }
-        // --------------- End of Spoolup Logic --------------
-        
-        // --------------- Feedforward Calculations ----------
-        
-        // Quick and dirty collective pitch linear feed-forward for the main motor
-        // Calculate linear feedforward vs. collective stick position (always positive adder)
-        //   Reasonable value would be 0.15 throttle addition for 12-degree collective throw..
-        //   So gains in the 0.0015 - 0.0032 range depending on where max collective pitch is on the heli
-        //   HF3D TODO:  Set this up so works off of a calibrated pitch value for the heli taken during setup
-        govCollectiveFF = govColKf * pidGetCollectiveStickPercent();
-        
-        // Collective pitch impulse feed-forward for the main motor
-        govCollectivePulseFF = govColPulseKf * pidGetCollectiveStickHPF();
-
-        // HF3D TODO:  Add a cyclic stick feedforward to the governor - linear gain should be fine.
-        // Additional torque is required from the motor when adding cyclic pitch, just like collective (although less)
-        // Maybe use this?:  float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1;
-        // It's calculated like this in the pid.c code:
-        //   Calculate absolute value of the percentage of cyclic stick throw (both combined... but swash ring is the real issue).
-		//   float tailCyclicFF = -1.0f * servosGetSwashRingValue() * 100.0f * pidProfile->yawCycKf / 100.0f;
-        //   servosGetSwashRingValue() is a 0-1.0f value that is a fraction of the total cyclic travel allowed (usually 10 degrees)
-        float govCyclicFF = govCycKf * servosGetSwashRingValue();
-        
-        // --------------- End of Feedforward Calculations ---
-
-        // --------------- Governor Logic --------------------
-        if (spooledUp && governorSetpointLimited) {
-                
-            // Calculate error as a percentage of the max headspeed, since 100% throttle should be close to max headspeed
-            // HF3D TODO:  Do we really want the governor to respond the same even if setpoint is only 60% of max?
-            //   100 rpm error on 60% of max would "feel" a lot different than 100 rpm error on 90% of max headspeed.
-            //   But would it really require any torque differences for the same response??  Maybe, since less inertia in head?
-            float govError = (governorSetpointLimited - headspeed) / (float)govMaxHeadspeed;
-            
-            // if gov_p_gain = 10 (govKp = 1), we will get 1% change in throttle for 1% error in headspeed
-            float govP = govKp * govError;
-            // if gov_i_gain = 10 (govKi = 1), we will get 1% change in throttle for 1% error in headspeed after 1 second
-            govI = constrainf(govI + govKi * govError * pidGetDT(), -50.0f, 50.0f);
-            govPidSum = govP + govI;
-            // float govPidSum = govP + govI;
-            
-            // HF3D TODO:  Scale the sums based on the average battery voltage?
-            //  Note:  This should NOT apply to the tail feedforward compensations that go into the PID controller!
-            //         Those compensations are related to the amount of TORQUE only... and this comp would be trying
-            //            to keep torque equal, so those shouldn't have to change.
-            
-            // Generate our new governed throttle signal
-            throttle = govBaseThrottle + govCollectiveFF + govCollectivePulseFF + govCyclicFF + govPidSum;
-            // Reset any wind-up due to excess control signal
-            if (throttle > 1.0f) {
-                // Remove last addition to I-term to prevent further wind-up if it was moving us towards this over-control
-                if (govError > 0.0f) {
-                    govI = govI - govKi * govError * pidGetDT();
-                }
-                throttle = 1.0f;
-           
-            } else if (throttle < 0.0f) {
-                // Remove last addition to I-term to prevent further wind-up if it was moving us towards this over-control
-                // HF3D TODO:  What if I-term was at contraints before we did this?
-                if (govError < 0.0f) {
-                    govI = govI - govKi * govError * pidGetDT();
-                }
-
-                throttle = 0.0f;
+        if (rpmSamples != govRpmSamples || govUpdateTime >= GOV_MAX_UPDATE_INTERVAL || armed != govArmed || throttle <= 0) {
+            // Calculate headspeed
+#ifdef USE_RPM_FILTER
+            const float mainMotorRPM = rpmGetFilteredMotorRPM(0);    // Get filtered main motor rpm from rpm_filter's source
+#else
+            const float mainMotorRPM = 0.0f;
+#endif
+            const float headspeed = mainMotorRPM / govGearRatio;
+
+            const governorInputs_t governorInputs = {
+                .throttle = throttle,
+                .headspeed = headspeed,
+                .collective = pidGetCollectiveStickPercent(),
+                .collectiveHPF = pidGetCollectiveStickHPF(),
+                .swashRing = servosGetSwashRingValue(),
+                .voltage = isBatteryVoltageConfigured() ? getBatteryVoltageLatest() / 100.0f : 0.0f,
+                .cellCount = getBatteryCellCount(),
+                .autorotation = IS_RC_MODE_ACTIVE(BOXAUTOROTATION),
+                .armed = armed,
+            };
+            govThrottle = governorUpdate(&governor, &governorInputs, govUpdateTime);
+
+            if (governor.bailout != govBailout) {
+                govBailout = governor.bailout;
+                blackboxLogGovernorBailoutEvent(headspeed);
             }
 
-            // pidGetdT() = targetPidLooptime * 1e-6f;  // 0.00125 for 8kHz
-            // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
-            //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
-            //   k = dT / (RC + dT);                  ==>  k = 0.0000393
-            // Slowly adapt our govBaseThrottle over time (LPF) as a fallback in case we lose RPM data.
-            // HF3D TODO:  If always flying at high collective pitch, that govCollectiveFF will end up adding into the govBaseThrottle
-            //    This means the base throttle will be ramped way up if then go back towards a lower average pitch... is that a problem?
-            float govBaseThrottleChange = (throttle - govBaseThrottle) * govBaseThrottleFilterGain;
-            govBaseThrottle += govBaseThrottleChange;
-            // Adjust the I-term to account for the base throttle adjustment we just made
-            // HF3D TODO:  What if I-term was at contraints before we did this?
-            govI -= govBaseThrottleChange;
-        
-            // Set lastSpoolThrottle to track the governor throttle signal when the governor is active
-            lastSpoolThrottle = throttle;
+            // Headspeed change rate for the tail torque precompensation (spooling up the rotor takes extra torque)
+            if (tailPrecompAccelGain > 0 && governor.settings.maxHeadspeed > 0 && govUpdateTime > 0) {
+                const float headspeedRate = (headspeed - tailPrecompHeadspeed) / (governor.settings.maxHeadspeed * govUpdateTime);
+                const float RC = 1.0f / (2.0f * M_PIf * TAIL_PRECOMP_ACCEL_CUTOFF);
+                tailPrecompHeadspeedRate += (headspeedRate - tailPrecompHeadspeedRate) * govUpdateTime / (RC + govUpdateTime);
+                tailPrecompHeadspeed = headspeed;
+            }
 
-            DEBUG_SET(DEBUG_SMARTAUDIO, 2, govPidSum*1000.0f);             // Max pidsum will be around 1, so increase by 1000x
+            govUpdateTime = 0;
+            govRpmSamples = rpmSamples;
+            govArmed = armed;
         }
-        
-        mainMotorThrottle = throttle;        // Used by the tail motor code to set the base tail motor output as a fraction of main motor output
-
-        // HF3D TODO:  Rename debug_smartaudio entry eventually
-        DEBUG_SET(DEBUG_SMARTAUDIO, 0, governorSetpointLimited);
-        DEBUG_SET(DEBUG_SMARTAUDIO, 1, headspeed);
-        //DEBUG_SET(DEBUG_SMARTAUDIO, 2, govPidSum*1000.0f);             // Max pidsum will be around 1, so increase by 1000x
-#ifdef USE_RPM_FILTER
-        DEBUG_SET(DEBUG_SMARTAUDIO, 3, rpmGetFilteredMotorRPM(1));  // Tail motor RPM
-#endif
+        throttle = govThrottle;
 
-        // HF3D:  Modified original code to ignore any idle offset value when scaling main motor output -- we should always ensure that the main motor will be 100% stopped at zero throttle.
-        //   motorOutputMin = motorRangeMin = motorOutputLow = DSHOT_MIN_THROTTLE
-        float motorOutput;
-#ifdef USE_DSHOT
-        if (isMotorProtocolDshot()) {
-            motorOutput = DSHOT_MIN_THROTTLE + (motorOutputHigh - DSHOT_MIN_THROTTLE) * throttle;
-        } else
-#endif
-        {
-            // For analog PWM, use disarmMotorOutput for safety
-            // if min_command = 1000 and max_command = 1940  =>  motorOutput = 1000 + (940)*throttle
-            motorOutput = disarmMotorOutput + (motorOutputHigh - disarmMotorOutput) * throttle;
-        }
+        mainMotorThrottle = throttle;        // Used by the tail motor code to set the base tail motor output as a fraction of main motor output
 
-        if (failsafeIsActive()) {
-#ifdef USE_DSHOT
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < DSHOT_MIN_THROTTLE) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-#endif
-            motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);        // motorRangeMax = motorOutputHigh   for uni-directional motor rotation
-        } else {
-            // HF3D:  Prevent main motor from running or twitching when dshot_idle_value is used.
-#ifdef USE_DSHOT
-            if (isMotorProtocolDshot()) {
-                // Use DSHOT_MIN_THROTTLE to allow the main motor to come to a complete stop at any time
-                // Also prevents the main motor from "twitching" if the dshot_idle_value is setup to prevent the tail motor from stopping
-                motorOutput = constrain(motorOutput, DSHOT_MIN_THROTTLE, motorRangeMax);
-            } else
-#endif
-            {
-                // HF3D:  For analog PWM control of main motor ESC, motorRangeMin includes motorConfig()->minthrottle parameter.  
-                //   This is NOT good.  Any idle minthrottle setting will cause the ESC to twitch when at zero throttle.  Set to disarmMotorOutput for now just to be safe.
-                motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);
-            }
-        }
-        motor[0] = motorOutput;
+        // HF3D:  The main motor ignores any idle offset, so that it will be 100% stopped at zero throttle.
+        //   See mixerPlanBuild() for the output range and failsafe limits.
+        motor[0] = mixerPlanMainMotor(&mixerPlan, throttle);
         
     } // end of Main Motor handling (motor[0])
 
@@ -961,10 +834,23 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t
         
         //  For a tail motor.. we don't really want it spinning like crazy from base thrust anytime we're armed,
         //   so tone the motorOutput down a bit using the mainMotorThrottle as a gain until we're at half our throttle setting or something.
-        if (!spooledUp) {
+        if (!governor.spooledUp) {
             // Track the main motor output while spooling up so that we don't have our tail motor going nuts at zero throttle
             motorOutput = mainMotorThrottle * motorOutput;
         }
+
+        // HF3D:  Main rotor torque precompensation
+        //   Main rotor torque follows the main motor throttle, the collective pitch and the rotor acceleration.
+        //   Feed it forward to the tail motor so that the yaw PID doesn't have to wait for the yaw error to build up.
+        //   A fixed pitch motor driven tail can't make negative thrust, so only add it while the main motor is running.
+        if (mainMotorThrottle > 0) {
+            tailPrecomp = constrainf(tailPrecompThrottleGain * mainMotorThrottle +
+                                     tailPrecompCollectiveGain * pidGetCollectiveStickPercent() +
+                                     tailPrecompAccelGain * tailPrecompHeadspeedRate, 0.0f, 1.0f);
+        } else {
+            tailPrecomp = 0;
+        }
+        motorOutput += tailPrecomp;
         
         // Linearize the tail motor thrust  (pidApplyThrustLinearization)
 #ifdef USE_THRUST_LINEARIZATION
@@ -986,37 +872,14 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t
         // Note that motorOutput here can still be < 0 if the motorMix is sufficiently negative.  Idle offset will be taken into account again down below.
         motorOutput = motorOutputMin + motorOutputRange * motorOutput;
 
-        if (failsafeIsActive()) {
-#ifdef USE_DSHOT
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < motorRangeMin) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-#endif
-            motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);
-        } else {
-            // HF3D:  Only use dshot_idle_value when main motor is spinning.
-#ifdef USE_DSHOT
-            if (isMotorProtocolDshot()) {
-                if (mainMotorThrottle > 0.0) {
-                    // Use dshot_idle_value to prevent tail from stopping when main motor is running
-                    // motorRangeMin = DSHOT_MIN_THROTTLE + ((DSHOT_MAX_THROTTLE - DSHOT_MIN_THROTTLE) / 100.0f) * CONVERT_PARAMETER_TO_PERCENT(motorConfig()->digitalIdleOffsetValue);
-                    motorOutput = constrain(motorOutput, motorRangeMin, motorRangeMax);
-                } else {
-                    // Use DSHOT_MIN_THROTTLE to allow the tail to come to a complete stop when main motor isn't running
-                    motorOutput = constrain(motorOutput, DSHOT_MIN_THROTTLE, motorRangeMax);
-                }
-            } else
-#endif
-            {
-                // Handle analog PWM tail motor ESC.  Not sure why anyone would do that... but, okay.
-                if (mainMotorThrottle > 0.0) {
-                    // Use minThrottle value to prevent tail from stopping when main motor is running
-                    motorOutput = constrain(motorOutput, motorRangeMin, motorRangeMax);
-                } else {
-                    motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);
-                }
-            }
+        // HF3D:  Only use the idle offset (dshot_idle_value / min_throttle) when the main motor is spinning
+        motorOutput = mixerPlanTailMotor(&mixerPlan, motorOutput, mainMotorThrottle > 0);
+
+        // HF3D:  Dynamic idle raises the tail motor minimum on top of the plan
+        if (motorRangeMin > motorRangeMinBase && mainMotorThrottle > 0 && !mixerPlan.inputs.failsafe) {
+            motorOutput = MAX(motorOutput, motorRangeMin);
         }
+
         motor[1] = motorOutput;     // Set final tail motor output
 
     }  // end of tail motor handling
@@ -1222,7 +1085,6 @@ bool isFixedWing(void)
     }
 }
 
-// HF3D TODO:  Move this to governor/spoolup source file eventually
 // Return the status of whether the heli is spooled up
 // Very critical that this status is correct, because core.c checks it to force 
 //     the pid controller to reset it's I term on each pass if this is set.
@@ -1232,7 +1094,7 @@ uint8_t isHeliSpooledUp(void)
     // spooledUp will set to "1" the first time if it's a "clean" spoolup where you arm and spool to a single throttle setpoint
     //   Jacking around with the throttle during spoolup could cause it to set the spooledUp flag instantly if you're already above 1000rpm
     //   If user spools up above 1000rpm, then lowers throttle below the last spool target reached, the heli will be considered spooled up
-    return spooledUp;
+    return governor.spooledUp;
 }
 
 float mixerGetGovGearRatio(void)
@@ -1240,7 +1102,47 @@ float mixerGetGovGearRatio(void)
     return govGearRatio;
 }
 
-float mixerGetGovCollectivePulseFilterGain(void)
+float mixerGetTailPrecompensation(void)
 {
-    return govColPulseFilterGain;
+    return tailPrecomp;
+}
+
+float mixerGetGovVbatCompensation(void)
+{
+    return governor.vbatCompensation;
+}
+
+const governorState_t *mixerGetGovernorState(void)
+{
+    return &governor;
+}
+
+// Main rotor headspeed in rpm, 0 when not available
+float mixerGetHeadspeed(void)
+{
+    return governor.headspeed;
+}
+
+static void writeGovernorLoadMap(struct dispatchEntry_s* self)
+{
+    UNUSED(self);
+
+    // Don't save if the user made config changes that have not yet been saved.
+    if (!ARMING_FLAG(ARMED) && !isConfigDirty()) {
+        writeEEPROM();
+    }
+}
+
+static dispatchEntry_t writeGovernorLoadMapEntry =
+{
+    writeGovernorLoadMap, 0, NULL, false
+};
+
+// Called on disarm to keep the governor load map learned during the flight
+void mixerSaveGovernorLoadMap(void)
+{
+    if (governorLoadMap()->mode == GOV_LOAD_MAP_LEARN && governorLoadMapStore(&governor, governorLoadMapMutable())) {
+        // Don't execute the time consuming flash operation now - let the disarming process complete first
+        dispatchAdd(&writeGovernorLoadMapEntry, GOV_LOAD_MAP_SAVE_DELAY_US);
+    }
 }
\ No newline at end of file
@@ -27,6 +27,8 @@
 #include "drivers/io_types.h"
 #include "drivers/pwm_output.h"
 
+#include "flight/governor.h"
+
 #define QUAD_MOTOR_COUNT 4
 
 // Note: this is called MultiType/MULTITYPE_* in baseflight.
@@ -77,12 +79,17 @@ typedef struct mixer_s {
     const motorMixer_t *motor;
 } mixer_t;
 
+// HF3D:  Main rotor rotation direction, seen from above
+typedef enum {
+    ROTOR_DIR_CW = 0,
+    ROTOR_DIR_CCW,
+} rotorDirection_e;
+
 typedef struct mixerConfig_s {
     uint8_t mixerMode;
     bool yaw_motors_reversed;
     uint8_t crashflip_motor_percent;
     uint16_t gov_max_headspeed;
-    uint16_t gov_gear_ratio;
     uint16_t gov_p_gain;
     uint16_t gov_i_gain;
     uint16_t gov_cyclic_ff_gain;
@@ -90,10 +97,19 @@ typedef struct mixerConfig_s {
     uint16_t gov_collective_ff_impulse_gain;
     uint16_t gov_collective_ff_impulse_freq;
     uint16_t spoolup_time;
+    uint8_t gov_vbat_comp;
+    uint16_t tail_precomp_throttle_gain;        // HF3D:  Motor driven tail torque precompensation
+    uint16_t tail_precomp_collective_gain;
+    uint16_t tail_precomp_accel_gain;
+    uint8_t gov_bailout_time;                   // HF3D:  Autorotation bailout setpoint ramp time, 0.1s for 0..gov_max_headspeed, 0 = OFF
+    uint8_t gov_bailout_min_headspeed;          // HF3D:  Bailout when the throttle returns with the headspeed above this percent of the setpoint
+    uint8_t main_rotor_dir;                     // HF3D:  Main rotor rotation direction seen from above, see rotorDirection_e
 } mixerConfig_t;
 
 PG_DECLARE(mixerConfig_t, mixerConfig);
 
+PG_DECLARE(governorLoadMap_t, governorLoadMap);
+
 #define CHANNEL_FORWARDING_DISABLED (uint8_t)0xFF
 
 extern const mixer_t mixers[];
@@ -127,4 +143,8 @@ bool isFixedWing(void);
 // HF3D
 uint8_t isHeliSpooledUp(void);
 float mixerGetGovGearRatio(void);
-float mixerGetGovCollectivePulseFilterGain(void);
+void mixerSaveGovernorLoadMap(void);
+float mixerGetGovVbatCompensation(void);
+float mixerGetTailPrecompensation(void);
+const governorState_t *mixerGetGovernorState(void);
+float mixerGetHeadspeed(void);
@@ -0,0 +1,63 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <float.h>
+
+#include "platform.h"
+
+#include "flight/mixer_plan.h"
+
+static void mixerPlanSetOutput(mixerPlanOutput_t *output, float reserved, float reservedOutput, float min, float max)
+{
+    output->reserved = reserved;
+    output->reservedOutput = reservedOutput;
+    output->min = min;
+    output->max = max;
+}
+
+void mixerPlanBuild(mixerPlan_t *plan, const mixerPlanInputs_t *inputs)
+{
+    plan->inputs = *inputs;
+
+    // Lowest output that keeps a motor stopped
+    const float stopOutput = inputs->dshot ? inputs->dshotMinOutput : inputs->disarmOutput;
+
+    // HF3D:  The main motor ignores any idle offset, it must always be able to stop completely at zero throttle.
+    //   Analog PWM uses disarmMotorOutput as the bottom end, min_throttle would make the ESC twitch at zero throttle.
+    plan->mainBase = stopOutput;
+    plan->mainScale = inputs->outputHigh - stopOutput;
+
+    if (inputs->failsafe) {
+        // Prevent getting into the DShot special reserved range
+        mixerPlanSetOutput(&plan->main, stopOutput, inputs->disarmOutput, inputs->disarmOutput, inputs->rangeMax);
+
+        const float tailReserved = inputs->dshot ? inputs->rangeMin : -FLT_MAX;
+        mixerPlanSetOutput(&plan->tail[false], tailReserved, inputs->disarmOutput, inputs->disarmOutput, inputs->rangeMax);
+        plan->tail[true] = plan->tail[false];
+    } else {
+        mixerPlanSetOutput(&plan->main, -FLT_MAX, 0, stopOutput, inputs->rangeMax);
+
+        // HF3D:  Only use the idle offset on the tail when the main motor is spinning, so the tail can stop with the main motor
+        mixerPlanSetOutput(&plan->tail[false], -FLT_MAX, 0, stopOutput, inputs->rangeMax);
+        mixerPlanSetOutput(&plan->tail[true], -FLT_MAX, 0, inputs->rangeMin, inputs->rangeMax);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/maths.h"
+
+// HF3D:  Precomputed motor output plan.
+//   Everything in the motor output stage that only depends on the motor protocol, the output endpoints and failsafe
+//   is resolved by mixerPlanBuild() when one of those changes, so that the per-loop main and tail motor outputs
+//   are a straight-line scale, reserved range check and clamp.
+
+typedef struct mixerPlanInputs_s {
+    bool dshot;                 // digital protocol, DSHOT_MIN_THROTTLE stops the motor
+    bool failsafe;
+    float disarmOutput;         // disarmMotorOutput
+    float dshotMinOutput;       // DSHOT_MIN_THROTTLE
+    float outputHigh;           // motorOutputHigh
+    float rangeMin;             // motorRangeMin, includes the idle offset but not the dynamic idle increase
+    float rangeMax;             // motorRangeMax
+} mixerPlanInputs_t;
+
+typedef struct mixerPlanOutput_s {
+    float reserved;             // outputs below this are replaced by reservedOutput (-FLT_MAX disables)
+    float reservedOutput;
+    float min;
+    float max;
+} mixerPlanOutput_t;
+
+typedef struct mixerPlan_s {
+    mixerPlanInputs_t inputs;   // the plan was built for these
+
+    // Main motor: output = mainBase + mainScale * throttle
+    float mainBase;
+    float mainScale;
+    mixerPlanOutput_t main;
+
+    // Tail motor limits, indexed by main motor running
+    mixerPlanOutput_t tail[2];
+} mixerPlan_t;
+
+void mixerPlanBuild(mixerPlan_t *plan, const mixerPlanInputs_t *inputs);
+
+static inline float mixerPlanApplyOutput(const mixerPlanOutput_t *output, float value)
+{
+    value = (value < output->reserved) ? output->reservedOutput : value;
+    return constrainf(value, output->min, output->max);
+}
+
+static inline float mixerPlanMainMotor(const mixerPlan_t *plan, float throttle)
+{
+    return mixerPlanApplyOutput(&plan->main, plan->mainBase + plan->mainScale * throttle);
+}
+
+static inline float mixerPlanTailMotor(const mixerPlan_t *plan, float output, bool mainMotorRunning)
+{
+    return mixerPlanApplyOutput(&plan->tail[mainMotorRunning], output);
+}
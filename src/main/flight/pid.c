@@ -45,6 +45,7 @@
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
+#include "flight/flat_piro.h"
 #include "flight/gps_rescue.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
@@ -142,7 +143,7 @@ static FAST_RAM_ZERO_INIT float airmodeThrottleOffsetLimit;
 
 #define CRASH_RECOVERY_DETECTION_DELAY_US 1000000  // 1 second delay before crash recovery detection is active after entering a self-level mode
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 13);
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 1);
 
 void resetPidProfile(pidProfile_t *pidProfile)
 {
@@ -229,9 +230,25 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .yawColPulseKf = 300,
         .yawCycKf = 0,
         .yawBaseThrust = 900,
+        .rollColKf = 0,
+        .rollColPulseKf = 0,
+        .pitchColKf = 0,
+        .pitchColPulseKf = 0,
         .rescue_collective = 200,
         .error_decay_always = 0,
         .error_decay_rate = 7,
+        .hs_gain_mode = 0,
+        // Blade thrust goes with headspeed squared, so the cyclic needs roughly 1/rpm^2 more gain below max headspeed
+        .hs_gain_headspeed = { 60, 70, 80, 90, 100 },
+        .hs_gain = {
+            { 250, 204, 156, 123, 100 },
+            { 250, 204, 156, 123, 100 },
+            { 100, 100, 100, 100, 100 },
+        },
+        .piro_comp_mode = PIRO_COMP_OFF,
+        .piro_comp_delay = 10,
+        .flat_piro_tilt = 0,
+        .flat_piro_headspeed = 0,
     );
 #ifndef USE_D_MIN
     pidProfile->pid[PID_ROLL].D = 30;
@@ -529,14 +546,22 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
+// HF3D:  Coefficients and terms are stored axis-packed so the PID core can process all axes together
 typedef struct pidCoefficient_s {
-    float Kp;
-    float Ki;
-    float Kd;
-    float Kf;
+    float Kp[XYZ_AXIS_COUNT];
+    float Ki[XYZ_AXIS_COUNT];
+    float Kd[XYZ_AXIS_COUNT];
+    float Kf[XYZ_AXIS_COUNT];
 } pidCoefficient_t;
 
-static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
+typedef struct pidAxisTerms_s {
+    float P[XYZ_AXIS_COUNT];
+    float I[XYZ_AXIS_COUNT];
+    float D[XYZ_AXIS_COUNT];
+    float F[XYZ_AXIS_COUNT];
+} pidAxisTerms_t;
+
+static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient;
 static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float feedForwardTransition;
 static FAST_RAM_ZERO_INIT float levelGain, horizonGain, horizonTransition, horizonCutoffDegrees, horizonFactorRatio;
@@ -613,6 +638,142 @@ static FAST_RAM_ZERO_INIT ffInterpolationType_t ffFromInterpolatedSetpoint;
 // HF3D
 static FAST_RAM_ZERO_INIT float rescueCollective;
 
+// HF3D:  Headspeed PID gain scheduling
+#define HS_GAIN_FILTER_CUTOFF   2.0f        // Hz, smoothing of the headspeed used for the schedule
+static FAST_RAM_ZERO_INIT bool hsGainEnabled;
+static FAST_RAM_ZERO_INIT float hsGainHeadspeed[HEADSPEED_GAIN_POINTS];                 // break points in rpm
+static FAST_RAM_ZERO_INIT float hsGainTable[XYZ_AXIS_COUNT][HEADSPEED_GAIN_POINTS];     // gain multipliers
+static FAST_RAM_ZERO_INIT pt1Filter_t hsGainFilter;
+static FAST_RAM float hsGain[XYZ_AXIS_COUNT] = { 1.0f, 1.0f, 1.0f };
+
+static void pidInitHeadspeedGain(const pidProfile_t *pidProfile)
+{
+    const float maxHeadspeed = mixerConfig()->gov_max_headspeed;
+
+    hsGainEnabled = pidProfile->hs_gain_mode && maxHeadspeed > 0;
+
+    // Break points must be non-decreasing for the table lookup
+    float lastHeadspeed = 0;
+    for (int i = 0; i < HEADSPEED_GAIN_POINTS; i++) {
+        lastHeadspeed = MAX(lastHeadspeed, pidProfile->hs_gain_headspeed[i] * maxHeadspeed / 100.0f);
+        hsGainHeadspeed[i] = lastHeadspeed;
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            hsGainTable[axis][i] = pidProfile->hs_gain[axis][i] / 100.0f;
+        }
+    }
+
+    // Keep the filtered headspeed across profile changes so the gains don't jump in flight
+    const float filteredHeadspeed = hsGainFilter.state;
+    pt1FilterInit(&hsGainFilter, pt1FilterGain(HS_GAIN_FILTER_CUTOFF, dT));
+    hsGainFilter.state = filteredHeadspeed;
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        hsGain[axis] = 1.0f;
+    }
+}
+
+static void pidUpdateHeadspeedGain(void)
+{
+    if (!hsGainEnabled) {
+        return;
+    }
+
+    const float headspeed = mixerGetHeadspeed();
+
+    // No headspeed signal, fall back to the unscheduled gains
+    if (headspeed <= 0) {
+        hsGainFilter.state = 0;
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            hsGain[axis] = 1.0f;
+        }
+        return;
+    }
+
+    // Start the filter at the first sample instead of ramping up from zero headspeed (= maximum gain)
+    if (hsGainFilter.state <= 0) {
+        hsGainFilter.state = headspeed;
+    }
+    const float filteredHeadspeed = pt1FilterApply(&hsGainFilter, headspeed);
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        hsGain[axis] = interpolateTablef(filteredHeadspeed, hsGainHeadspeed, hsGainTable[axis], HEADSPEED_GAIN_POINTS);
+    }
+}
+
+// HF3D:  Pirouette lookahead.
+//   The roll/pitch correction only acts on the disc after the servo and rotor delay, and by then a pirouetting heli
+//   has turned by yaw rate * delay. The PID output is rotated forward by that angle, the same way the I-term rotation
+//   turns the I-term for the last dT, so that the correction lands where it was meant to.
+//   In AUTO mode the servo output latency of the decimated servo pipeline is added to the configured delay.
+static FAST_RAM_ZERO_INIT uint8_t piroCompMode;
+static FAST_RAM_ZERO_INIT float piroCompDelay;
+
+// HF3D:  Flat pirouette compensation, see flat_piro.h
+static FAST_RAM_ZERO_INIT flatPiro_t flatPiro;
+
+static void pidInitPiroComp(const pidProfile_t *pidProfile)
+{
+    piroCompMode = pidProfile->piro_comp_mode;
+    piroCompDelay = pidProfile->piro_comp_delay * 0.001f;
+}
+
+static FAST_CODE void pidApplyPiroComp(void)
+{
+    if (piroCompMode == PIRO_COMP_OFF) {
+        return;
+    }
+
+    float delay = piroCompDelay;
+#ifdef USE_SERVOS
+    if (piroCompMode == PIRO_COMP_AUTO) {
+        delay += servosGetOutputLatency();
+    }
+#endif
+
+    const float angle = gyro.gyroADCf[FD_YAW] * RAD * delay;
+    const float sinAngle = sin_approx(angle);
+    const float cosAngle = cos_approx(angle);
+
+    const float roll = pidData[FD_ROLL].Sum;
+    const float pitch = pidData[FD_PITCH].Sum;
+
+    pidData[FD_ROLL].Sum = roll * cosAngle + pitch * sinAngle;
+    pidData[FD_PITCH].Sum = pitch * cosAngle - roll * sinAngle;
+}
+
+// HF3D:  Collective precompensation.
+//   Collective changes load the main rotor and twist the heli in yaw through the rotor torque, and depending on the
+//   head also in pitch and roll. These disturbances follow the collective stick, so they are fed forward before the
+//   gyro sees them: a static part proportional to the collective and an impulse part from the high-passed collective.
+//   Yaw follows the collective magnitude (torque), roll and pitch follow the signed collective.
+static FAST_RAM_ZERO_INIT float collectiveStickPercent;
+static FAST_RAM_ZERO_INIT float collectiveStickHPF;
+static FAST_RAM_ZERO_INIT pt1Filter_t collectiveStickLpf;
+static FAST_RAM_ZERO_INIT pt1Filter_t collectiveLpf;
+static FAST_RAM_ZERO_INIT float collectivePrecompGain[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float collectivePrecompPulseGain[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float tailTorqueDir;
+
+static void pidInitCollectivePrecomp(const pidProfile_t *pidProfile)
+{
+    // Negative for a clockwise main rotor spin direction -> CCW body torque on helicopter
+    tailTorqueDir = (mixerConfig()->main_rotor_dir == ROTOR_DIR_CCW) ? 1.0f : -1.0f;
+
+    collectivePrecompGain[FD_ROLL] = pidProfile->rollColKf / 100.0f;
+    collectivePrecompGain[FD_PITCH] = pidProfile->pitchColKf / 100.0f;
+    collectivePrecompGain[FD_YAW] = tailTorqueDir * pidProfile->yawColKf / 100.0f;
+    collectivePrecompPulseGain[FD_ROLL] = pidProfile->rollColPulseKf / 100.0f;
+    collectivePrecompPulseGain[FD_PITCH] = pidProfile->pitchColPulseKf / 100.0f;
+    collectivePrecompPulseGain[FD_YAW] = tailTorqueDir * pidProfile->yawColPulseKf / 100.0f;
+
+    // Impulse filter runs at the PID rate, shared with the governor impulse feedforward
+    //   Setting is frequency in Hz / 100, zero disables the impulse.  Filter states are kept over profile changes.
+    const float cutoff = mixerConfig()->gov_collective_ff_impulse_freq / 100.0f;
+    const float gain = (cutoff > 0) ? pt1FilterGain(cutoff, dT) : 1.0f;
+    collectiveStickLpf.k = gain;
+    collectiveLpf.k = gain;
+}
+
 void pidInitConfig(const pidProfile_t *pidProfile)
 {
     if (pidProfile->feedForwardTransition == 0) {
@@ -622,10 +783,10 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     }
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         // Scale down Roll & Pitch axis PID terms for helicopters.  Leave Yaw axis alone.
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P / ((axis == FD_YAW) ? 1.0f : 10.0f);
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I / ((axis == FD_YAW) ? 1.0f : 5.0f);
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D / ((axis == FD_YAW) ? 1.0f : 10.0f);
-        pidCoefficient[axis].Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        pidCoefficient.Kp[axis] = PTERM_SCALE * pidProfile->pid[axis].P / ((axis == FD_YAW) ? 1.0f : 10.0f);
+        pidCoefficient.Ki[axis] = ITERM_SCALE * pidProfile->pid[axis].I / ((axis == FD_YAW) ? 1.0f : 5.0f);
+        pidCoefficient.Kd[axis] = DTERM_SCALE * pidProfile->pid[axis].D / ((axis == FD_YAW) ? 1.0f : 10.0f);
+        pidCoefficient.Kf[axis] = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
     }
     
     // HF3D:  Yaw integral gain does NOT need boosted on a helicopter.
@@ -633,7 +794,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     // if (!pidProfile->use_integrated_yaw)
 // #endif
     // {
-        // pidCoefficient[FD_YAW].Ki *= 2.5f;
+        // pidCoefficient.Ki[FD_YAW] *= 2.5f;
     // }
 
     levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
@@ -660,7 +821,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     crashLimitYaw = pidProfile->crash_limit_yaw;
     itermLimit = pidProfile->itermLimit;
 #if defined(USE_THROTTLE_BOOST)
-    throttleBoost = pidProfile->throttle_boost;         // HF3D:  Now using this for flat piro compensation parameter testing
+    throttleBoost = pidProfile->throttle_boost;
 #endif
     itermRotation = pidProfile->iterm_rotation;
     //antiGravityMode = pidProfile->antiGravityMode;
@@ -696,8 +857,8 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     acErrorLimit = (float)pidProfile->abs_control_error_limit;
     acCutoff = (float)pidProfile->abs_control_cutoff;
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        float iCorrection = -acGain * PTERM_SCALE / ITERM_SCALE * pidCoefficient[axis].Kp;
-        pidCoefficient[axis].Ki = MAX(0.0f, pidCoefficient[axis].Ki + iCorrection);
+        float iCorrection = -acGain * PTERM_SCALE / ITERM_SCALE * pidCoefficient.Kp[axis];
+        pidCoefficient.Ki[axis] = MAX(0.0f, pidCoefficient.Ki[axis] + iCorrection);
     }
 #endif
 
@@ -757,6 +918,10 @@ void pidInitConfig(const pidProfile_t *pidProfile)
 
     // HF3D
     rescueCollective = pidProfile->rescue_collective;
+    pidInitHeadspeedGain(pidProfile);
+    pidInitPiroComp(pidProfile);
+    flatPiroInit(&flatPiro, mixerConfig()->main_rotor_dir, pidProfile->flat_piro_tilt, pidProfile->flat_piro_headspeed);
+    pidInitCollectivePrecomp(pidProfile);
 }
 
 void pidInit(const pidProfile_t *pidProfile)
@@ -1121,6 +1286,7 @@ static void rotateVector(float v[XYZ_AXIS_COUNT], float rotation[XYZ_AXIS_COUNT]
 //      2000rpm headspeed = 33Hz rotation of blades, and gyroscopic precession means that inputs take 90-degrees of rotation to occur
 //        So worst case is that input determined while blade is at the point it needs to be controlled, rotates 90 degrees where CCPM mixing happens, then pitches 90 degrees later.
 //        Total lag of 180-degrees of rotation worst case = 15ms @ 2000rpm   (After servos have been commanded and started to actually move)
+//      HF3D:  The look-forward rotation of the roll/pitch output is done by pidApplyPiroComp(), with piro_comp_delay covering this lag.
 
 //   Absolute control was made to address the same attitude issues as iterm_rotation, but without some of the downsides.
 //   Absolute Control continuously measures the error of the quads path over stick input, properly rotated into the quads coordinate
@@ -1375,14 +1541,67 @@ float pidGetAirmodeThrottleOffset()
 #endif
 
 
+static FAST_RAM_ZERO_INIT float yawPidSetpoint;         // HF3D:  Hold the previous corrected Yaw setpoint for flat piro compensation
+
+// HF3D:  Collective precompensation, added to the feedforward of each axis
+static FAST_CODE void pidCollectivePrecomp(const pidProfile_t *pidProfile, float *precomp)
+{
+    // Calculate the signed percentage of collective stick throw
+    float collective;
+    if (rcCommand[COLLECTIVE] >= 0) {
+        collective = (rcCommand[COLLECTIVE] * 100.0f) / (PWM_RANGE_MAX - rxConfig()->midrc);
+    } else {
+        collective = (rcCommand[COLLECTIVE] * 100.0f) / (rxConfig()->midrc - PWM_RANGE_MIN);
+    }
+    collective = constrainf(collective, -100.0f, 100.0f);
+    collectiveStickPercent = fabsf(collective);
+
+    // Subtract the lowpassed collective from the original value to get a high pass filter
+    // HPF value will be <60% or so of the collectiveStickPercent, and will be smaller the slower the stick movement is.
+    //  Cutoff frequency determines this action.
+    collectiveStickHPF = collectiveStickPercent - pt1FilterApply(&collectiveStickLpf, collectiveStickPercent);
+    const float collectiveHPF = collective - pt1FilterApply(&collectiveLpf, collective);
+
+    precomp[FD_ROLL] = collectivePrecompGain[FD_ROLL] * collective + collectivePrecompPulseGain[FD_ROLL] * collectiveHPF;
+    precomp[FD_PITCH] = collectivePrecompGain[FD_PITCH] * collective + collectivePrecompPulseGain[FD_PITCH] * collectiveHPF;
+
+    const float tailCollectiveFF = collectivePrecompGain[FD_YAW] * collectiveStickPercent;
+    const float tailCollectivePulseFF = collectivePrecompPulseGain[FD_YAW] * collectiveStickHPF;
+    const float tailBaseThrust = tailTorqueDir * pidProfile->yawBaseThrust / 10.0f;
+
+    // Calculate absolute value of the percentage of cyclic stick throw (both combined... but swash ring is the real issue).
+    const float tailCyclicFF = tailTorqueDir * servosGetSwashRingValue() * 100.0f * pidProfile->yawCycKf / 100.0f;
+
+    // Main motor torque increase from the ESC is proportional to the absolute change in average voltage (NOT percent change in average voltage)
+    //     and it is linear with the amount of change.
+    // Main motor torque will always cause the tail to rotate in in the same direction, so we just need to apply this offset in the correct direction to counter-act that torque.
+    // For CW rotation of the main rotor, the torque will turn the body of the helicopter CCW
+    //   This means the leading edge of the tail blade needs to tip towards the left side of the helicopter to counteract it.
+    //   Yaw stick right = clockwise rotation = tip of tail blade to left = POSITIVE servo values observed on the X3
+    //      NOTE:  Servo values required to obtain a certain direction of change in the tail depends on which side the servo is mounted and if it's a leading or trailing link!!
+    //      It is very important to set the servo reversal configuration up correctly so the servo moves in the same direction as the Preview model!
+    //   Yaw stick right = positive control channel PWM values from the TX also.
+    //   Smix on my rudder channel is setup for -100... so it will take NEGATIVE values in the pidSum to create positive servo movement!
+
+    //   So my collective comp also needs to make positive tail servo values, which means that I need a NEGATIVE adder to the pidSum due to the channel rate reversal.
+    //     But, this should always work for all helis that are also setup correctly, regardless of servo reversal...
+    //     ... as long as it yaws the correct direction to match the Preview model.
+    //     ... and as long as the main motor rotation direction is CW!  CCW rotation requires reversing this and generating POSITIVE pidSum additions,
+    //     which is done through main_rotor_dir.
+
+    // HF3D TODO:  Consider adding a delay in here to allow time for other things to occur...
+    //  Tail servo can probably add pitch faster than the swash servos can add collective pitch
+    //   and it's also probably faster than the ESC can add torque to the main motor (for gov impulse)
+    //  But for motor-driven tails the delay may not be needed... depending on how fast the ESC+motor
+    //   can spin up the tail blades relative to the other pieces of the puzzle.
+
+    precomp[FD_YAW] = tailCollectiveFF + tailCollectivePulseFF + tailBaseThrust + tailCyclicFF;
+}
+
 // Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
 // Based on 2DOF reference design (matlab)
 // Called from subTaskPidController() in pid.c
 //   Runs at equal to or slower than the gyro loop update frequency
-static FAST_RAM_ZERO_INIT float yawPidSetpoint;         // HF3D:  Hold the previous corrected Yaw setpoint for flat piro compensation
-static FAST_RAM_ZERO_INIT float collectiveStickPercent;        // HF3D
-static FAST_RAM_ZERO_INIT float collectiveStickLPF;            // HF3D:  Collective stick values
-static FAST_RAM_ZERO_INIT float collectiveStickHPF;
 void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTimeUs)
 {
     static float previousGyroRateDterm[XYZ_AXIS_COUNT];
@@ -1474,33 +1693,51 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     }
 #endif
 
-    // HF3D TODO:  Roll/Pitch PID compensation based on main rotor RPM
-    //  Blade thrust varies with RPM^2.  Servos should need to move further at lower headspeeds to offset a given rotational error?
-    //  Compensating PID gains with RPM (possibly throttle as a backup) might be helpful in reducing the need for banks of gains for each headspeed.
-    //  Yaw axis PID RPM compensation would depend on whether it was a motor driven or variable pitch tail?
+    // HF3D:  PID gain scheduling based on main rotor headspeed.
+    //  Blade thrust varies with RPM^2, so the servos need to move further at lower headspeeds to correct a given rotational error.
+    //  Yaw depends on whether the tail is motor driven or variable pitch, so it has its own schedule.
+    pidUpdateHeadspeedGain();
 
     // ----------PID controller----------
+    // HF3D:  The PID core works on axis-packed arrays.  Per-axis special cases run as separate passes around
+    //   a common P/I/D core that does the same maths for all three axes, so the compiler can unroll and vectorise it.
+    //   pidData[axis].I holds the previous I-term until the results are written back in the final pass.
+    float currentPidSetpoint[XYZ_AXIS_COUNT];
+    float errorRate[XYZ_AXIS_COUNT];
+    float itermErrorRate[XYZ_AXIS_COUNT];
+    float pidSetpointDelta[XYZ_AXIS_COUNT];
+    float gyroRateDelta[XYZ_AXIS_COUNT];
+#ifdef USE_ABSOLUTE_CONTROL
+    float setpointCorrection[XYZ_AXIS_COUNT];
+#endif
+    pidAxisTerms_t terms;
+
+    // HF3D:  Collective disturbances are predicted from the sticks before the errors are calculated
+    float collectivePrecomp[XYZ_AXIS_COUNT];
+    pidCollectivePrecomp(pidProfile, collectivePrecomp);
+
+    // ----------Setpoint pass----------
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
 
         // Get the user's roll rate command on this axis after expo and other rate modifications have been made
         //  Units are deg/s... maximum set in profile, default max rate is 1998 deg/s
-        float currentPidSetpoint = getSetpointRate(axis);
+        float setpoint = getSetpointRate(axis);
         if (maxVelocity[axis]) {
-            currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
+            setpoint = accelerationLimit(axis, setpoint);
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
 #if defined(USE_ACC)
         if (levelModeActive && (axis != FD_YAW)) {
-            currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+            setpoint = pidLevel(axis, pidProfile, angleTrim, setpoint);
         } else if (FLIGHT_MODE(ANGLE_MODE) && (axis == FD_YAW)) {
             // HF3D:  Don't allow user to give yaw input while rescue (angle) mode corrections are occuring
-            currentPidSetpoint = 0.0f;
+            setpoint = 0.0f;
         }
 #endif
 
 #ifdef USE_ACRO_TRAINER
         if ((axis != FD_YAW) && acroTrainerActive && !inCrashRecoveryMode) {
-            currentPidSetpoint = applyAcroTrainer(axis, angleTrim, currentPidSetpoint);
+            setpoint = applyAcroTrainer(axis, angleTrim, setpoint);
         }
 #endif // USE_ACRO_TRAINER
 
@@ -1508,258 +1745,227 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         // It's not necessary to zero the set points for R/P because the PIDs will be zeroed below
 #ifdef USE_YAW_SPIN_RECOVERY
         if ((axis == FD_YAW) && yawSpinActive) {
-            currentPidSetpoint = 0.0f;
+            setpoint = 0.0f;
         }
 #endif // USE_YAW_SPIN_RECOVERY
 
-        // HF3D TODO:  Flat pirouette compensation
+        // HF3D:  Flat pirouette compensation
         //  Compensate for the fact that the main shaft axis is not aligned with the Z axis due to the roll tilt required to compensate for tail blade thrust
-        //  Create a wobble of the main shaft axis around the Z axis by adding roll and pitch commands proportional to the yaw rotation rate
-        if (axis == FD_ROLL && throttleBoost > 1.0f) {
-            // HF3D TODO:  Change roll compensation sign based on main motor rotation direction (tail thrust direction)
-            currentPidSetpoint += fabsf(yawPidSetpoint) / throttleBoost;    // Roll compensation direction is same regardless of yaw direction
-        } else if (axis == FD_PITCH && throttleBoost > 1.0f) {
-            currentPidSetpoint += yawPidSetpoint / throttleBoost;          // Pitch compensation direction depends on yaw direction
+        //  The shaft lean has to turn with the heli, which takes a pitch rate proportional to the yaw rate
+        //  The lean reverses with the thrust when inverted
+        if (axis == FD_PITCH) {
+            setpoint += flatPiroApply(&flatPiro, yawPidSetpoint, mixerGetHeadspeed(), rcCommand[COLLECTIVE]);
         }
 
         // -----calculate error rate
         const float gyroRate = gyro.gyroADCf[axis]; // Process variable from gyro output in deg/sec
-        float errorRate = currentPidSetpoint - gyroRate; // r - y
+        errorRate[axis] = setpoint - gyroRate; // r - y
 /* #if defined(USE_ACC)
         handleCrashRecovery(
             pidProfile->crash_recovery, angleTrim, axis, currentTimeUs, gyroRate,
-            &currentPidSetpoint, &errorRate);
+            &setpoint, &errorRate[axis]);
 #endif
  */
-        const float previousIterm = pidData[axis].I;
-        float itermErrorRate = errorRate;
+        itermErrorRate[axis] = errorRate[axis];
 #ifdef USE_ABSOLUTE_CONTROL
-        float uncorrectedSetpoint = currentPidSetpoint;
+        const float uncorrectedSetpoint = setpoint;
 #endif
 
 #if defined(USE_ITERM_RELAX)
         if (!inCrashRecoveryMode) {
             // Absolute Control is applied after iTermRelax as part of this function
-            applyItermRelax(axis, previousIterm, gyroRate, &itermErrorRate, &currentPidSetpoint);
-            errorRate = currentPidSetpoint - gyroRate;
+            applyItermRelax(axis, pidData[axis].I, gyroRate, &itermErrorRate[axis], &setpoint);
+            errorRate[axis] = setpoint - gyroRate;
         }
 #endif
 #ifdef USE_ABSOLUTE_CONTROL
-        float setpointCorrection = currentPidSetpoint - uncorrectedSetpoint;
+        setpointCorrection[axis] = setpoint - uncorrectedSetpoint;
 #endif
 
         // HF3D:  After all setpoint changes are done, get Yaw setpoint for flat pirouette compensation
         if (axis == FD_YAW) {
-            yawPidSetpoint = currentPidSetpoint;
-        }
-
-        // --------low-level gyro-based PID based on 2DOF PID controller. ----------
-        // 2-DOF PID controller with optional filter on derivative term.
-        // b = 1 and only c (feedforward weight) can be tuned (amount derivative on measurement or error).
-
-        // -----calculate P component
-        pidData[axis].P = pidCoefficient[axis].Kp * errorRate * tpaFactorKp;
-        if (axis == FD_YAW) {
-            pidData[axis].P = ptermYawLowpassApplyFn((filter_t *) &ptermYawLowpass, pidData[axis].P);
-        }
-
-        // -----calculate I component
-        const float Ki = pidCoefficient[axis].Ki;
-        // dynCi = dT if airmode disabled and iterm_windup = 100
-        pidData[axis].I = constrainf(previousIterm + Ki * itermErrorRate * dynCi, -itermLimit, itermLimit);
-        
-        // Decay accumulated error if appropriate
-#define signorzero(x) ((x < 0) ? -1 : (x > 0) ? 1 : 0)
-        if (!isHeliSpooledUp() || pidProfile->error_decay_always) {
-            // Calculate number of degrees to remove from the accumulated error
-            const float decayFactor = pidProfile->error_decay_rate * dT;
-
-            pidData[axis].I -= signorzero(pidData[axis].I) * decayFactor * Ki;
-#if defined(USE_ABSOLUTE_CONTROL)
-            axisError[axis] -= signorzero(axisError[axis]) * decayFactor;
-#endif
+            yawPidSetpoint = setpoint;
         }
 
         // -----calculate pidSetpointDelta
-        float pidSetpointDelta = 0;
+        float setpointDelta = 0;
 #ifdef USE_INTERPOLATED_SP
         if (ffFromInterpolatedSetpoint) {
-            pidSetpointDelta = interpolatedSpApply(axis, newRcFrame, ffFromInterpolatedSetpoint);
+            setpointDelta = interpolatedSpApply(axis, newRcFrame, ffFromInterpolatedSetpoint);
         } else {
-            pidSetpointDelta = currentPidSetpoint - previousPidSetpoint[axis];
+            setpointDelta = setpoint - previousPidSetpoint[axis];
         }
 #else
-        pidSetpointDelta = currentPidSetpoint - previousPidSetpoint[axis];
+        setpointDelta = setpoint - previousPidSetpoint[axis];
 #endif
-        previousPidSetpoint[axis] = currentPidSetpoint;
-
+        previousPidSetpoint[axis] = setpoint;
 
 #ifdef USE_RC_SMOOTHING_FILTER
-        pidSetpointDelta = applyRcSmoothingDerivativeFilter(axis, pidSetpointDelta);
+        setpointDelta = applyRcSmoothingDerivativeFilter(axis, setpointDelta);
 #endif // USE_RC_SMOOTHING_FILTER
 
+        currentPidSetpoint[axis] = setpoint;
+        pidSetpointDelta[axis] = setpointDelta;
+    }
+
+    // --------low-level gyro-based PID based on 2DOF PID controller. ----------
+    // 2-DOF PID controller with optional filter on derivative term.
+    // b = 1 and only c (feedforward weight) can be tuned (amount derivative on measurement or error).
+
+    // ----------Common P/I/D core----------
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        // -----calculate P component
+        terms.P[axis] = pidCoefficient.Kp[axis] * hsGain[axis] * errorRate[axis] * tpaFactorKp;
+
+        // -----calculate I component
+        // dynCi = dT if airmode disabled and iterm_windup = 100
+        terms.I[axis] = constrainf(pidData[axis].I + pidCoefficient.Ki[axis] * hsGain[axis] * itermErrorRate[axis] * dynCi, -itermLimit, itermLimit);
+
         // -----calculate D component
-        if (pidCoefficient[axis].Kd > 0){
+        // Divide rate change by dT to get differential (ie dr/dt).
+        // dT is fixed and calculated from the target PID loop time
+        // This is done to avoid DTerm spikes that occur with dynamically
+        // calculated deltaT whenever another task causes the PID
+        // loop execution to be delayed.
+        gyroRateDelta[axis] = - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
+        previousGyroRateDterm[axis] = gyroRateDterm[axis];
+        terms.D[axis] = pidCoefficient.Kd[axis] * hsGain[axis] * gyroRateDelta[axis] * tpaFactor;
+
+        // -----feedforward gain, the feedforward shape is axis specific and applied below
+        terms.F[axis] = pidCoefficient.Kf[axis] * hsGain[axis];
+    }
 
-            // Divide rate change by dT to get differential (ie dr/dt).
-            // dT is fixed and calculated from the target PID loop time
-            // This is done to avoid DTerm spikes that occur with dynamically
-            // calculated deltaT whenever another task causes the PID
-            // loop execution to be delayed.
-            const float delta =
-                - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
+    // ----------Yaw P-term lowpass----------
+    terms.P[FD_YAW] = ptermYawLowpassApplyFn((filter_t *) &ptermYawLowpass, terms.P[FD_YAW]);
+
+#ifdef USE_SERVOS
+    // ----------Servo anti-windup----------
+    // HF3D:  The I-term may unwind but not grow while the servos can't keep up
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        const float previousIterm = pidData[axis].I;
+        if (servosIsAxisSaturated(axis) && fabsf(terms.I[axis]) > fabsf(previousIterm)) {
+            terms.I[axis] = previousIterm;
+        }
+    }
+#endif
+
+    // ----------I-term decay----------
+    // Decay accumulated error if appropriate
+#define signorzero(x) ((x < 0) ? -1 : (x > 0) ? 1 : 0)
+    if (!isHeliSpooledUp() || pidProfile->error_decay_always) {
+        // Calculate number of degrees to remove from the accumulated error
+        const float decayFactor = pidProfile->error_decay_rate * dT;
 
+        for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+            terms.I[axis] -= signorzero(terms.I[axis]) * decayFactor * (pidCoefficient.Ki[axis] * hsGain[axis]);
+#if defined(USE_ABSOLUTE_CONTROL)
+            axisError[axis] -= signorzero(axisError[axis]) * decayFactor;
+#endif
+        }
+    }
+
+    // ----------D-term gating and D-min----------
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        if (pidCoefficient.Kd[axis] > 0) {
 /* #if defined(USE_ACC)
             if (cmpTimeUs(currentTimeUs, levelModeStartTimeUs) > CRASH_RECOVERY_DETECTION_DELAY_US) {
-                detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, delta, errorRate);
+                detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, gyroRateDelta[axis], errorRate[axis]);
             }
 #endif */
 
-            float dMinFactor = 1.0f;
 #if defined(USE_D_MIN)
             if (dMinPercent[axis] > 0) {
-                float dMinGyroFactor = biquadFilterApply(&dMinRange[axis], delta);
+                float dMinGyroFactor = biquadFilterApply(&dMinRange[axis], gyroRateDelta[axis]);
                 dMinGyroFactor = fabsf(dMinGyroFactor) * dMinGyroGain;
-                const float dMinSetpointFactor = (fabsf(pidSetpointDelta)) * dMinSetpointGain;
-                dMinFactor = MAX(dMinGyroFactor, dMinSetpointFactor);
+                const float dMinSetpointFactor = (fabsf(pidSetpointDelta[axis])) * dMinSetpointGain;
+                float dMinFactor = MAX(dMinGyroFactor, dMinSetpointFactor);
                 dMinFactor = dMinPercent[axis] + (1.0f - dMinPercent[axis]) * dMinFactor;
                 dMinFactor = pt1FilterApply(&dMinLowpass[axis], dMinFactor);
                 dMinFactor = MIN(dMinFactor, 1.0f);
+                terms.D[axis] *= dMinFactor;
                 if (axis == FD_ROLL) {
                     DEBUG_SET(DEBUG_D_MIN, 0, lrintf(dMinGyroFactor * 100));
                     DEBUG_SET(DEBUG_D_MIN, 1, lrintf(dMinSetpointFactor * 100));
-                    DEBUG_SET(DEBUG_D_MIN, 2, lrintf(pidCoefficient[axis].Kd * dMinFactor * 10 / DTERM_SCALE));
+                    DEBUG_SET(DEBUG_D_MIN, 2, lrintf(pidCoefficient.Kd[axis] * dMinFactor * 10 / DTERM_SCALE));
                 } else if (axis == FD_PITCH) {
-                    DEBUG_SET(DEBUG_D_MIN, 3, lrintf(pidCoefficient[axis].Kd * dMinFactor * 10 / DTERM_SCALE));
+                    DEBUG_SET(DEBUG_D_MIN, 3, lrintf(pidCoefficient.Kd[axis] * dMinFactor * 10 / DTERM_SCALE));
                 }
             }
 #endif
-            pidData[axis].D = pidCoefficient[axis].Kd * delta * tpaFactor * dMinFactor;
         } else {
-            pidData[axis].D = 0;
+            terms.D[axis] = 0;
         }
-        previousGyroRateDterm[axis] = gyroRateDterm[axis];
+    }
 
-        // -----calculate feedforward component
+    // ----------Feedforward----------
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
 #ifdef USE_ABSOLUTE_CONTROL
         // include abs control correction in FF
-        pidSetpointDelta += setpointCorrection - oldSetpointCorrection[axis];
-        oldSetpointCorrection[axis] = setpointCorrection;
+        pidSetpointDelta[axis] += setpointCorrection[axis] - oldSetpointCorrection[axis];
+        oldSetpointCorrection[axis] = setpointCorrection[axis];
 #endif
 
         // Only enable feedforward for rate mode (flightModeFlag=0 is acro/rate mode)
         //  HF3D:  Changed this so horizon & angle modes have feedforward also
-        //const float feedforwardGain = (flightModeFlags) ? 0.0f : pidCoefficient[axis].Kf;
-        const float feedforwardGain = pidCoefficient[axis].Kf;
+        const float feedforwardGain = terms.F[axis];
         if (feedforwardGain > 0) {
             // transition = 1 if feedForwardTransition == 0   (no transition)
             float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1.0f;
             // HF3D:  Direct stick feedforward for roll and pitch.  Stick delta feedforward for yaw.
             // Let's do direct stick feedforward for roll & pitch, and let's AMP IT UP A LOT.
             // 0.013754 * 90 * 1 * 60 deg/s = 74 output for 100 feedForward gain
-            float feedForward = feedforwardGain * 90.0f * transition * currentPidSetpoint;
-            // Stick delta feedforward for the yaw axis.
-            if (axis == FD_YAW) {
-                feedForward = feedforwardGain * transition * pidSetpointDelta * pidFrequency;    //  Kf * 1 * 20 deg/s * 8000
-            }
-
-#ifdef USE_INTERPOLATED_SP
-            // HF3D:  Only apply feedforward interpolation limits to the Yaw axis since we're using direct feedforward on the roll and pitch axes.
-            if (axis == FD_YAW) {
-                pidData[axis].F = shouldApplyFfLimits(axis) ?
-                    applyFfLimit(axis, feedForward, pidCoefficient[axis].Kp, currentPidSetpoint) : feedForward;
+            if (axis != FD_YAW) {
+                terms.F[axis] = feedforwardGain * 90.0f * transition * currentPidSetpoint[axis];
             } else {
-               pidData[axis].F = feedForward;
-            }               
+                // Stick delta feedforward for the yaw axis.
+                const float feedForward = feedforwardGain * transition * pidSetpointDelta[axis] * pidFrequency;    //  Kf * 1 * 20 deg/s * 8000
+#ifdef USE_INTERPOLATED_SP
+                // HF3D:  Only apply feedforward interpolation limits to the Yaw axis since we're using direct feedforward on the roll and pitch axes.
+                terms.F[axis] = shouldApplyFfLimits(axis) ?
+                    applyFfLimit(axis, feedForward, pidCoefficient.Kp[axis], currentPidSetpoint[axis]) : feedForward;
 #else
-            pidData[axis].F = feedForward;
+                terms.F[axis] = feedForward;
 #endif
+            }
         } else {
-            pidData[axis].F = 0;
+            terms.F[axis] = 0;
         }
-        
-         // HF3D:  Calculate tail feedforward precompensation and add it to the pidSum on the Yaw channel
-        if (axis == FD_YAW) {
-            
-            // Calculate absolute value of the percentage of collective stick throw
-            if ((rcCommand[COLLECTIVE] >= 500) || (rcCommand[COLLECTIVE] <= -500)) {
-                collectiveStickPercent = 100.0f;
-            } else {
-                if (rcCommand[COLLECTIVE] >= 0) {
-                    collectiveStickPercent = (rcCommand[COLLECTIVE] * 100.0f) / (PWM_RANGE_MAX - rxConfig()->midrc);
-                } else if (rcCommand[COLLECTIVE] < 0) {
-                    collectiveStickPercent = (rcCommand[COLLECTIVE] * -100.0f) / (rxConfig()->midrc - PWM_RANGE_MIN);
-                }
-            }
-            
-            // Collective pitch impulse feed-forward for the main motor
-            // Run our collectiveStickPercent through a low pass filter
-            // HF3D TODO:  Pulse filter calc should probably be moved to PID?  But it probably shouldn't be a profile setting?
-            collectiveStickLPF = collectiveStickLPF + mixerGetGovCollectivePulseFilterGain() * (collectiveStickPercent - collectiveStickLPF);
-            // Subtract LPF from the original value to get a high pass filter
-            // HPF value will be <60% or so of the collectiveStickPercent, and will be smaller the slower the stick movement is.
-            //  Cutoff frequency determines this action.
-            collectiveStickHPF = collectiveStickPercent - collectiveStickLPF;
-
-            // HF3D TODO:  Negative because of clockwise main rotor spin direction -> CCW body torque on helicopter
-            //   Implement a configuration parameter for rotor rotation direction
-            float tailCollectiveFF = -1.0f * collectiveStickPercent * pidProfile->yawColKf / 100.0f;
-            float tailCollectivePulseFF = -1.0f * collectiveStickHPF * pidProfile->yawColPulseKf / 100.0f;
-            float tailBaseThrust = -1.0f * pidProfile->yawBaseThrust / 10.0f;
-            
-            // HF3D TODO:  Add cyclic feedforward for yaw
-            // float tailCyclicFF = ...
-			
-            // Calculate absolute value of the percentage of cyclic stick throw (both combined... but swash ring is the real issue).
-			float tailCyclicFF = -1.0f * servosGetSwashRingValue() * 100.0f * pidProfile->yawCycKf / 100.0f;
-            
-            // Main motor torque increase from the ESC is proportional to the absolute change in average voltage (NOT percent change in average voltage)
-            //     and it is linear with the amount of change.
-            // Main motor torque will always cause the tail to rotate in in the same direction, so we just need to apply this offset in the correct direction to counter-act that torque.
-            // For CW rotation of the main rotor, the torque will turn the body of the helicopter CCW
-            //   This means the leading edge of the tail blade needs to tip towards the left side of the helicopter to counteract it.
-            //   Yaw stick right = clockwise rotation = tip of tail blade to left = POSITIVE servo values observed on the X3
-            //      NOTE:  Servo values required to obtain a certain direction of change in the tail depends on which side the servo is mounted and if it's a leading or trailing link!!
-            //      It is very important to set the servo reversal configuration up correctly so the servo moves in the same direction as the Preview model!
-            //   Yaw stick right = positive control channel PWM values from the TX also.
-            //   Smix on my rudder channel is setup for -100... so it will take NEGATIVE values in the pidSum to create positive servo movement!
-
-            //   So my collective comp also needs to make positive tail servo values, which means that I need a NEGATIVE adder to the pidSum due to the channel rate reversal.
-            //     But, this should always work for all helis that are also setup correctly, regardless of servo reversal...
-            //     ... as long as it yaws the correct direction to match the Preview model.
-            //     ... and as long as the main motor rotation direction is CW!  CCW rotation will require reversing this and generating POSITIVE pidSum additions!
-            // HF3D TODO:  Add a "main rotor rotation direction" configuration parameter.
-            
-            // HF3D TODO:  Consider adding a delay in here to allow time for other things to occur...
-            //  Tail servo can probably add pitch faster than the swash servos can add collective pitch
-            //   and it's also probably faster than the ESC can add torque to the main motor (for gov impulse)
-            //  But for motor-driven tails the delay may not be needed... depending on how fast the ESC+motor
-            //   can spin up the tail blades relative to the other pieces of the puzzle.
-            
-            // Add our collective feedforward terms into the yaw axis pidSum as long as we don't have a motor driven tail
-            if (getMotorCount() == 1) {
-                pidData[FD_YAW].F += tailCollectiveFF + tailCollectivePulseFF + tailBaseThrust + tailCyclicFF;
-            }
-            // HF3D TODO:  Do some integration of the motor driven tail code here for motorCount == 2...
-            //   But have to be careful, because if main motor throttle goes near zero then we'll never get the tail back if we're
-            //   adding feedforward that doesn't need to be there.  We can't create negative thrust with a motor driven fixed pitch tail.
-                        
-        }       
+    }
+
+    // ----------Collective precompensation----------
+    // Add our collective feedforward terms into the yaw axis pidSum as long as we don't have a motor driven tail
+    terms.F[FD_ROLL] += collectivePrecomp[FD_ROLL];
+    terms.F[FD_PITCH] += collectivePrecomp[FD_PITCH];
+    if (getMotorCount() == 1) {
+        terms.F[FD_YAW] += collectivePrecomp[FD_YAW];
+    }
+    // HF3D TODO:  Do some integration of the motor driven tail code here for motorCount == 2...
+    //   But have to be careful, because if main motor throttle goes near zero then we'll never get the tail back if we're
+    //   adding feedforward that doesn't need to be there.  We can't create negative thrust with a motor driven fixed pitch tail.
 
 #ifdef USE_YAW_SPIN_RECOVERY
-        if (yawSpinActive) {
-            pidData[axis].I = 0;  // in yaw spin always disable I
+    // ----------Yaw spin recovery----------
+    if (yawSpinActive) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+            terms.I[axis] = 0;  // in yaw spin always disable I
             if (axis <= FD_PITCH)  {
-                // zero PIDs on pitch and roll leaving yaw P to correct spin 
-                pidData[axis].P = 0;
-                pidData[axis].D = 0;
-                pidData[axis].F = 0;
+                // zero PIDs on pitch and roll leaving yaw P to correct spin
+                terms.P[axis] = 0;
+                terms.D[axis] = 0;
+                terms.F[axis] = 0;
             }
         }
+    }
 #endif // USE_YAW_SPIN_RECOVERY
 
-        // calculating the PID sum
-        const float pidSum = pidData[axis].P + pidData[axis].I + pidData[axis].D + pidData[axis].F;
+    // ----------Write back and calculate the PID sum----------
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        pidData[axis].P = terms.P[axis];
+        pidData[axis].I = terms.I[axis];
+        pidData[axis].D = terms.D[axis];
+        pidData[axis].F = terms.F[axis];
+
+        const float pidSum = terms.P[axis] + terms.I[axis] + terms.D[axis] + terms.F[axis];
 #ifdef USE_INTEGRATED_YAW_CONTROL
         if (axis == FD_YAW && useIntegratedYaw) {
             pidData[axis].Sum += pidSum * dT * 100.0f;
@@ -1769,9 +1975,11 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         {
             pidData[axis].Sum = pidSum;
         }
-        
     }
 
+    // HF3D:  Pirouette lookahead on the final roll/pitch output
+    pidApplyPiroComp();
+
 /*     // HF3D:  PID Delay Compensation
     //  Allows for higher PID gains since the previous control actions the helicopter hasn't responded to yet are taken into account in the PID controller output
     // Update the PID sums by subtracting the previous unresponded control inputs from the current PID controller outputs
@@ -48,6 +48,9 @@
 #define ITERM_RELAX_SETPOINT_THRESHOLD 40.0f
 #define ITERM_RELAX_CUTOFF_DEFAULT 20
 
+// HF3D:  Number of break points in the headspeed PID gain schedule
+#define HEADSPEED_GAIN_POINTS 5
+
 typedef enum {
     PID_ROLL,
     PID_PITCH,
@@ -68,6 +71,12 @@ typedef enum {
     PID_STABILISATION_ON
 } pidStabilisationState_e;
 
+typedef enum {
+    PIRO_COMP_OFF = 0,
+    PIRO_COMP_FIXED,
+    PIRO_COMP_AUTO,
+} pidPiroCompMode_e;
+
 typedef enum {
     PID_CRASH_RECOVERY_OFF = 0,
     PID_CRASH_RECOVERY_ON,
@@ -186,9 +195,20 @@ typedef struct pidProfile_s {
     uint16_t yawColPulseKf;                 // Feedforward for collective impulse into Yaw
     uint16_t yawCycKf;                      // Feedforward for cyclic into Yaw
     uint16_t yawBaseThrust;                 // Base thrust for the tail
+    int16_t rollColKf;                      // Feedforward for collective into Roll
+    int16_t rollColPulseKf;                 // Feedforward for collective impulse into Roll
+    int16_t pitchColKf;                     // Feedforward for collective into Pitch
+    int16_t pitchColPulseKf;                // Feedforward for collective impulse into Pitch
     uint16_t rescue_collective;             // Collective pitch command when rescue is fully upright
     uint8_t error_decay_always;             // Always decay accumulated I term and Abs Control error?
     uint8_t error_decay_rate;               // Rate to decay accumulated error in deg/s
+    uint8_t hs_gain_mode;                   // Headspeed PID gain scheduling off / on
+    uint8_t hs_gain_headspeed[HEADSPEED_GAIN_POINTS];           // Schedule break points in % of gov_max_headspeed
+    uint8_t hs_gain[XYZ_AXIS_COUNT][HEADSPEED_GAIN_POINTS];     // PID gain % at each break point, 100 = unity
+    uint8_t piro_comp_mode;                 // Pirouette lookahead off / fixed delay / servo latency + delay, see pidPiroCompMode_e
+    uint8_t piro_comp_delay;                // Pirouette lookahead actuator delay in ms
+    uint8_t flat_piro_tilt;                 // Flat pirouette main shaft lean against the tail thrust in 0.1 degrees, 0 = OFF
+    uint16_t flat_piro_headspeed;           // Headspeed in rpm the lean was set at, 0 = lean independent of headspeed
     
 } pidProfile_t;
 
@@ -60,6 +60,7 @@
 #define SECONDS_PER_MINUTE      60.0f
 #define ERPM_PER_LSB            100.0f
 #define MIN_UPDATE_T            0.001f
+#define RPM_FILTER_MAXSETS      3       // HF3D:  Harmonic sets per motor: rotor, motor (if geared), belt driven tail (main motor only)
 
 static pt1Filter_t rpmFilters[MAX_SUPPORTED_MOTORS];
 
@@ -72,13 +73,17 @@ typedef struct rpmNotchFilter_s
     float   q;
     float   loopTime;
 
+    uint8_t motorHarmonics[MAX_SUPPORTED_MOTORS];   // HF3D:  Harmonics actually used by each motor
+
     biquadFilter_t notch[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS][RPM_FILTER_MAXHARMONICS];
 } rpmNotchFilter_t;
 
-FAST_RAM_ZERO_INIT static float   erpmToHz;      // HF3D TODO:  Change erpmToHz to array to allow for 2 different motors (main and tail)
-FAST_RAM_ZERO_INIT static float   erpmToHz1;     // HF3D TODO:  Change erpmToHz to array to allow for 2 different motors (main and tail)
-FAST_RAM_ZERO_INIT static float   tailGearRatio; // HF3D
+FAST_RAM_ZERO_INIT static float   erpmToHz[MAX_SUPPORTED_MOTORS];
+FAST_RAM_ZERO_INIT static float   erpmToRotorHz[MAX_SUPPORTED_MOTORS];                      // HF3D:  erpmToHz / motor gear ratio
+FAST_RAM_ZERO_INIT static float   harmonicRatio[MAX_SUPPORTED_MOTORS][RPM_FILTER_MAXSETS];  // HF3D:  Harmonic set frequency per rotor frequency
+FAST_RAM_ZERO_INIT static uint8_t harmonicSets[MAX_SUPPORTED_MOTORS];
 FAST_RAM_ZERO_INIT static float   filteredMotorErpm[MAX_SUPPORTED_MOTORS];
+FAST_RAM_ZERO_INIT static uint32_t motorErpmSamples[MAX_SUPPORTED_MOTORS];   // HF3D:  Telemetry frames received, used to run the governor on fresh data
 FAST_RAM_ZERO_INIT static float   minMotorFrequency;
 FAST_RAM_ZERO_INIT static uint8_t numberFilters;
 FAST_RAM_ZERO_INIT static uint8_t numberRpmNotchFilters;
@@ -93,7 +98,8 @@ FAST_RAM_ZERO_INIT static uint8_t currentHarmonic;
 FAST_RAM_ZERO_INIT static uint8_t currentFilterNumber;
 FAST_RAM static rpmNotchFilter_t* currentFilter = &filters[0];
 
-FAST_RAM_ZERO_INIT static uint8_t rpmSource;    // HF3D:  Dshot telemetry = 0, RPM sensor = 1, ESC_Sensor = 2
+FAST_RAM_ZERO_INIT static uint8_t rpmSource[MAX_SUPPORTED_MOTORS];    // HF3D:  rpmSource_e, resolved from RPM_SOURCE_AUTO
+FAST_RAM_ZERO_INIT static bool    rpmSourceAvailable;
 
 
 PG_REGISTER_WITH_RESET_FN(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 3);
@@ -114,15 +120,15 @@ void pgResetFn_rpmFilterConfig(rpmFilterConfig_t *config)
 
 static void rpmNotchFilterInit(rpmNotchFilter_t* filter, int harmonics, int minHz, int q, float looptime)
 {
-    // If tail gear ratio != 0, harmonics will be created for the tail rpm as well
-    // If main gear ratio > 1.1, harmonics will be created for the main motor rpm as well
-    int totalHarmonicsCount = harmonics;
-    if (mixerGetGovGearRatio() > 1.1f) {
-        totalHarmonicsCount += harmonics;
-    }
-    if (tailGearRatio > 0) {
-        totalHarmonicsCount += harmonics;
+    // HF3D:  Each motor gets a set of harmonics for its rotor (headspeed or tail rotor speed),
+    //   one for the motor itself if it's geared, and one for a belt driven tail if it's the main motor
+    int maxSets = 1;
+    for (int motor = 0; motor < getMotorCount(); motor++) {
+        filter->motorHarmonics[motor] = harmonics * harmonicSets[motor];
+        maxSets = MAX(maxSets, harmonicSets[motor]);
     }
+    const int totalHarmonicsCount = harmonics * maxSets;
+
     filter->harmonics = totalHarmonicsCount;
     filter->harmonicsPerFreq = harmonics;
     filter->minHz = minHz;
@@ -133,24 +139,11 @@ static void rpmNotchFilterInit(rpmNotchFilter_t* filter, int harmonics, int minH
         for (int motor = 0; motor < getMotorCount(); motor++) {
             for (int currentHarmonic = 0; currentHarmonic < totalHarmonicsCount; currentHarmonic++) {
                 // Initialize each filter to minHz * harmonic
-                float frequencyMultiplier = 0.0f;
-                int workingHarmonic = currentHarmonic % harmonics;
-                // Figure out if we're on a head, main, or tail harmonic
-                if (currentHarmonic < harmonics) {
-                    // First set of harmonics are always headspeed
-                    frequencyMultiplier = (workingHarmonic + 1);           
-                } else if (currentHarmonic / harmonics == 1) {
-                    // Calculate main motor frequency using headspeed
-                    // HF3D TODO:  Kind of inefficient right now how we're using mainGearRatio to calculate headspeed and then undoing it here?
-                    frequencyMultiplier = (workingHarmonic + 1) * mixerGetGovGearRatio();
-                } else if (currentHarmonic / harmonics == 2) {
-                    // Calculate tail frequency using headspeed
-                    frequencyMultiplier = (workingHarmonic + 1) * tailGearRatio;
-                }
+                const float frequencyMultiplier = ((currentHarmonic % harmonics) + 1) * harmonicRatio[motor][currentHarmonic / harmonics];
                 // HF3D:  This used to be minHz*i, but that initializes the first filter to 0Hz... which probably isn't right?
                 //   But it also probably doesn't matter since the filter coefficients will be updated on the next loop through.
                 biquadFilterInit(
-                    &filter->notch[axis][motor][currentHarmonic], minHz * frequencyMultiplier, looptime, filter->q, FILTER_NOTCH);
+                    &filter->notch[axis][motor][currentHarmonic], minHz * MAX(frequencyMultiplier, 1.0f), looptime, filter->q, FILTER_NOTCH);
             }
         }
     }
@@ -160,21 +153,58 @@ void rpmFilterInit(const rpmFilterConfig_t *config)
 {
     currentFilter = &filters[0];
     currentMotor = currentHarmonic = currentFilterNumber = 0;
-    tailGearRatio = config->rpm_tail_gear_ratio / 100.0f;       // HF3D
 
     numberRpmNotchFilters = 0;
-    
-    // HF3D TODO:  Make all the RPM filter code work even if we weren't built with USE_DSHOT.
-    if (motorConfig()->dev.useDshotTelemetry) {
-        rpmSource = 0;
-    // HF3D TODO:  Add an RPM sensor input to the if chain once we support them
-    // The check below doesn't work because escSensorInit() isn't called until after rpmFilterInit
-    //} else if (isEscSensorActive()) {
-    } else if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
-        rpmSource = 2;
-    } else {
+
+    // HF3D:  Per-motor RPM source, pole count and gear ratio
+    const float tailGearRatio = config->rpm_tail_gear_ratio / 100.0f;
+    rpmSourceAvailable = false;
+
+    for (int motor = 0; motor < getMotorCount(); motor++) {
+        // HF3D TODO:  Make all the RPM filter code work even if we weren't built with USE_DSHOT.
+        // HF3D TODO:  Add an RPM sensor input once we support them
+        // The isEscSensorActive() check doesn't work because escSensorInit() isn't called until after rpmFilterInit
+        const bool dshotAvailable = motorConfig()->dev.useDshotTelemetry;
+        const bool escSensorAvailable = featureIsEnabled(FEATURE_ESC_SENSOR);
+
+        switch (motorConfig()->motorRpmSource[motor]) {
+        case RPM_SOURCE_AUTO:
+            rpmSource[motor] = dshotAvailable ? RPM_SOURCE_DSHOT_TELEMETRY : escSensorAvailable ? RPM_SOURCE_ESC_SENSOR : RPM_SOURCE_NONE;
+            break;
+        case RPM_SOURCE_DSHOT_TELEMETRY:
+            rpmSource[motor] = dshotAvailable ? RPM_SOURCE_DSHOT_TELEMETRY : RPM_SOURCE_NONE;
+            break;
+        case RPM_SOURCE_ESC_SENSOR:
+            rpmSource[motor] = escSensorAvailable ? RPM_SOURCE_ESC_SENSOR : RPM_SOURCE_NONE;
+            break;
+        default:
+            rpmSource[motor] = RPM_SOURCE_NONE;
+            break;
+        }
+        if (rpmSource[motor] != RPM_SOURCE_NONE) {
+            rpmSourceAvailable = true;
+        }
+
+        const float gearRatio = motorConfig()->motorGearRatio[motor] / 100.0f;
+        erpmToHz[motor] = ERPM_PER_LSB / SECONDS_PER_MINUTE / (motorConfig()->motorPoleCount[motor] / 2.0f);
+        erpmToRotorHz[motor] = erpmToHz[motor] / gearRatio;
+
+        // HF3D:  The rotor blades cause the main vibrations, so the first set of harmonics is always the rotor frequency
+        //   Note that the main vibrations to filter out will be at headspeed * #_of_blades (essentially 2nd or 3rd harmonic)
+        harmonicSets[motor] = 0;
+        harmonicRatio[motor][harmonicSets[motor]++] = 1.0f;
+        // Geared motor adds its own harmonics
+        if (gearRatio > 1.1f) {
+            harmonicRatio[motor][harmonicSets[motor]++] = gearRatio;
+        }
+        // Tail rotor driven from the main shaft
+        if (motor == 0 && tailGearRatio > 0) {
+            harmonicRatio[motor][harmonicSets[motor]++] = tailGearRatio;
+        }
+    }
+
+    if (!rpmSourceAvailable) {
         // No RPM source available
-        rpmSource = 255;
         gyroFilter = dtermFilter = NULL;
         return;
     }
@@ -210,14 +240,7 @@ void rpmFilterInit(const rpmFilterConfig_t *config)
         pt1FilterInit(&rpmFilters[i], pt1FilterGain(config->rpm_lpf, pidLooptime * 1e-6f));
     }
 
-    // HF3D TODO:  Change erpmToHz and motorPoleCount to array (and update cli/configurator) to allow for 2 different motors (main and tail)
-    //  For now this will only be used by the main motor (motor[0])
-    erpmToHz = ERPM_PER_LSB / SECONDS_PER_MINUTE  / (motorConfig()->motorPoleCount / 2.0f);
-    //  Tail motor (motor[1]) erpmToHz for OMP M2 tail motor (12 bell magnets):
-    erpmToHz1 = ERPM_PER_LSB / SECONDS_PER_MINUTE  / (12.0f / 2.0f);
-
     const float loopIterationsPerUpdate = MIN_UPDATE_T / (pidLooptime * 1e-6f);
-    // HF3D TODO:  May need to fix this numberFilters count and filter init for a geared main motor + motor-driven tail combo
     numberFilters = getMotorCount() * (filters[0].harmonics + filters[1].harmonics);
     const float filtersPerLoopIteration = numberFilters / loopIterationsPerUpdate;
     filterUpdatesPerIteration = rintf(filtersPerLoopIteration + 0.49f);
@@ -236,7 +259,7 @@ static float applyFilter(rpmNotchFilter_t* filter, int axis, float value)
         // Loop over and apply each set of gyro or dterm filters created for this axis and motor.  
         //   Default is 3 harmonic filters per motor for each axis
         //   Filter center frequency is updated separately in rpmFilterUpdate()
-        for (int i = 0; i < filter->harmonics; i++) {
+        for (int i = 0; i < filter->motorHarmonics[motor]; i++) {
             value = biquadFilterApplyDF1(&filter->notch[axis][motor][i], value);
         }
     }
@@ -265,20 +288,24 @@ FAST_RAM_ZERO_INIT static float motorFrequency[MAX_SUPPORTED_MOTORS];
 //   Updates filter coefficients for the new motor rpm
 FAST_CODE_NOINLINE void rpmFilterUpdate()
 {
-    // Don't calculate any filter updates if we're not doing any filtering.
-    if (gyroFilter == NULL && dtermFilter == NULL) {
+    // HF3D:  Motor RPM is also used by the governor, so keep it updated even without any notch filters
+    if (!rpmSourceAvailable) {
         return;
     }
 
     // Loop over all the motors and low-pass filter their RPM values to stabilize it
     for (int motor = 0; motor < getMotorCount(); motor++) {
         // Get the motor eRPM using bi-directional DSHOT and then filter it using PT1 low-pass filter
+        // HF3D:  Telemetry is only refreshed every few PID loops (ESC sensor at ~100Hz), so also take the count of frames received.
+        //   A new frame with the same quantised eRPM is still a fresh sample.
         uint16_t motorRpm = 0;
-        if (rpmSource == 0) {
+        if (rpmSource[motor] == RPM_SOURCE_DSHOT_TELEMETRY) {
             motorRpm = getDshotTelemetry(motor);
+            motorErpmSamples[motor] = getDshotTelemetryUpdateCount(motor);
         // HF3D TODO:  Add support for RPM sensor to the if chain here once we support it.
-        } else if (rpmSource == 2) {
+        } else if (rpmSource[motor] == RPM_SOURCE_ESC_SENSOR) {
             motorRpm = getEscSensorRPM(motor);
+            motorErpmSamples[motor] = getEscSensorFrameCount(motor);
         } else {
             motorRpm = 0;
         }
@@ -288,26 +315,19 @@ FAST_CODE_NOINLINE void rpmFilterUpdate()
         }
     }
 
+    // Don't calculate any filter updates if we're not doing any filtering.
+    if (gyroFilter == NULL && dtermFilter == NULL) {
+        return;
+    }
+
     // Implement a simple load balancer that splits the filter updates up so that they update their frequency over the space of ~1ms.
     for (int i = 0; i < filterUpdatesPerIteration; i++) {
         // Calculate the frequency of the harmonic we're updating.  Harmonic 0 = fundamental = 1*frequency
-        float frequency = 0.0f;
-        int workingHarmonic = currentHarmonic % currentFilter->harmonicsPerFreq;
-        // Figure out if we're on a head, main, or tail harmonic
-        if (currentHarmonic < currentFilter->harmonicsPerFreq) {
-            // First set of harmonics are always headspeed
-            frequency = constrainf(
-            (workingHarmonic + 1) * motorFrequency[currentMotor], currentFilter->minHz, currentFilter->maxHz);            
-        } else if (currentHarmonic / currentFilter->harmonicsPerFreq == 1) {
-            // Calculate main motor frequency using headspeed
-            // HF3D TODO:  Kind of inefficient right now how we're using mainGearRatio to calculate headspeed and then undoing it here?
-            frequency = constrainf(
-            (workingHarmonic + 1) * motorFrequency[currentMotor] * mixerGetGovGearRatio(), currentFilter->minHz, currentFilter->maxHz);
-        } else if (currentHarmonic / currentFilter->harmonicsPerFreq == 2) {
-            // Calculate tail frequency using headspeed
-            frequency = constrainf(
-            (workingHarmonic + 1) * motorFrequency[currentMotor] * tailGearRatio, currentFilter->minHz, currentFilter->maxHz);            
-        }
+        // HF3D:  motorFrequency is the rotor frequency, each harmonic set is a multiple of it (rotor, geared motor, belt driven tail)
+        const int workingHarmonic = currentHarmonic % currentFilter->harmonicsPerFreq;
+        const int harmonicSet = currentHarmonic / currentFilter->harmonicsPerFreq;
+        const float frequency = constrainf(
+            (workingHarmonic + 1) * motorFrequency[currentMotor] * harmonicRatio[currentMotor][harmonicSet], currentFilter->minHz, currentFilter->maxHz);
         // Update the roll axis filter coefficients for this motor & harmonic
         biquadFilter_t* template = &currentFilter->notch[0][currentMotor][currentHarmonic];
         // uncomment below to debug filter stepping. Need to also comment out motor rpm DEBUG_SET above
@@ -337,16 +357,8 @@ FAST_CODE_NOINLINE void rpmFilterUpdate()
                 if (++currentMotor == getMotorCount()) {
                     currentMotor = 0;
                 }
-                // Update the speed of this motor.
-                // HF3D TODO:  Change erpmToHz to array to allow for 2 different motors (main and tail)
-                if (currentMotor == 1) {
-                    // Tail motor uses erpmToHz1
-                    motorFrequency[currentMotor] = erpmToHz1 * filteredMotorErpm[currentMotor];
-                } else {
-                    // HF3D:  The main blades/head will be causing the main vibrations, so use gearRatio to get headspeed
-                    // Note that the main vibrations to filter out will be at headspeed * #_of_blades (essentially 2nd or 3rd harmonic)
-                    motorFrequency[currentMotor] = erpmToHz * filteredMotorErpm[currentMotor] / mixerGetGovGearRatio();
-                }
+                // Update the rotor speed of this motor (headspeed for the main motor, tail rotor speed for a tail motor)
+                motorFrequency[currentMotor] = erpmToRotorHz[currentMotor] * filteredMotorErpm[currentMotor];
                 minMotorFrequency = 0.0f;
             }
             // Set the currentFilter to be the filter we just incremented to (or reset to)
@@ -359,7 +371,7 @@ FAST_CODE_NOINLINE void rpmFilterUpdate()
 
 bool isRpmFilterEnabled(void)
 {
-    return (rpmSource < 255 && (rpmFilterConfig()->gyro_rpm_notch_harmonics || rpmFilterConfig()->dterm_rpm_notch_harmonics));
+    return (rpmSourceAvailable && (rpmFilterConfig()->gyro_rpm_notch_harmonics || rpmFilterConfig()->dterm_rpm_notch_harmonics));
 }
 
 float rpmMinMotorFrequency()
@@ -378,12 +390,13 @@ float rpmMinMotorFrequency()
 // Return low pass filtered motor RPM for HF3D governor or tail motor control
 float rpmGetFilteredMotorRPM(int motor)
 {
-    // HF3D TODO:  Change erpmToHz to array to allow for 2 different motors (main and tail)
-    if (motor == 1) {
-        return (filteredMotorErpm[motor] * erpmToHz1 * SECONDS_PER_MINUTE);    // return filtered tail motor RPM
-    } else {
-        return (filteredMotorErpm[motor] * erpmToHz * SECONDS_PER_MINUTE);     // return filtered main/other motor RPM
-    }
+    return (filteredMotorErpm[motor] * erpmToHz[motor] * SECONDS_PER_MINUTE);
+}
+
+// Return the number of RPM telemetry frames received for the motor, used to detect fresh RPM data
+uint32_t rpmGetMotorSampleCount(int motor)
+{
+    return motorErpmSamples[motor];
 }
 
 #endif
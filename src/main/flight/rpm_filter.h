@@ -47,4 +47,5 @@ bool isRpmFilterEnabled(void);
 float rpmMinMotorFrequency();
 
 // Return motor RPM for HF3D governor or tail motor control
-float rpmGetFilteredMotorRPM(int motor);
\ No newline at end of file
+float rpmGetFilteredMotorRPM(int motor);
+uint32_t rpmGetMotorSampleCount(int motor);
@@ -0,0 +1,100 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/servo_calib.h"
+
+// Roll, pitch and collective of each step
+const int16_t servoCalibGrid[SERVO_CALIB_STEPS][SWASH_INPUT_COUNT] = {
+    {                    0,                    0,                    0 },
+    {                    0,                    0,  SERVO_CALIB_COMMAND },
+    {                    0,                    0, -SERVO_CALIB_COMMAND },
+    {  SERVO_CALIB_COMMAND,                    0,                    0 },
+    {                    0,  SERVO_CALIB_COMMAND,                    0 },
+};
+
+// Servo travel of the ideal swash for a grid step, with all servos at 100% rate and normal direction
+void servoCalibTravel(uint8_t swashType, const int16_t angle[SWASH_SERVO_COUNT], int step, float travel[SWASH_SERVO_COUNT])
+{
+    swashMixerInputs_t inputs;
+    memset(&inputs, 0, sizeof(inputs));
+
+    inputs.type = swashType;
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        inputs.angle[i] = angle[i];
+        inputs.rate[i] = 100;
+        for (int j = 0; j < SWASH_INPUT_COUNT; j++) {
+            inputs.direction[i][j] = 1;
+        }
+    }
+
+    swashMixer_t swash;
+    swashMixerBuild(&swash, &inputs);
+
+    const float input[SWASH_INPUT_COUNT] = {
+        servoCalibGrid[step][SWASH_INPUT_ROLL],
+        servoCalibGrid[step][SWASH_INPUT_PITCH],
+        servoCalibGrid[step][SWASH_INPUT_COLLECTIVE],
+    };
+    swashMixerApply(&swash, input, travel);
+}
+
+// Least squares line through the (travel, pulse) points.
+//   Fails if the servo didn't move over the grid.
+bool servoCalibSolve(const float *travel, const float *pulse, int count, servoCalibFit_t *fit)
+{
+    if (count < 2) {
+        return false;
+    }
+
+    float meanTravel = 0;
+    float meanPulse = 0;
+    for (int i = 0; i < count; i++) {
+        meanTravel += travel[i];
+        meanPulse += pulse[i];
+    }
+    meanTravel /= count;
+    meanPulse /= count;
+
+    float covariance = 0;
+    float variance = 0;
+    for (int i = 0; i < count; i++) {
+        covariance += (travel[i] - meanTravel) * (pulse[i] - meanPulse);
+        variance += sq(travel[i] - meanTravel);
+    }
+
+    if (variance < 1.0f) {
+        return false;
+    }
+
+    fit->scale = covariance / variance;
+    fit->middle = meanPulse - fit->scale * meanTravel;
+
+    return fabsf(fit->scale) > 0.01f;
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "flight/swash.h"
+
+// HF3D:  Swash servo calibration.
+//   The swash is stepped through a grid of collective and cyclic commands. At each step the user trims every
+//   swash servo until the swash sits where the step puts it (level at zero pitch for the first step, the
+//   gauge reading of the step for the others), and the trimmed pulses are recorded.
+//   A straight line fit of the recorded pulses against the servo travel of the ideal swash then gives the
+//   centre, the rate and the direction of each servo in one go.
+
+#define SERVO_CALIB_STEPS       5
+#define SERVO_CALIB_COMMAND     250         // grid step size, mixer command units
+
+typedef struct servoCalibFit_s {
+    float middle;                           // pulse at zero travel, us
+    float scale;                            // pulse per unit of travel, negative for a reversed servo
+} servoCalibFit_t;
+
+extern const int16_t servoCalibGrid[SERVO_CALIB_STEPS][SWASH_INPUT_COUNT];
+
+void servoCalibTravel(uint8_t swashType, const int16_t angle[SWASH_SERVO_COUNT], int step, float travel[SWASH_SERVO_COUNT]);
+bool servoCalibSolve(const float *travel, const float *pulse, int count, servoCalibFit_t *fit);
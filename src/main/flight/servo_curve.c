@@ -0,0 +1,76 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/servo_curve.h"
+
+static int16_t servoCurveLinearPoint(int index)
+{
+    return index * SERVO_CURVE_STEP - SERVO_CURVE_RANGE;
+}
+
+void servoCurveReset(servoCurve_t *curve)
+{
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        curve->point[i] = servoCurveLinearPoint(i);
+    }
+}
+
+// Curve for a servo arm that turns armAngle degrees either way at full command.
+//   The ball link height is sin(servo angle), so for a linear link height the servo angle must be
+//   asin(command * sin(armAngle)). The end points are unchanged.
+void servoCurveGenerateArm(servoCurve_t *curve, float armAngle)
+{
+    if (armAngle <= 0) {
+        servoCurveReset(curve);
+        return;
+    }
+
+    const float maxAngle = MIN(armAngle, SERVO_CURVE_ARM_ANGLE_MAX) * RAD;
+    const float sinMaxAngle = sinf(maxAngle);
+
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        const float command = (float)servoCurveLinearPoint(i) / SERVO_CURVE_RANGE;
+        curve->point[i] = lrintf(SERVO_CURVE_RANGE * asinf(command * sinMaxAngle) / maxAngle);
+    }
+}
+
+void servoCurveBuild(servoCurveTable_t *table, const servoCurve_t *curve)
+{
+    table->active = false;
+
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        table->point[i] = curve->point[i];
+        if (curve->point[i] != servoCurveLinearPoint(i)) {
+            table->active = true;
+        }
+    }
+
+    for (int i = 0; i < SERVO_CURVE_POINTS - 1; i++) {
+        table->slope[i] = table->point[i + 1] - table->point[i];
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HF3D:  Servo linearisation curves.
+//   The servo arm turns the linear servo command into a rotation, so the ball link (and the blade pitch) moves
+//   with the sine of the servo angle and flattens out towards the ends of the travel.
+//   Each servo has a curve of output pulse offsets at equally spaced command offsets from the servo middle,
+//   so the segment is found with a multiply instead of a search.
+
+#define SERVO_CURVE_POINTS      9
+#define SERVO_CURVE_RANGE       500         // command offset of the first and last point, us
+#define SERVO_CURVE_STEP        (2 * SERVO_CURVE_RANGE / (SERVO_CURVE_POINTS - 1))
+
+#define SERVO_CURVE_POINT_MAX       1000    // largest output offset of a point, us
+#define SERVO_CURVE_ARM_ANGLE_MAX   80      // maximum arm angle at full command for a generated curve, degrees
+
+typedef struct servoCurve_s {
+    int16_t point[SERVO_CURVE_POINTS];      // output offset at -SERVO_CURVE_RANGE ... +SERVO_CURVE_RANGE, us
+} servoCurve_t;
+
+typedef struct servoCurveTable_s {
+    bool active;                            // false for a straight line, the curve can be skipped
+    float point[SERVO_CURVE_POINTS];
+    float slope[SERVO_CURVE_POINTS - 1];    // output change per step
+} servoCurveTable_t;
+
+void servoCurveReset(servoCurve_t *curve);
+void servoCurveGenerateArm(servoCurve_t *curve, float armAngle);
+void servoCurveBuild(servoCurveTable_t *table, const servoCurve_t *curve);
+
+static inline float servoCurveApply(const servoCurveTable_t *table, float offset)
+{
+    const float pos = (offset + SERVO_CURVE_RANGE) * (1.0f / SERVO_CURVE_STEP);
+    int i = (int)pos;
+    i = (i < 0) ? 0 : (i > SERVO_CURVE_POINTS - 2) ? SERVO_CURVE_POINTS - 2 : i;
+
+    // Beyond the end points the end segments are extended
+    return table->point[i] + (pos - i) * table->slope[i];
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/servo_slew.h"
+
+void servoSlewInit(servoSlew_t *slew, uint16_t rateLimit, uint16_t accelLimit)
+{
+    slew->rateLimit = rateLimit;
+    slew->accelLimit = accelLimit * SERVO_SLEW_ACCEL_UNIT;
+}
+
+float servoSlewApply(servoSlew_t *slew, float target, float dt)
+{
+    if (!slew->initialised || dt <= 0) {
+        slew->initialised = true;
+        slew->position = target;
+        slew->velocity = 0;
+        return target;
+    }
+
+    const float error = target - slew->position;
+
+    // Speed that reaches the target in this step
+    float velocity = error / dt;
+
+    if (slew->rateLimit > 0) {
+        velocity = constrainf(velocity, -slew->rateLimit, slew->rateLimit);
+    }
+
+    if (slew->accelLimit > 0) {
+        // Fastest speed the servo can still stop from at the target, braking in steps of dt
+        const float maxChange = slew->accelLimit * dt;
+        const float stopVelocity = sqrtf(2.0f * slew->accelLimit * fabsf(error) + sq(maxChange / 2)) - maxChange / 2;
+        velocity = constrainf(velocity, -stopVelocity, stopVelocity);
+        velocity = constrainf(velocity, slew->velocity - maxChange, slew->velocity + maxChange);
+
+        // Never move past the target
+        if (velocity * error > 0 && fabsf(velocity * dt) > fabsf(error)) {
+            velocity = error / dt;
+        }
+    }
+
+    slew->velocity = velocity;
+    slew->position += velocity * dt;
+
+    return slew->position;
+}
+
+bool servoSlewIsSaturated(const servoSlew_t *slew, float target)
+{
+    return fabsf(target - slew->position) > SERVO_SLEW_SATURATION;
+}
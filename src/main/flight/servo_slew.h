@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HF3D:  Servo speed and acceleration model.
+//   The servo command follows the mixer output no faster than the servo can physically move, so that the
+//   PID controller can be told when the servos can't keep up. Everything is in real time units, so the
+//   result doesn't depend on the loop or servo update rate.
+
+#define SERVO_SLEW_ACCEL_UNIT       1000.0f     // servo_accel_limit unit, us/s^2
+#define SERVO_SLEW_SATURATION       2.0f        // command behind the target by more than this is saturated, us
+
+typedef struct servoSlew_s {
+    float rateLimit;            // us/s, 0 = unlimited
+    float accelLimit;           // us/s^2, 0 = unlimited
+    bool initialised;
+    float position;             // us
+    float velocity;             // us/s
+} servoSlew_t;
+
+void servoSlewInit(servoSlew_t *slew, uint16_t rateLimit, uint16_t accelLimit);
+float servoSlewApply(servoSlew_t *slew, float target, float dt);
+bool servoSlewIsSaturated(const servoSlew_t *slew, float target);
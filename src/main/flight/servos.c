@@ -28,6 +28,7 @@
 #ifdef USE_SERVOS
 
 #include "build/build_config.h"
+#include "build/debug.h"
 
 #include "common/filter.h"
 #include "common/maths.h"
@@ -37,11 +38,13 @@
 #include "config/feature.h"
 
 #include "drivers/pwm_output.h"
+#include "drivers/time.h"
 
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
+#include "flight/actuator_log.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
@@ -56,7 +59,7 @@
 #include "rx/rx.h"
 
 
-PG_REGISTER_WITH_RESET_FN(servoConfig_t, servoConfig, PG_SERVO_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(servoConfig_t, servoConfig, PG_SERVO_CONFIG, 7);
 
 void pgResetFn_servoConfig(servoConfig_t *servoConfig)
 {
@@ -65,6 +68,19 @@ void pgResetFn_servoConfig(servoConfig_t *servoConfig)
     servoConfig->tri_unarmed_servo = 1;
     servoConfig->servo_lowpass_freq = 0;
     servoConfig->channelForwardingStartChannel = AUX1;
+    servoConfig->swash_type = SWASH_TYPE_120;
+    servoConfig->swash_servo_angle[SERVO_HELI_LEFT] = 240;
+    servoConfig->swash_servo_angle[SERVO_HELI_RIGHT] = 120;
+    servoConfig->swash_servo_angle[SERVO_HELI_TOP] = 0;
+    servoConfig->swash_ring_mode = SWASH_RING_CIRCULAR;
+    for (int i = 0; i < SWASH_RING_LIMIT_COUNT; i++) {
+        servoConfig->swash_ring_limit[i] = 100;
+    }
+    servoCurveReset(&servoConfig->collective_curve);
+    servoConfig->collective_min = -COLLECTIVE_RANGE;
+    servoConfig->collective_max = COLLECTIVE_RANGE;
+    servoConfig->collective_stall_limit = 0;
+    servoConfig->collective_stall_headspeed = 0;
 
     for (unsigned servoIndex = 0; servoIndex < MAX_SUPPORTED_SERVOS; servoIndex++) {
         servoConfig->dev.ioTags[servoIndex] = timerioTagGetByUsage(TIM_USE_SERVO, servoIndex);
@@ -88,6 +104,15 @@ void pgResetFn_servoParams(servoParam_t *instance)
     }
 }
 
+PG_REGISTER_ARRAY_WITH_RESET_FN(servoCurve_t, MAX_SUPPORTED_SERVOS, servoCurves, PG_SERVO_CURVE, 0);
+
+void pgResetFn_servoCurves(servoCurve_t *instance)
+{
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servoCurveReset(&instance[i]);
+    }
+}
+
 // no template required since default is zero
 PG_REGISTER(gimbalConfig_t, gimbalConfig, PG_GIMBAL_CONFIG, 0);
 
@@ -219,6 +244,61 @@ int servoDirection(int servoIndex, int inputSource)
     }
 }
 
+// HF3D:  Servos written by writeServos() for the mixer mode, the ones the filter and the slew limit run on
+static uint32_t servoMixerOutputs;
+
+static uint32_t servosGetMixerOutputs(void)
+{
+    uint32_t outputs = 0;
+
+    switch (getMixerMode()) {
+    case MIXER_TRI:
+    case MIXER_CUSTOM_TRI:
+        outputs = (1 << SERVO_RUDDER);
+        break;
+
+    case MIXER_FLYING_WING:
+        outputs = (1 << SERVO_FLAPPERON_1) | (1 << SERVO_FLAPPERON_2);
+        break;
+
+    case MIXER_CUSTOM_AIRPLANE:
+    case MIXER_AIRPLANE:
+        for (int i = SERVO_PLANE_INDEX_MIN; i <= SERVO_PLANE_INDEX_MAX; i++) {
+            outputs |= (1 << i);
+        }
+        break;
+
+#ifdef USE_UNCOMMON_MIXERS
+    case MIXER_BICOPTER:
+        outputs = (1 << SERVO_BICOPTER_LEFT) | (1 << SERVO_BICOPTER_RIGHT);
+        break;
+
+    case MIXER_HELI_120_CCPM:
+        outputs = (1 << SERVO_HELI_LEFT) | (1 << SERVO_HELI_RIGHT) | (1 << SERVO_HELI_TOP) | (1 << SERVO_HELI_RUD);
+        break;
+
+    case MIXER_DUALCOPTER:
+        outputs = (1 << SERVO_DUALCOPTER_LEFT) | (1 << SERVO_DUALCOPTER_RIGHT);
+        break;
+
+    case MIXER_SINGLECOPTER:
+        for (int i = SERVO_SINGLECOPTER_INDEX_MIN; i <= SERVO_SINGLECOPTER_INDEX_MAX; i++) {
+            outputs |= (1 << i);
+        }
+        break;
+#endif // USE_UNCOMMON_MIXERS
+
+    default:
+        break;
+    }
+
+    if (featureIsEnabled(FEATURE_SERVO_TILT) || getMixerMode() == MIXER_GIMBAL) {
+        outputs |= (1 << SERVO_GIMBAL_PITCH) | (1 << SERVO_GIMBAL_ROLL);
+    }
+
+    return outputs;
+}
+
 void servosInit(void)
 {
     // Reset servo position override
@@ -244,6 +324,30 @@ void servosInit(void)
     if (mixerIsTricopter()) {
         servosTricopterInit();
     }
+
+    servoMixerOutputs = servosGetMixerOutputs();
+
+    servosCurveInit();
+}
+
+// HF3D:  Servo linearisation curves, see servo_curve.h
+static servoCurveTable_t servoCurveTable[MAX_SUPPORTED_SERVOS];
+
+void servosCurveInit(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servoCurveBuild(&servoCurveTable[i], servoCurves(i));
+    }
+}
+
+static void servosApplyCurves(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        if (servoCurveTable[i].active) {
+            const int16_t middle = servoParams(i)->middle;
+            servo[i] = lrintf(servoCurveApply(&servoCurveTable[i], servo[i] - middle)) + middle;
+        }
+    }
 }
 
 void loadCustomServoMixer(void)
@@ -314,9 +418,15 @@ static uint32_t servoWritten;
 
 STATIC_ASSERT(sizeof(servoWritten) * 8 >= MAX_SUPPORTED_SERVOS, servoWritten_is_too_small);
 
+// HF3D:  The mixer works in standard pulse widths, narrow band servos get the pulse scaled down only on output
+static uint16_t servoOutputPulse(int servoname)
+{
+    return servoConfig()->servo_narrow_band[servoname] ? servo[servoname] / SERVO_NARROW_BAND_DIV : servo[servoname];
+}
+
 static void writeServoWithTracking(uint8_t index, servoIndex_e servoname)
 {
-    pwmWriteServo(index, servo[servoname]);
+    pwmWriteServo(index, servoOutputPulse(servoname));
     servoWritten |= (1 << servoname);
 }
 
@@ -326,13 +436,91 @@ static void updateGimbalServos(uint8_t firstServoIndex)
     writeServoWithTracking(firstServoIndex + 1, SERVO_GIMBAL_ROLL);
 }
 
+// HF3D:  Servo output decimation.
+//   Servos only take a new position every servo frame, so the mixer and the outputs run at the servo frame rate
+//   instead of every PID loop. The fast changing inputs (PID sums and the interpolated collective) are averaged
+//   over the frame in between, which is a boxcar decimation filter with nulls at the frame rate and its harmonics.
+#define SERVO_DECIMATED_INPUT_COUNT 4
+
+static const uint8_t servoDecimatedInputs[SERVO_DECIMATED_INPUT_COUNT] = {
+    INPUT_STABILIZED_ROLL, INPUT_STABILIZED_PITCH, INPUT_STABILIZED_YAW, INPUT_RC_AUX1
+};
+
+static FAST_RAM_ZERO_INIT uint8_t servoLoopDenom;
+static FAST_RAM_ZERO_INIT uint8_t servoLoopCount;
+static FAST_RAM_ZERO_INIT float servoInputSum[SERVO_DECIMATED_INPUT_COUNT];
+
+static void servosAccumulateInputs(void)
+{
+    float input[SERVO_DECIMATED_INPUT_COUNT];
+
+    if (FLIGHT_MODE(PASSTHRU_MODE)) {
+        // Direct passthru from RX
+        input[0] = rcCommand[ROLL];
+        input[1] = rcCommand[PITCH];
+        input[2] = rcCommand[YAW];
+    } else {
+        // Assisted modes (gyro only or gyro+acc according to flight mode / AUX switch configuration)
+        // Default PID_SERVO_MIXER_SCALING = 0.7f
+        // HF3D TODO:  Consider using yawPidSumLimit like mixer.c does for motors?
+        //  * Already added roll/pitch pidSumLimit to this code.
+        //    Default pidSumLimit is 500 on roll/pitch and 400 on yaw, with min/max settable range of 100-1000
+        input[0] = constrainf(pidData[FD_ROLL].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * PID_SERVO_MIXER_SCALING;
+        input[1] = constrainf(pidData[FD_PITCH].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * PID_SERVO_MIXER_SCALING;
+        input[2] = pidData[FD_YAW].Sum * PID_SERVO_MIXER_SCALING;
+
+        // Reverse yaw servo when inverted in 3D mode (Betaflight code meant for FPV)
+        // HF3D:  LOL - Remove this in case somebody enables the 3D mode.  It would kind of be hilarious though.
+        if (featureIsEnabled(FEATURE_3D) && (rcData[THROTTLE] < rxConfig()->midrc)) {
+            input[2] *= -1;
+        }
+    }
+    input[3] = rcCommand[COLLECTIVE];                   // HF3D: Updated to use interpolated rcCommand[COLLECTIVE] value
+
+    for (int i = 0; i < SERVO_DECIMATED_INPUT_COUNT; i++) {
+        servoInputSum[i] += input[i];
+    }
+}
+
+static void servosGetAveragedInputs(float *input)
+{
+    const float scale = (servoLoopCount > 0) ? 1.0f / servoLoopCount : 0.0f;
+
+    for (int i = 0; i < SERVO_DECIMATED_INPUT_COUNT; i++) {
+        input[servoDecimatedInputs[i]] = servoInputSum[i] * scale;
+    }
+}
+
 static void servoTable(void);
 static void filterServos(void);
+static void slewServos(void);
+
+static uint32_t servoClamped;               // HF3D:  servos at min or max, bit per servo
+static uint32_t servoSaturated;             // HF3D:  servos behind their rate limit, bit per servo
+
+#ifdef USE_ACTUATOR_LOG
+static void servosLogActuators(void);
+#endif
 
 void writeServos(void)
 {
+    servosAccumulateInputs();
+
+    if (++servoLoopCount < servoLoopDenom) {
+        return;
+    }
+
     servoTable();
     filterServos();
+    slewServos();
+#ifdef USE_ACTUATOR_LOG
+    servosLogActuators();
+#endif
+
+    servoLoopCount = 0;
+    for (int i = 0; i < SERVO_DECIMATED_INPUT_COUNT; i++) {
+        servoInputSum[i] = 0;
+    }
 
     uint8_t servoIndex = 0;
     switch (getMixerMode()) {
@@ -396,7 +584,7 @@ void writeServos(void)
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
         const uint8_t channelToForwardFrom = servoParams(i)->forwardFromChannel;
         if ((channelToForwardFrom != CHANNEL_FORWARDING_DISABLED) && !(servoWritten & (1 << i))) {
-            pwmWriteServo(servoIndex++, servo[i]);
+            pwmWriteServo(servoIndex++, servoOutputPulse(i));
         }
     }
 
@@ -407,36 +595,154 @@ void writeServos(void)
     }
 }
 
-int32_t swashRingTotal = 0;
+static swashRing_t swashRing;
+static float swashRingValue = 0;
+static swashPhase_t swashPhase;
+
+// HF3D:  Native swashplate mixer, replaces the smix rules on the heli mixer
+static swashMixer_t swashMixer;
+static bool swashMixerValid;
+static float swashTailScale;
+static swashLoadComp_t swashLoadComp;
+
+static bool servosUseSwashMixer(void)
+{
+    return getMixerMode() == MIXER_HELI_120_CCPM && servoConfig()->swash_type != SWASH_TYPE_SMIX;
+}
+
+// Rebuild the mixing matrix when the swash config, the servo directions or the servo rates have changed
+static void servosUpdateSwashMixer(void)
+{
+    static const uint8_t swashInputSource[SWASH_INPUT_COUNT] = {
+        [SWASH_INPUT_ROLL] = INPUT_STABILIZED_ROLL,
+        [SWASH_INPUT_PITCH] = INPUT_STABILIZED_PITCH,
+        [SWASH_INPUT_COLLECTIVE] = INPUT_RC_AUX1,
+    };
+
+    swashMixerInputs_t inputs;
+    memset(&inputs, 0, sizeof(inputs));
+
+    inputs.type = servoConfig()->swash_type;
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        inputs.angle[i] = servoConfig()->swash_servo_angle[i];
+        inputs.rate[i] = servoParams(i)->rate;
+        for (int j = 0; j < SWASH_INPUT_COUNT; j++) {
+            inputs.direction[i][j] = servoDirection(i, swashInputSource[j]);
+        }
+    }
+
+    if (!swashMixerValid || memcmp(&inputs, &swashMixer.inputs, sizeof(inputs)) != 0) {
+        swashMixerBuild(&swashMixer, &inputs);
+        swashMixerValid = true;
+    }
+
+    swashTailScale = servoDirection(SERVO_HELI_RUD, INPUT_STABILIZED_YAW) * servoParams(SERVO_HELI_RUD)->rate / 100.0f;
+}
+
+// HF3D:  Swash servos from the mixing matrix, tail servo straight from yaw.
+//   The servo direction and rate are already in the matrix, and there's no integer truncation of the inputs or per-rule limits.
+static void servosSwashMixer(const float *input)
+{
+    if (!swashMixerValid || !ARMING_FLAG(ARMED)) {
+        servosUpdateSwashMixer();
+    }
+
+    const float swashInput[SWASH_INPUT_COUNT] = {
+        [SWASH_INPUT_ROLL] = input[INPUT_STABILIZED_ROLL],
+        [SWASH_INPUT_PITCH] = input[INPUT_STABILIZED_PITCH],
+        [SWASH_INPUT_COLLECTIVE] = input[INPUT_RC_AUX1],
+    };
+    float swashOutput[SWASH_SERVO_COUNT];
+
+    swashMixerApply(&swashMixer, swashInput, swashOutput);
+
+    // HF3D:  Servo load precompensation, rebuilt with the ring
+    if (swashLoadComp.enabled) {
+        float offset[SWASH_SERVO_COUNT];
+        swashLoadCompApply(&swashLoadComp, swashInput[SWASH_INPUT_ROLL], swashInput[SWASH_INPUT_PITCH], offset);
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            swashOutput[i] += offset[i];
+            DEBUG_SET(DEBUG_SWASH_LOAD, i, lrintf(offset[i]));
+        }
+    }
+
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servo[i] = determineServoMiddleOrForwardFromChannel(i);
+    }
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        servo[i] += lrintf(swashOutput[i]);
+    }
+    servo[SERVO_HELI_RUD] += lrintf(input[INPUT_STABILIZED_YAW] * swashTailScale);
+}
+
+// HF3D:  Swash phase angle, from the headspeed between the low headspeed point and full headspeed.
+//   The sin/cos are only recalculated when the angle changes by 0.1 degree or more.
+static void servosUpdateSwashPhase(void)
+{
+    int16_t angle = servoConfig()->swash_phase;
+
+    const float lowHeadspeed = servoConfig()->swash_phase_low_headspeed * mixerConfig()->gov_max_headspeed / 100.0f;
+    const float fullHeadspeed = mixerConfig()->gov_max_headspeed;
+    const float headspeed = mixerGetHeadspeed();
+
+    if (lowHeadspeed > 0 && lowHeadspeed < fullHeadspeed && headspeed > 0) {
+        const float ratio = constrainf((headspeed - lowHeadspeed) / (fullHeadspeed - lowHeadspeed), 0, 1);
+        angle = lrintf(servoConfig()->swash_phase_low + ratio * (servoConfig()->swash_phase - servoConfig()->swash_phase_low));
+    }
+
+    if (angle != swashPhase.angle) {
+        swashPhaseInit(&swashPhase, angle);
+    }
+}
+
+// HF3D:  Collective curve and limits.
+//   The curve is baked into a lookup table with the servo curve code and rebuilt only while disarmed.
+#define COLLECTIVE_STALL_LIMIT_MIN  0.5f    // stall limit left at zero headspeed, fraction
+
+static servoCurveTable_t collectiveCurve;
+static bool collectiveCurveValid;
+
+static void servosCollectiveCurve(float *collective)
+{
+    if (!collectiveCurveValid || !ARMING_FLAG(ARMED)) {
+        servoCurveBuild(&collectiveCurve, &servoConfig()->collective_curve);
+        collectiveCurveValid = true;
+    }
+
+    float value = *collective;
+    if (collectiveCurve.active) {
+        value = servoCurveApply(&collectiveCurve, constrainf(value, -COLLECTIVE_RANGE, COLLECTIVE_RANGE));
+    }
+
+    *collective = constrainf(value, servoConfig()->collective_min, servoConfig()->collective_max);
+}
+
+// Total blade pitch limit, lowered with the headspeed so that a bogged down rotor isn't loaded any further
+static void servosCollectiveStallLimit(float *input)
+{
+    float limit = servoConfig()->collective_stall_limit;
+    if (limit <= 0) {
+        return;
+    }
+
+    const float stallHeadspeed = servoConfig()->collective_stall_headspeed * mixerConfig()->gov_max_headspeed / 100.0f;
+    const float headspeed = mixerGetHeadspeed();
+    if (stallHeadspeed > 0 && headspeed > 0) {
+        limit *= constrainf(headspeed / stallHeadspeed, COLLECTIVE_STALL_LIMIT_MIN, 1.0f);
+    }
+
+    swashStallLimitApply(limit, &input[INPUT_STABILIZED_ROLL], &input[INPUT_STABILIZED_PITCH], &input[INPUT_RC_AUX1]);
+}
 
 // Generic servo mixing from Cleanflight using user-defined smix values for each servo
 void servoMixer(void)
 {
-    int16_t input[INPUT_SOURCE_COUNT];    // Range [-500:+500]
+    float input[INPUT_SOURCE_COUNT];    // Range [-500:+500]
     static int16_t currentOutput[MAX_SERVO_RULES];
 
-    if (FLIGHT_MODE(PASSTHRU_MODE)) {
-        // Direct passthru from RX
-        input[INPUT_STABILIZED_ROLL] = rcCommand[ROLL];
-        input[INPUT_STABILIZED_PITCH] = rcCommand[PITCH];
-        input[INPUT_STABILIZED_YAW] = rcCommand[YAW];
-    } else {
-        // Assisted modes (gyro only or gyro+acc according to flight mode / AUX switch configuration)
-        // Default PID_SERVO_MIXER_SCALING = 0.7f
-        // HF3D TODO:  Consider using yawPidSumLimit like mixer.c does for motors?
-        //  * Already added roll/pitch pidSumLimit to this code.
-        //    Default pidSumLimit is 500 on roll/pitch and 400 on yaw, with min/max settable range of 100-1000
-        input[INPUT_STABILIZED_ROLL] = constrainf(pidData[FD_ROLL].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * PID_SERVO_MIXER_SCALING;
-        input[INPUT_STABILIZED_PITCH] = constrainf(pidData[FD_PITCH].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * PID_SERVO_MIXER_SCALING;
-        input[INPUT_STABILIZED_YAW] = pidData[FD_YAW].Sum * PID_SERVO_MIXER_SCALING;
+    // HF3D:  Stabilised inputs averaged over the servo frame, see servosAccumulateInputs()
+    servosGetAveragedInputs(input);
 
-        // Reverse yaw servo when inverted in 3D mode (Betaflight code meant for FPV)
-        // HF3D:  LOL - Remove this in case somebody enables the 3D mode.  It would kind of be hilarious though.
-        if (featureIsEnabled(FEATURE_3D) && (rcData[THROTTLE] < rxConfig()->midrc)) {
-            input[INPUT_STABILIZED_YAW] *= -1;
-        }
-    }
-    
     input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
     input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
 
@@ -452,7 +758,6 @@ void servoMixer(void)
     input[INPUT_RC_PITCH]    = rcData[PITCH]    - rxConfig()->midrc;
     input[INPUT_RC_YAW]      = rcData[YAW]      - rxConfig()->midrc;
     input[INPUT_RC_THROTTLE] = rcData[THROTTLE] - rxConfig()->midrc;
-    input[INPUT_RC_AUX1]     = rcCommand[COLLECTIVE];                   // HF3D: Updated to use interpolated rcCommand[COLLECTIVE] value
     input[INPUT_RC_AUX2]     = rcData[AUX2]     - rxConfig()->midrc;
     input[INPUT_RC_AUX3]     = rcData[AUX3]     - rxConfig()->midrc;
     input[INPUT_RC_AUX4]     = rcData[AUX4]     - rxConfig()->midrc;
@@ -462,27 +767,33 @@ void servoMixer(void)
         servo[i] = 0;
     }
 
-    // HF3D TODO:  Implement collective max/min limit settings and then scale the input RC command to those limits.
+    // HF3D:  Collective curve and min/max limits
+    servosCollectiveCurve(&input[INPUT_RC_AUX1]);
 
-    // HF3D TODO:  Does swash ring need to be implemented on the rcCommand side also for roll & pitch?
-    //          Or does that just sort of happen by default when it's implemented on the back-end like this?
+    // HF3D:  Rotate the cyclic for the head phase lag.
+    //   Done before the swash ring, so the per-direction ring limits apply to the physical swash tilt.
+    servosUpdateSwashPhase();
+    if (swashPhase.enabled) {
+        swashPhaseApply(&swashPhase, &input[INPUT_STABILIZED_ROLL], &input[INPUT_STABILIZED_PITCH]);
+    }
 
     // HF3D:  Swash ring (cyclic ring) functionality and maximum swash tilt limiting (maximum cyclic pitch)
     //   Without swash ring a full corner cyclic stick deflection would result in up to 141% of the maximum tilt in a single axis
-    //   Default pidSum limit = 500 * 0.7 scale factor = 350 for each of roll and pitch
-    //   Combined output for both axis = sqrt(350^2+350^2) = 495 for the maximum roll+pitch command from the pid loop.  
-    //   Divide each by the combined total to scale them down such that the total combined cyclic command equals the max in one axis.
-    swashRingTotal = sqrt(input[INPUT_STABILIZED_ROLL]*input[INPUT_STABILIZED_ROLL] + input[INPUT_STABILIZED_PITCH]*input[INPUT_STABILIZED_PITCH]);
-    
-    // Check if swashRingTotal combination exceeds the maximum possible deflection in any one direction
-    // HF3D TODO:  Be very cautious of increasing PID_SERVO_MIXER_SCALING in the future code!!  
+    //   Default pidSum limit = 500 * 0.7 scale factor = 350 for each of roll and pitch, which is the 100% ring size.
+    //   The cyclic vector is scaled back onto the ring keeping its direction, see swashRingApply().
+    // HF3D TODO:  Be very cautious of increasing PID_SERVO_MIXER_SCALING in the future code!!
     //   ** Users may unexpectedly end up with more cyclic pitch than they originally setup if you change it!
-    //   Maybe change the max criteria to something else?  It's actually the physical servo output we want to limit...
-    if (swashRingTotal > (currentPidProfile->pidSumLimit * PID_SERVO_MIXER_SCALING)) {
-        // normalize the roll and pitch values using the maximum if the sum exceeds our max expected value
-        input[INPUT_STABILIZED_ROLL] = input[INPUT_STABILIZED_ROLL] * ABS(input[INPUT_STABILIZED_ROLL]) / swashRingTotal;
-        input[INPUT_STABILIZED_PITCH] = input[INPUT_STABILIZED_PITCH] * ABS(input[INPUT_STABILIZED_PITCH]) / swashRingTotal;
+    const float maxCyclic = currentPidProfile->pidSumLimit * PID_SERVO_MIXER_SCALING;
+    if (maxCyclic != swashRing.maxCyclic || !ARMING_FLAG(ARMED)) {
+        swashRingInit(&swashRing, servoConfig()->swash_ring_mode, servoConfig()->swash_ring_limit, maxCyclic);
+        swashLoadCompInit(&swashLoadComp, servoConfig()->swash_load_comp, maxCyclic);
     }
+    swashRingValue = swashRingApply(&swashRing, &input[INPUT_STABILIZED_ROLL], &input[INPUT_STABILIZED_PITCH]);
+    DEBUG_SET(DEBUG_SWASH_LOAD, 3, lrintf(swashRingValue * 1000));
+
+    // HF3D:  Collective and cyclic together must not stall the blades
+    servosCollectiveStallLimit(input);
+
     // NOTE:  pidSumLimit for roll & pitch should be increased until exactly 10 degrees of cyclic pitch is achieved at maximum swash deflection and zero collective pitch
     //   It's best to start low with pidSumLimit and then increase it while continuing to measure total pitch.  This avoids damage to servos from binding.
     //   Warning:  More than 10 degrees of available cyclic pitch can lead to boom strikes!!!
@@ -501,6 +812,11 @@ void servoMixer(void)
 
     }
 
+    if (servosUseSwashMixer()) {
+        servosSwashMixer(input);
+        return;
+    }
+
     // mix servos according to smix rules
     //   https://github.com/cleanflight/cleanflight/blob/master/docs/Mixer.md
     for (int i = 0; i < servoRuleCount; i++) {
@@ -543,6 +859,132 @@ void servoMixer(void)
 }
 
 
+// HF3D:  Swash servo calibration mode, see servo_calib.h
+//   Drives the swash servos straight to the grid step with the current centre, rate and direction plus the
+//   user's trim, bypassing the mixer and the servo curves.
+static struct {
+    bool active;
+    uint8_t step;
+    int16_t trim[SWASH_SERVO_COUNT];
+    float scale[SWASH_SERVO_COUNT];                             // current rate and direction
+    float travel[SERVO_CALIB_STEPS][SWASH_SERVO_COUNT];
+    float pulse[SWASH_SERVO_COUNT][SERVO_CALIB_STEPS];
+} servoCalib;
+
+bool servoCalibStart(void)
+{
+    if (ARMING_FLAG(ARMED) || getMixerMode() != MIXER_HELI_120_CCPM) {
+        return false;
+    }
+
+    // The smix rules don't say where the servos are, assume the default 120 degree swash
+    const uint8_t swashType = (servoConfig()->swash_type == SWASH_TYPE_SMIX) ? SWASH_TYPE_120 : servoConfig()->swash_type;
+
+    for (int step = 0; step < SERVO_CALIB_STEPS; step++) {
+        servoCalibTravel(swashType, servoConfig()->swash_servo_angle, step, servoCalib.travel[step]);
+    }
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        servoCalib.trim[i] = 0;
+        servoCalib.scale[i] = servoDirection(i, INPUT_RC_AUX1) * servoParams(i)->rate / 100.0f;
+    }
+
+    servoCalib.step = 0;
+    servoCalib.active = true;
+
+    return true;
+}
+
+void servoCalibStop(void)
+{
+    servoCalib.active = false;
+}
+
+bool servoCalibIsActive(void)
+{
+    return servoCalib.active;
+}
+
+int servoCalibGetStep(void)
+{
+    return servoCalib.step;
+}
+
+bool servoCalibSetTrim(int servoIndex, int trim)
+{
+    if (!servoCalib.active || servoIndex < 0 || servoIndex >= SWASH_SERVO_COUNT) {
+        return false;
+    }
+
+    servoCalib.trim[servoIndex] = constrain(trim, -SERVO_CALIB_TRIM_MAX, SERVO_CALIB_TRIM_MAX);
+
+    return true;
+}
+
+int16_t servoCalibGetTrim(int servoIndex)
+{
+    return servoCalib.trim[servoIndex];
+}
+
+int16_t servoCalibGetPulse(int servoIndex)
+{
+    const float travel = servoCalib.travel[servoCalib.step][servoIndex];
+    const int16_t pulse = servoParams(servoIndex)->middle + lrintf(servoCalib.scale[servoIndex] * travel) + servoCalib.trim[servoIndex];
+
+    return constrain(pulse, servoParams(servoIndex)->min, servoParams(servoIndex)->max);
+}
+
+static bool servoCalibFinish(void)
+{
+    servoCalibFit_t fit[SWASH_SERVO_COUNT];
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        float travel[SERVO_CALIB_STEPS];
+        for (int step = 0; step < SERVO_CALIB_STEPS; step++) {
+            travel[step] = servoCalib.travel[step][i];
+        }
+        if (!servoCalibSolve(travel, servoCalib.pulse[i], SERVO_CALIB_STEPS, &fit[i])) {
+            return false;
+        }
+    }
+
+    // A reversed swash servo is reversed for all the swash inputs
+    const uint32_t swashSources = (1 << INPUT_STABILIZED_ROLL) | (1 << INPUT_STABILIZED_PITCH) | (1 << INPUT_RC_AUX1);
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        servoParam_t *param = servoParamsMutable(i);
+
+        param->middle = constrain(lrintf(fit[i].middle), param->min, param->max);
+        param->rate = constrain(lrintf(fabsf(fit[i].scale) * 100), 1, 125);
+        if (fit[i].scale < 0) {
+            param->reversedSources |= swashSources;
+        } else {
+            param->reversedSources &= ~swashSources;
+        }
+    }
+
+    return true;
+}
+
+servoCalibResult_e servoCalibNext(void)
+{
+    if (!servoCalib.active) {
+        return SERVO_CALIB_FAILED;
+    }
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        servoCalib.pulse[i][servoCalib.step] = servoCalibGetPulse(i);
+    }
+
+    if (++servoCalib.step < SERVO_CALIB_STEPS) {
+        return SERVO_CALIB_STEP_DONE;
+    }
+
+    servoCalib.active = false;
+    servoCalib.step = 0;
+
+    return servoCalibFinish() ? SERVO_CALIB_FINISHED : SERVO_CALIB_FAILED;
+}
+
 static void servoTable(void)
 {
     // airplane / servo mixes
@@ -573,6 +1015,20 @@ static void servoTable(void)
         break;
     }
 
+    // HF3D:  Calibration mode ends on arming
+    if (servoCalib.active && ARMING_FLAG(ARMED)) {
+        servoCalibStop();
+    }
+
+    if (servoCalib.active) {
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            servo[i] = servoCalibGetPulse(i);
+        }
+    } else {
+        // HF3D:  Linearise the mixer output for the servo arm geometry
+        servosApplyCurves();
+    }
+
     // camera stabilization
     if (featureIsEnabled(FEATURE_SERVO_TILT)) {
         // center at fixed position, or vary either pitch or roll by RC channel
@@ -605,7 +1061,11 @@ static void servoTable(void)
     
     // constrain servos
     //   default min = 1000, max = 2000
+    servoClamped = 0;
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        if (servo[i] <= servoParams(i)->min || servo[i] >= servoParams(i)->max) {
+            servoClamped |= (1 << i);
+        }
         servo[i] = constrain(servo[i], servoParams(i)->min, servoParams(i)->max); // limit the values
     }
 }
@@ -616,23 +1076,65 @@ bool isMixerUsingServos(void)
 }
 
 static biquadFilter_t servoFilter[MAX_SUPPORTED_SERVOS];
+static bool servoFilterEnabled;
+
+static servoSlew_t servoSlew[MAX_SUPPORTED_SERVOS];
+static float servoUpdateDt;
+static float servoOutputLatency;
+static uint8_t servoAxisSaturated;
 
 void servosFilterInit(void)
 {
-    if (servoConfig()->servo_lowpass_freq) {
+    // HF3D:  Update the servos once per servo frame, or every loop when the PID loop is slower.
+    //   The tricopter tail servo feedback needs every loop.
+    const uint32_t servoFramePeriod = 1000000 / servoConfig()->dev.servoPwmRate;
+    if (mixerIsTricopter() || targetPidLooptime == 0) {
+        servoLoopDenom = 1;
+    } else {
+        servoLoopDenom = constrain(servoFramePeriod / targetPidLooptime, 1, UINT8_MAX);
+    }
+    servoLoopCount = 0;
+
+    // The lowpass runs at the decimated rate, keep it below the Nyquist frequency
+    const uint32_t servoUpdatePeriod = targetPidLooptime * servoLoopDenom;
+    const uint16_t cutoff = MIN(servoConfig()->servo_lowpass_freq, 400000 / servoUpdatePeriod);
+
+    servoFilterEnabled = (cutoff > 0);
+    if (servoFilterEnabled) {
         for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
-            biquadFilterInitLPF(&servoFilter[servoIdx], servoConfig()->servo_lowpass_freq, targetPidLooptime);
+            biquadFilterInitLPF(&servoFilter[servoIdx], cutoff, servoUpdatePeriod);
         }
     }
 
+    // HF3D:  The slew model steps once per servo update, in real time
+    servoUpdateDt = servoUpdatePeriod * 1e-6f;
+    for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+        servoSlewInit(&servoSlew[servoIdx], servoConfig()->servo_rate_limit[servoIdx], servoConfig()->servo_accel_limit[servoIdx]);
+    }
+
+    // HF3D:  Average delay from the PID output to the servo pulse, in seconds.
+    //   The boxcar average over servoLoopDenom loops delays by (servoLoopDenom - 1) / 2 loops.
+    //   The value is then held for one servo update, half an update on average, and the PWM timer is not
+    //   synchronised with the loop, so it waits another half update on average for the next pulse to start.
+    //   The Butterworth lowpass adds its low frequency group delay of sqrt(2) / (2 * pi * cutoff).
+    //   The slew limiter adds no delay until it saturates, and saturation is reported to the PID controller instead.
+    servoOutputLatency = targetPidLooptime * 1e-6f * (servoLoopDenom - 1) / 2 + servoUpdateDt;
+    if (servoFilterEnabled) {
+        servoOutputLatency += sqrtf(2.0f) / (2 * M_PIf * cutoff);
+    }
 }
+
 static void filterServos(void)
 {
 #if defined(MIXER_DEBUG)
     uint32_t startTime = micros();
 #endif
-    if (servoConfig()->servo_lowpass_freq) {
+    if (servoFilterEnabled) {
+        // HF3D:  Only the servos the mixer drives
         for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+            if (!(servoMixerOutputs & (1 << servoIdx))) {
+                continue;
+            }
             servo[servoIdx] = lrintf(biquadFilterApply(&servoFilter[servoIdx], (float)servo[servoIdx]));
             // Sanity check
             servo[servoIdx] = constrain(servo[servoIdx], servoParams(servoIdx)->min, servoParams(servoIdx)->max);
@@ -642,13 +1144,93 @@ static void filterServos(void)
     debug[0] = (int16_t)(micros() - startTime);
 #endif
 }
+
+// HF3D:  Servo speed and acceleration limits.
+//   The servos can't follow the mixer faster than they physically move, so the command is rate limited here and
+//   any servo that is behind its target flags the stabilised axes that drive it through the mixer rules or the swash matrix.
+//   The PID controller stops the I-term from winding up further on a saturated axis.
+static void slewServos(void)
+{
+    uint32_t saturated = 0;
+
+    for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+        if (!(servoMixerOutputs & (1 << servoIdx))) {
+            continue;
+        }
+        const float target = servo[servoIdx];
+        servo[servoIdx] = lrintf(servoSlewApply(&servoSlew[servoIdx], target, servoUpdateDt));
+        if (servoSlewIsSaturated(&servoSlew[servoIdx], target)) {
+            saturated |= (1 << servoIdx);
+        }
+    }
+
+    uint8_t axisSaturated = 0;
+    if (saturated && servosUseSwashMixer()) {
+        // The swash servos from the swash mixing matrix, the tail servo straight from yaw
+        const uint8_t swashInputs = swashMixerGetServoInputs(&swashMixer, saturated & ((1 << SWASH_SERVO_COUNT) - 1));
+        if (swashInputs & (1 << SWASH_INPUT_ROLL)) {
+            axisSaturated |= (1 << FD_ROLL);
+        }
+        if (swashInputs & (1 << SWASH_INPUT_PITCH)) {
+            axisSaturated |= (1 << FD_PITCH);
+        }
+        if ((saturated & (1 << SERVO_HELI_RUD)) && swashTailScale != 0) {
+            axisSaturated |= (1 << FD_YAW);
+        }
+    } else if (saturated) {
+        for (int i = 0; i < servoRuleCount; i++) {
+            const uint8_t from = currentServoMixer[i].inputSource;
+            if ((saturated & (1 << currentServoMixer[i].targetChannel)) && from <= INPUT_STABILIZED_YAW) {
+                axisSaturated |= (1 << (from - INPUT_STABILIZED_ROLL));
+            }
+        }
+    }
+    servoAxisSaturated = axisSaturated;
+    servoSaturated = saturated;
+}
+
+bool servosIsAxisSaturated(int axis)
+{
+    return servoAxisSaturated & (1 << axis);
+}
+
+float servosGetOutputLatency(void)
+{
+    return servoOutputLatency;
+}
+
+#ifdef USE_ACTUATOR_LOG
+// HF3D:  Snapshot of the outputs, see actuator_log.h
+static void servosLogActuators(void)
+{
+    static bool wasArmed;
+    const bool armed = ARMING_FLAG(ARMED);
+
+    if (armed && !wasArmed) {
+        actuatorLogReset();
+    } else if ((!armed && wasArmed) || crashRecoveryModeActive()) {
+        actuatorLogFreeze();
+    }
+    wasArmed = armed;
+
+    actuatorLogEntry_t entry;
+    entry.time = micros();
+    for (int i = 0; i < ACTUATOR_LOG_SERVOS; i++) {
+        entry.servo[i] = servo[i];
+    }
+    for (int i = 0; i < ACTUATOR_LOG_MOTORS; i++) {
+        entry.motor[i] = (i < MAX_SUPPORTED_MOTORS) ? lrintf(motor[i]) : 0;
+    }
+    entry.swashRing = lrintf(constrainf(swashRingValue, 0, 2) * 1000);
+    entry.servoClamped = servoClamped;
+    entry.servoSaturated = servoSaturated;
+
+    actuatorLogWrite(&entry);
+}
+#endif
 #endif // USE_SERVOS
 
 float servosGetSwashRingValue(void)
 {
-	if (swashRingTotal > (currentPidProfile->pidSumLimit * PID_SERVO_MIXER_SCALING)) {
-		return 1.0;
-    } else {
-		return ( (float) swashRingTotal / (PID_SERVO_MIXER_SCALING * currentPidProfile->pidSumLimit) );
-	}
+    return MIN(swashRingValue, 1.0f);
 }
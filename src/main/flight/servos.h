@@ -24,6 +24,11 @@
 #include "drivers/io_types.h"
 #include "drivers/pwm_output.h"
 
+#include "flight/servo_calib.h"
+#include "flight/servo_curve.h"
+#include "flight/servo_slew.h"
+#include "flight/swash.h"
+
 // These must be consecutive, see 'reversedSources'
 enum {
     INPUT_STABILIZED_ROLL = 0,
@@ -98,6 +103,16 @@ typedef struct servoMixer_s {
 
 PG_DECLARE_ARRAY(servoMixer_t, MAX_SERVO_RULES, customServoMixers);
 
+#define SERVO_FRAME_MIN_GAP     20      // HF3D:  us between the end of the longest servo pulse and the next frame
+#define SERVO_PWM_RATE_MAX      560     // HF3D:  narrow band digital servos
+#define SERVO_NARROW_BAND_DIV   2       // HF3D:  1520us standard center to 760us narrow band center
+
+#define COLLECTIVE_RANGE        500     // HF3D:  collective input range, the same as the other mixer inputs
+
+#define SERVO_CALIB_TRIM_MAX    250     // HF3D:  servo trim range in calibration mode, us
+
+#define SWASH_PHASE_MAX         1800    // HF3D:  swash phase angle range, 0.1 degrees
+
 #define MAX_SERVO_SPEED UINT8_MAX
 #define MAX_SERVO_BOXES 3
 
@@ -120,11 +135,29 @@ typedef struct servoParam_s {
 
 PG_DECLARE_ARRAY(servoParam_t, MAX_SUPPORTED_SERVOS, servoParams);
 
+PG_DECLARE_ARRAY(servoCurve_t, MAX_SUPPORTED_SERVOS, servoCurves);
+
 typedef struct servoConfig_s {
     servoDevConfig_t dev;
-    uint16_t servo_lowpass_freq;            // lowpass servo filter frequency selection; 1/1000ths of loop freq
+    uint16_t servo_lowpass_freq;            // lowpass servo filter cutoff in Hz, runs at the servo update rate
     uint8_t tri_unarmed_servo;              // send tail servo correction pulses even when unarmed
     uint8_t channelForwardingStartChannel;
+    uint8_t swash_type;                     // HF3D:  swashType_e, native swashplate mixer geometry or smix rules
+    int16_t swash_servo_angle[SWASH_SERVO_COUNT];   // HF3D:  custom swash servo positions in degrees clockwise from the TOP servo
+    uint8_t swash_ring_mode;                // HF3D:  swashRingMode_e
+    uint8_t swash_ring_limit[SWASH_RING_LIMIT_COUNT];   // HF3D:  swash ring size in % of the maximum cyclic, see swashRingLimit_e
+    uint16_t servo_rate_limit[MAX_SUPPORTED_SERVOS];    // HF3D:  servo speed in us/s, 0 = unlimited
+    uint16_t servo_accel_limit[MAX_SUPPORTED_SERVOS];   // HF3D:  servo acceleration in 1000 us/s^2, 0 = unlimited
+    servoCurve_t collective_curve;          // HF3D:  collective output at -500 ... +500 collective stick
+    int16_t collective_min;                 // HF3D:  collective limits after the curve
+    int16_t collective_max;
+    uint16_t collective_stall_limit;        // HF3D:  maximum collective + cyclic, 0 = OFF
+    uint8_t collective_stall_headspeed;     // HF3D:  headspeed in % of gov_max_headspeed below which the stall limit is lowered, 0 = OFF
+    int8_t swash_load_comp[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT];  // HF3D:  servo offset in us at 100% cyclic in each direction, see swashLoadComp_t
+    int16_t swash_phase;                    // HF3D:  swash phase angle in 0.1 degrees, at full headspeed
+    int16_t swash_phase_low;                // HF3D:  swash phase angle in 0.1 degrees at swash_phase_low_headspeed
+    uint8_t swash_phase_low_headspeed;      // HF3D:  in % of gov_max_headspeed, 0 = fixed phase angle
+    uint8_t servo_narrow_band[MAX_SUPPORTED_SERVOS];    // HF3D:  760us center servo, output at half the standard pulse width
 } servoConfig_t;
 
 PG_DECLARE(servoConfig_t, servoConfig);
@@ -145,6 +178,7 @@ int servoDirection(int servoIndex, int fromChannel);
 void servoConfigureOutput(void);
 void servosInit(void);
 void servosFilterInit(void);
+void servosCurveInit(void);
 void servoMixer(void);
 // tricopter specific
 void servosTricopterInit(void);
@@ -152,3 +186,20 @@ void servosTricopterMixer(void);
 bool servosTricopterIsEnabledServoUnarmed(void);
 // HF3D
 float servosGetSwashRingValue(void);
+bool servosIsAxisSaturated(int axis);
+float servosGetOutputLatency(void);
+
+typedef enum {
+    SERVO_CALIB_STEP_DONE = 0,              // pulses recorded, on to the next step
+    SERVO_CALIB_FINISHED,                   // all steps done, servoParams updated
+    SERVO_CALIB_FAILED,                     // not active, or a servo didn't fit
+} servoCalibResult_e;
+
+bool servoCalibStart(void);
+void servoCalibStop(void);
+bool servoCalibIsActive(void);
+int servoCalibGetStep(void);
+bool servoCalibSetTrim(int servoIndex, int trim);
+int16_t servoCalibGetTrim(int servoIndex);
+int16_t servoCalibGetPulse(int servoIndex);
+servoCalibResult_e servoCalibNext(void);
@@ -0,0 +1,190 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/swash.h"
+
+// Servo positions in degrees clockwise from the TOP servo, in LEFT, RIGHT, TOP order
+static const int16_t swashServoAngles[SWASH_TYPE_COUNT][SWASH_SERVO_COUNT] = {
+    [SWASH_TYPE_120] = { 240, 120, 0 },
+    [SWASH_TYPE_135] = { 225, 135, 0 },
+    [SWASH_TYPE_140] = { 220, 140, 0 },
+    [SWASH_TYPE_90]  = { 270,  90, 0 },
+};
+
+void swashMixerBuild(swashMixer_t *swash, const swashMixerInputs_t *inputs)
+{
+    // Copied with the padding so that the inputs can be compared with memcmp()
+    memcpy(&swash->inputs, inputs, sizeof(swash->inputs));
+
+    // The smix rules do the mixing
+    if (inputs->type == SWASH_TYPE_SMIX || inputs->type >= SWASH_TYPE_COUNT) {
+        memset(swash->mix, 0, sizeof(swash->mix));
+        return;
+    }
+
+    const int16_t *angles = (inputs->type == SWASH_TYPE_CUSTOM) ? inputs->angle : swashServoAngles[inputs->type];
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        const float angle = degreesToRadians(angles[i]);
+        const float rate = inputs->rate[i] / 100.0f;
+
+        // Round off sin/cos so that the servos at right angles get exactly zero cross-coupling
+        const float roll = lrintf(sinf(angle) * 1e6f) / 1e6f;
+        const float pitch = lrintf(cosf(angle) * 1e6f) / 1e6f;
+
+        swash->mix[i][SWASH_INPUT_ROLL] = roll * rate * inputs->direction[i][SWASH_INPUT_ROLL];
+        swash->mix[i][SWASH_INPUT_PITCH] = pitch * rate * inputs->direction[i][SWASH_INPUT_PITCH];
+        swash->mix[i][SWASH_INPUT_COLLECTIVE] = rate * inputs->direction[i][SWASH_INPUT_COLLECTIVE];
+    }
+}
+
+// Inputs that move any of the swash servos in the mask, bit per swashInput_e
+uint8_t swashMixerGetServoInputs(const swashMixer_t *swash, uint8_t servoMask)
+{
+    uint8_t inputs = 0;
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        if (servoMask & (1 << i)) {
+            for (int j = 0; j < SWASH_INPUT_COUNT; j++) {
+                if (swash->mix[i][j] != 0) {
+                    inputs |= (1 << j);
+                }
+            }
+        }
+    }
+
+    return inputs;
+}
+
+void swashPhaseInit(swashPhase_t *phase, int16_t angle)
+{
+    const float radians = angle * (RAD / 10.0f);
+
+    phase->enabled = (angle != 0);
+    phase->angle = angle;
+    phase->sinPhase = sinf(radians);
+    phase->cosPhase = cosf(radians);
+}
+
+void swashRingInit(swashRing_t *ring, uint8_t mode, const uint8_t limit[SWASH_RING_LIMIT_COUNT], float maxCyclic)
+{
+    uint8_t ringLimit[SWASH_RING_LIMIT_COUNT];
+
+    switch (mode) {
+    case SWASH_RING_ELLIPTICAL:
+        ringLimit[SWASH_RING_ROLL_POS] = ringLimit[SWASH_RING_ROLL_NEG] = limit[SWASH_RING_ROLL_POS];
+        ringLimit[SWASH_RING_PITCH_POS] = ringLimit[SWASH_RING_PITCH_NEG] = limit[SWASH_RING_PITCH_POS];
+        break;
+    case SWASH_RING_QUADRANT:
+        memcpy(ringLimit, limit, sizeof(ringLimit));
+        break;
+    case SWASH_RING_CIRCULAR:
+        memset(ringLimit, limit[SWASH_RING_ROLL_POS], sizeof(ringLimit));
+        break;
+    default:
+        // No limiting, but keep measuring against the maximum cyclic circle
+        memset(ringLimit, 100, sizeof(ringLimit));
+        break;
+    }
+
+    ring->enabled = (mode > SWASH_RING_OFF && mode < SWASH_RING_MODE_COUNT);
+    ring->maxCyclic = maxCyclic;
+    for (int i = 0; i < SWASH_RING_LIMIT_COUNT; i++) {
+        ring->invLimit[i] = 100.0f / (MAX(ringLimit[i], 1) * maxCyclic);
+    }
+}
+
+// Scale the cyclic vector back onto the ring if it is outside, keeping its direction.
+//   Returns the cyclic command relative to the ring, 1.0 when limited.
+float swashRingApply(const swashRing_t *ring, float *roll, float *pitch)
+{
+    const float r = *roll * ring->invLimit[(*roll < 0) ? SWASH_RING_ROLL_NEG : SWASH_RING_ROLL_POS];
+    const float p = *pitch * ring->invLimit[(*pitch < 0) ? SWASH_RING_PITCH_NEG : SWASH_RING_PITCH_POS];
+    const float length2 = r * r + p * p;
+
+    if (length2 <= 0) {
+        return 0;
+    }
+
+    const float invLength = invSqrtf(length2);
+
+    if (ring->enabled && length2 > 1.0f) {
+        *roll *= invLength;
+        *pitch *= invLength;
+        return 1.0f;
+    }
+
+    return length2 * invLength;
+}
+
+// Returns the scale applied to the inputs, 1.0 when not limited
+float swashStallLimitApply(float limit, float *roll, float *pitch, float *collective)
+{
+    if (limit <= 0) {
+        return 1.0f;
+    }
+
+    const float cyclic = sqrtf(sq(*roll) + sq(*pitch));
+    const float total = cyclic + fabsf(*collective);
+
+    if (total <= limit) {
+        return 1.0f;
+    }
+
+    const float scale = limit / total;
+    *roll *= scale;
+    *pitch *= scale;
+    *collective *= scale;
+
+    return scale;
+}
+
+void swashLoadCompInit(swashLoadComp_t *comp, const int8_t table[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT], float maxCyclic)
+{
+    comp->enabled = false;
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        for (int j = 0; j < SWASH_RING_LIMIT_COUNT; j++) {
+            comp->gain[i][j] = (maxCyclic > 0) ? table[i][j] / maxCyclic : 0;
+            if (comp->gain[i][j] != 0) {
+                comp->enabled = true;
+            }
+        }
+    }
+}
+
+void swashLoadCompApply(const swashLoadComp_t *comp, float roll, float pitch, float offset[SWASH_SERVO_COUNT])
+{
+    const int rollDir = (roll < 0) ? SWASH_RING_ROLL_NEG : SWASH_RING_ROLL_POS;
+    const int pitchDir = (pitch < 0) ? SWASH_RING_PITCH_NEG : SWASH_RING_PITCH_POS;
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        offset[i] = comp->gain[i][rollDir] * fabsf(roll) + comp->gain[i][pitchDir] * fabsf(pitch);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HF3D:  Native swashplate mixer.
+//   The swash servos sit on a circle around the main shaft, so for any servo geometry the servo travel needed
+//   for a given swash tilt and height is  collective + roll * sin(angle) + pitch * cos(angle),  where angle is
+//   the servo position clockwise from the front (TOP) servo seen from above.
+//   The whole mix, including the servo directions and rates, is resolved into a 3 x N float matrix by
+//   swashMixerBuild() at config time, leaving a single matrix-vector product per loop.
+
+#define SWASH_SERVO_COUNT   3           // Swash servos, in the SERVO_HELI_LEFT, SERVO_HELI_RIGHT, SERVO_HELI_TOP order
+
+typedef enum {
+    SWASH_TYPE_SMIX = 0,                // Generic smix rules
+    SWASH_TYPE_120,
+    SWASH_TYPE_135,
+    SWASH_TYPE_140,
+    SWASH_TYPE_90,
+    SWASH_TYPE_CUSTOM,                  // Servo angles from swash_servo_angle
+    SWASH_TYPE_COUNT
+} swashType_e;
+
+typedef enum {
+    SWASH_INPUT_ROLL = 0,
+    SWASH_INPUT_PITCH,
+    SWASH_INPUT_COLLECTIVE,
+    SWASH_INPUT_COUNT
+} swashInput_e;
+
+// HF3D:  Swash ring, limits the combined roll and pitch (cyclic) command.
+//   The cyclic vector is limited to an ellipse in each quadrant, with the semi-axes set for each direction
+//   of roll and pitch in % of the maximum single axis cyclic command. CIRCULAR uses the ROLL_POS limit in every
+//   direction, ELLIPTICAL uses ROLL_POS for roll and PITCH_POS for pitch, QUADRANT uses all four.
+typedef enum {
+    SWASH_RING_OFF = 0,
+    SWASH_RING_CIRCULAR,
+    SWASH_RING_ELLIPTICAL,
+    SWASH_RING_QUADRANT,
+    SWASH_RING_MODE_COUNT
+} swashRingMode_e;
+
+typedef enum {
+    SWASH_RING_ROLL_POS = 0,
+    SWASH_RING_ROLL_NEG,
+    SWASH_RING_PITCH_POS,
+    SWASH_RING_PITCH_NEG,
+    SWASH_RING_LIMIT_COUNT
+} swashRingLimit_e;
+
+typedef struct swashRing_s {
+    bool enabled;
+    float maxCyclic;                                        // single axis cyclic command for 100%
+    float invLimit[SWASH_RING_LIMIT_COUNT];                 // 1 / semi-axis of each quadrant ellipse
+} swashRing_t;
+
+typedef struct swashMixerInputs_s {
+    uint8_t type;                                           // swashType_e
+    int16_t angle[SWASH_SERVO_COUNT];                       // servo angles in degrees for SWASH_TYPE_CUSTOM
+    int8_t direction[SWASH_SERVO_COUNT][SWASH_INPUT_COUNT]; // servo direction for each input, 1 or -1
+    int8_t rate[SWASH_SERVO_COUNT];                         // servo rate in %
+} swashMixerInputs_t;
+
+typedef struct swashMixer_s {
+    swashMixerInputs_t inputs;                              // the matrix was built for these
+    float mix[SWASH_SERVO_COUNT][SWASH_INPUT_COUNT];
+} swashMixer_t;
+
+void swashMixerBuild(swashMixer_t *swash, const swashMixerInputs_t *inputs);
+uint8_t swashMixerGetServoInputs(const swashMixer_t *swash, uint8_t servoMask);
+
+static inline void swashMixerApply(const swashMixer_t *swash, const float input[SWASH_INPUT_COUNT], float output[SWASH_SERVO_COUNT])
+{
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        output[i] = swash->mix[i][SWASH_INPUT_ROLL] * input[SWASH_INPUT_ROLL] +
+                    swash->mix[i][SWASH_INPUT_PITCH] * input[SWASH_INPUT_PITCH] +
+                    swash->mix[i][SWASH_INPUT_COLLECTIVE] * input[SWASH_INPUT_COLLECTIVE];
+    }
+}
+
+// HF3D:  Swash phase angle.
+//   Rotates the cyclic vector to correct the phase lag of the rotor head, which is the same as turning the
+//   servo angles by the phase angle. The sin and cos are worked out once for each new angle.
+typedef struct swashPhase_s {
+    bool enabled;
+    int16_t angle;                                          // 0.1 degrees
+    float sinPhase;
+    float cosPhase;
+} swashPhase_t;
+
+void swashPhaseInit(swashPhase_t *phase, int16_t angle);
+
+static inline void swashPhaseApply(const swashPhase_t *phase, float *roll, float *pitch)
+{
+    const float r = *roll;
+    const float p = *pitch;
+
+    *roll = r * phase->cosPhase - p * phase->sinPhase;
+    *pitch = r * phase->sinPhase + p * phase->cosPhase;
+}
+
+void swashRingInit(swashRing_t *ring, uint8_t mode, const uint8_t limit[SWASH_RING_LIMIT_COUNT], float maxCyclic);
+float swashRingApply(const swashRing_t *ring, float *roll, float *pitch);
+
+// HF3D:  Blade stall limit.
+//   The blade pitch peaks at collective + cyclic once per revolution, so that sum is kept below the limit by
+//   scaling collective and cyclic down together, which keeps the ratio of climb to cyclic authority.
+float swashStallLimitApply(float limit, float *roll, float *pitch, float *collective);
+
+// HF3D:  Servo load precompensation.
+//   The blade loads push back on the swash servos unevenly with cyclic, which moves the swash away from where
+//   it was commanded and shows up as collective bounce. Each servo gets an offset for each direction of roll
+//   and pitch, in us at 100% cyclic (swashRingLimit_e order), scaled with the cyclic in that direction.
+typedef struct swashLoadComp_s {
+    bool enabled;
+    float gain[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT];  // offset per unit of cyclic command
+} swashLoadComp_t;
+
+void swashLoadCompInit(swashLoadComp_t *comp, const int8_t table[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT], float maxCyclic);
+void swashLoadCompApply(const swashLoadComp_t *comp, float roll, float pitch, float offset[SWASH_SERVO_COUNT]);
@@ -73,9 +73,12 @@
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
+#include "flight/actuator_log.h"
 #include "flight/failsafe.h"
+#include "flight/governor.h"
 #include "flight/gps_rescue.h"
 #include "flight/imu.h"
+#include "flight/loop_profile.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
@@ -1080,12 +1083,7 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 
 #ifdef USE_DSHOT_TELEMETRY
             if (motorConfig()->dev.useDshotTelemetry) {
-                // HF3D TODO:  Make motorPoleCount an array for differnet main/tail pole counts, update CLI/MSP telemetry/LUA/configurator to match
-                if (i == 1) {         // Tail motor RPM calculation for OMP M2
-                    rpm = (int)getDshotTelemetry(i) * 100 * 2 / 12;
-                } else {
-                    rpm = (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount;
-                }
+                rpm = (int)getDshotTelemetry(i) * 100 * 2 / motorConfig()->motorPoleCount[i];
                 rpmDataAvailable = true;
                 invalidPct = 10000; // 100.00%
 #ifdef USE_DSHOT_TELEMETRY_STATS
@@ -1100,7 +1098,7 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
             if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
                 escSensorData_t *escData = getEscSensorData(i);
                 if (!rpmDataAvailable) {  // We want DSHOT telemetry RPM data (if available) to have precedence
-                    rpm = calcEscRpm(escData->rpm);
+                    rpm = calcEscRpm(i, escData->rpm);
                     rpmDataAvailable = true;
                 }
                 escTemperature = escData->temperature;
@@ -1119,6 +1117,35 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         }
         break;
 
+    // HF3D:  Compact governor status, same data as the governor blackbox fields
+    case MSP_GOVERNOR:
+        {
+            governorTelemetry_t governor;
+            governorGetTelemetry(mixerGetGovernorState(), &governor);
+            sbufWriteU16(dst, governor.headspeed);
+            sbufWriteU16(dst, governor.setpoint);
+            sbufWriteU16(dst, governor.setpointLimited);
+            sbufWriteU16(dst, governor.throttle);
+            sbufWriteU16(dst, governor.pidSum);
+            sbufWriteU16(dst, governor.collectiveFF);
+            sbufWriteU16(dst, governor.collectivePulseFF);
+            sbufWriteU16(dst, governor.cyclicFF);
+            sbufWriteU8(dst, governor.status);
+        }
+        break;
+
+#ifdef USE_SERVOS
+    case MSP_SERVO_CALIBRATION:
+        sbufWriteU8(dst, servoCalibIsActive());
+        sbufWriteU8(dst, servoCalibGetStep());
+        sbufWriteU8(dst, SERVO_CALIB_STEPS);
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            sbufWriteU16(dst, servoCalibGetTrim(i));
+            sbufWriteU16(dst, servoCalibIsActive() ? servoCalibGetPulse(i) : servo[i]);
+        }
+        break;
+#endif
+
     case MSP_RC:
         for (int i = 0; i < rxRuntimeState.channelCount; i++) {
             sbufWriteU16(dst, rcData[i]);
@@ -1251,7 +1278,7 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 
         // API 1.42
         sbufWriteU8(dst, getMotorCount());
-        sbufWriteU8(dst, motorConfig()->motorPoleCount);
+        sbufWriteU8(dst, motorConfig()->motorPoleCount[0]);
 #ifdef USE_DSHOT_TELEMETRY
         sbufWriteU8(dst, motorConfig()->dev.useDshotTelemetry);
 #else
@@ -1263,6 +1290,14 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 #else
         sbufWriteU8(dst, 0);
 #endif
+
+        // HF3D:  Per-motor pole count, gear ratio and RPM source
+        sbufWriteU8(dst, MAX_SUPPORTED_MOTORS);
+        for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+            sbufWriteU8(dst, motorConfig()->motorPoleCount[i]);
+            sbufWriteU16(dst, motorConfig()->motorGearRatio[i]);
+            sbufWriteU8(dst, motorConfig()->motorRpmSource[i]);
+        }
         break;
 
 #ifdef USE_MAG
@@ -1838,6 +1873,66 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, uint8_
         }
 
         break;
+#ifdef USE_ACTUATOR_LOG
+    case MSP_ACTUATOR_LOG:
+        {
+            // HF3D:  As many entries as fit, oldest first from the requested index
+            const unsigned first = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+            const unsigned count = actuatorLogGetCount();
+            const int entrySize = 4 + 2 * ACTUATOR_LOG_SERVOS + 2 * ACTUATOR_LOG_MOTORS + 2 + 1 + 1;
+            const int headerSize = 1 + 2 + 2 + 1;
+            const unsigned fit = MAX(sbufBytesRemaining(dst) - headerSize - 1, 0) / entrySize;
+            const unsigned entries = (first < count) ? MIN(count - first, fit) : 0;
+
+            sbufWriteU8(dst, actuatorLogIsFrozen());
+            sbufWriteU16(dst, count);
+            sbufWriteU16(dst, first);
+            sbufWriteU8(dst, entries);
+            for (unsigned i = 0; i < entries; i++) {
+                const actuatorLogEntry_t *entry = actuatorLogGetEntry(first + i);
+                sbufWriteU32(dst, entry->time);
+                for (int j = 0; j < ACTUATOR_LOG_SERVOS; j++) {
+                    sbufWriteU16(dst, entry->servo[j]);
+                }
+                for (int j = 0; j < ACTUATOR_LOG_MOTORS; j++) {
+                    sbufWriteU16(dst, entry->motor[j]);
+                }
+                sbufWriteU16(dst, entry->swashRing);
+                sbufWriteU8(dst, entry->servoClamped);
+                sbufWriteU8(dst, entry->servoSaturated);
+            }
+        }
+        break;
+#endif
+#ifdef USE_LOOP_PROFILE
+    case MSP_LOOP_PROFILE:
+        {
+            // HF3D:  As many stages as fit, from the requested stage
+            const unsigned first = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+            const int entrySize = 4 * 4 + 4 * LOOP_PROFILE_BUCKETS;
+            const int headerSize = 1 + 4 + 1 + 1 + 1 + 1;
+            const unsigned fit = MAX(sbufBytesRemaining(dst) - headerSize - 1, 0) / entrySize;
+            const unsigned stages = (first < LOOP_PROFILE_STAGE_COUNT) ? MIN(LOOP_PROFILE_STAGE_COUNT - first, fit) : 0;
+
+            sbufWriteU8(dst, loopProfileIsActive());
+            sbufWriteU32(dst, loopProfileGetCyclesPerMicro());
+            sbufWriteU8(dst, LOOP_PROFILE_STAGE_COUNT);
+            sbufWriteU8(dst, LOOP_PROFILE_BUCKETS);
+            sbufWriteU8(dst, first);
+            sbufWriteU8(dst, stages);
+            for (unsigned i = first; i < first + stages; i++) {
+                const loopProfileStats_t *stats = loopProfileGetStats(i);
+                sbufWriteU32(dst, stats->count);
+                sbufWriteU32(dst, stats->count ? stats->min : 0);
+                sbufWriteU32(dst, loopProfileGetAverage(i));
+                sbufWriteU32(dst, stats->max);
+                for (int j = 0; j < LOOP_PROFILE_BUCKETS; j++) {
+                    sbufWriteU32(dst, stats->histogram[j]);
+                }
+            }
+        }
+        break;
+#endif
     case MSP_MULTIPLE_MSP:
         {
             uint8_t maxMSPs = 0;
@@ -2130,13 +2225,28 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
 
         // version 1.42
         if (sbufBytesRemaining(src) >= 2) {
-            motorConfigMutable()->motorPoleCount = sbufReadU8(src);
+            motorConfigMutable()->motorPoleCount[0] = MAX(sbufReadU8(src), MOTOR_POLE_COUNT_MIN);
 #if defined(USE_DSHOT_TELEMETRY)
             motorConfigMutable()->dev.useDshotTelemetry = sbufReadU8(src);
 #else
             sbufReadU8(src);
 #endif
         }
+
+        // HF3D:  Per-motor pole count, gear ratio and RPM source, clamped to the CLI ranges
+        if (sbufBytesRemaining(src) >= 1) {
+            const uint8_t count = sbufReadU8(src);
+            for (int i = 0; i < count && sbufBytesRemaining(src) >= 4; i++) {
+                const uint8_t poles = sbufReadU8(src);
+                const uint16_t gearRatio = sbufReadU16(src);
+                const uint8_t rpmSource = sbufReadU8(src);
+                if (i < MAX_SUPPORTED_MOTORS) {
+                    motorConfigMutable()->motorPoleCount[i] = MAX(poles, MOTOR_POLE_COUNT_MIN);
+                    motorConfigMutable()->motorGearRatio[i] = constrain(gearRatio, MOTOR_GEAR_RATIO_MIN, MOTOR_GEAR_RATIO_MAX);
+                    motorConfigMutable()->motorRpmSource[i] = (rpmSource <= RPM_SOURCE_NONE) ? rpmSource : RPM_SOURCE_AUTO;
+                }
+            }
+        }
         break;
 
 #ifdef USE_GPS
@@ -2215,6 +2325,66 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
 #endif
         break;
 
+    case MSP_SET_SERVO_CALIBRATION:
+#ifdef USE_SERVOS
+        {
+            // HF3D:  0 = stop, 1 = start, 2 = record the step, 3 = trim a servo (index, trim)
+            if (dataSize < 1) {
+                return MSP_RESULT_ERROR;
+            }
+            const uint8_t command = sbufReadU8(src);
+            switch (command) {
+            case 0:
+                servoCalibStop();
+                break;
+            case 1:
+                if (!servoCalibStart()) {
+                    return MSP_RESULT_ERROR;
+                }
+                break;
+            case 2:
+                if (servoCalibNext() == SERVO_CALIB_FAILED) {
+                    return MSP_RESULT_ERROR;
+                }
+                break;
+            case 3:
+                if (dataSize != 4) {
+                    return MSP_RESULT_ERROR;
+                }
+                i = sbufReadU8(src);
+                if (!servoCalibSetTrim(i, (int16_t)sbufReadU16(src))) {
+                    return MSP_RESULT_ERROR;
+                }
+                break;
+            default:
+                return MSP_RESULT_ERROR;
+            }
+        }
+#endif
+        break;
+
+    case MSP_SET_LOOP_PROFILE:
+#ifdef USE_LOOP_PROFILE
+        // HF3D:  0 = stop, 1 = start, 2 = reset
+        if (dataSize < 1) {
+            return MSP_RESULT_ERROR;
+        }
+        switch (sbufReadU8(src)) {
+        case 0:
+            loopProfileStop();
+            break;
+        case 1:
+            loopProfileStart();
+            break;
+        case 2:
+            loopProfileReset();
+            break;
+        default:
+            return MSP_RESULT_ERROR;
+        }
+#endif
+        break;
+
     case MSP_SET_SERVO_MIX_RULE:
 #ifdef USE_SERVOS
         i = sbufReadU8(src);
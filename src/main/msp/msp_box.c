@@ -96,6 +96,7 @@ static const box_t boxes[CHECKBOX_ITEM_COUNT] = {
     { BOXACROTRAINER, "ACRO TRAINER", 47 },
     { BOXVTXCONTROLDISABLE, "DISABLE VTX CONTROL", 48},
 //    { BOXLAUNCHCONTROL, "LAUNCH CONTROL", 49 },       // HF3D: Removed.
+    { BOXAUTOROTATION, "AUTOROTATION", 50 },            // HF3D
 };
 
 // mask of enabled IDs, calculated on startup based on enabled features. boxId_e is used as bit index
@@ -258,6 +259,9 @@ void initActiveBoxIds(void)
 
     BME(BOXPARALYZE);
 
+    // HF3D:  Governor autorotation bailout
+    BME(BOXAUTOROTATION);
+
 #ifdef USE_PINIOBOX
     // Turn BOXUSERx only if pinioBox facility monitors them, as the facility is the only BOXUSERx observer.
     // Note that pinioBoxConfig can be set to monitor any box.
@@ -284,6 +284,10 @@
 #define MSP_VTXTABLE_BAND        137    //out message         vtxTable band/channel data
 #define MSP_VTXTABLE_POWERLEVEL  138    //out message         vtxTable powerLevel data
 #define MSP_MOTOR_TELEMETRY      139    //out message         Per-motor telemetry data (RPM, packet stats, ESC temp, etc.)
+#define MSP_GOVERNOR             140    //out message         HF3D: Governor headspeed, setpoints, throttle, PID sum, feedforwards and status
+#define MSP_SERVO_CALIBRATION    141    //out message         HF3D: Swash servo calibration state, step, trims and pulses
+#define MSP_ACTUATOR_LOG         142    //out message         HF3D: Actuator snapshot log entries, from the given entry
+#define MSP_LOOP_PROFILE         143    //out message         HF3D: PID loop profiler stage statistics, from the given stage
 
 #define MSP_SET_RAW_RC           200    //in message          8 rc chan
 #define MSP_SET_RAW_GPS          201    //in message          fix, numsat, lat, lon, alt, speed
@@ -314,6 +318,8 @@
 #define MSP_SET_GPS_RESCUE_PIDS  226    //in message          GPS Rescues's throttleP and velocity PIDS + yaw P
 #define MSP_SET_VTXTABLE_BAND    227    //in message          set vtxTable band/channel data (one band at a time)
 #define MSP_SET_VTXTABLE_POWERLEVEL 228 //in message          set vtxTable powerLevel data (one powerLevel at a time)
+#define MSP_SET_SERVO_CALIBRATION 231   //in message          HF3D: Swash servo calibration start, stop, next step or servo trim
+#define MSP_SET_LOOP_PROFILE     232    //in message          HF3D: PID loop profiler stop, start or reset
 
 // #define MSP_BIND                 240    //in message          no param
 // #define MSP_ALARMS               242
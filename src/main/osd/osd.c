@@ -516,7 +516,7 @@ static void osdUpdateStats(void)
         if (stats.max_esc_temp < value) {
             stats.max_esc_temp = value;
         }
-        value = calcEscRpm(osdEscDataCombined->rpm);
+        value = calcEscRpm(0, osdEscDataCombined->rpm);
         if (stats.max_esc_rpm < value) {
             stats.max_esc_rpm = value;
         }
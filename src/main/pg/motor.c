@@ -33,7 +33,7 @@
 #include "pg/pg_ids.h"
 #include "pg/motor.h"
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 2);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig)
 {
@@ -72,7 +72,14 @@ void pgResetFn_motorConfig(motorConfig_t *motorConfig)
     }
 #endif
     
-    motorConfig->motorPoleCount = 14;   // Most brushless motors that we use for 5" miniquads are 14 poles
+    for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS; motorIndex++) {
+        motorConfig->motorPoleCount[motorIndex] = 14;   // Most brushless motors that we use for 5" miniquads are 14 poles
+        motorConfig->motorGearRatio[motorIndex] = 100;  // HF3D:  Direct drive
+        motorConfig->motorRpmSource[motorIndex] = RPM_SOURCE_AUTO;
+    }
+#if MAX_SUPPORTED_MOTORS > 1
+    motorConfig->motorPoleCount[1] = 12;                // HF3D:  Tail motor, as previously hardcoded for the OMP M2
+#endif
 
 #ifdef USE_DSHOT_BITBANG
     motorConfig->dev.useDshotBitbang = DSHOT_BITBANG_DEFAULT;
@@ -37,6 +37,18 @@ typedef enum {
     DSHOT_DMAR_AUTO
 } dshotDmar_e;
 
+// HF3D:  Source of the motor RPM data
+typedef enum {
+    RPM_SOURCE_AUTO = 0,            // DShot telemetry if enabled, otherwise ESC sensor
+    RPM_SOURCE_DSHOT_TELEMETRY,
+    RPM_SOURCE_ESC_SENSOR,
+    RPM_SOURCE_NONE,
+} rpmSource_e;
+
+#define MOTOR_POLE_COUNT_MIN    2
+#define MOTOR_GEAR_RATIO_MIN    100         // HF3D:  Motor turns per rotor turn * 100
+#define MOTOR_GEAR_RATIO_MAX    3000
+
 typedef struct motorDevConfig_s {
     uint16_t motorPwmRate;                  // The update rate of motor outputs (50-498Hz)
     uint8_t  motorPwmProtocol;              // Pwm Protocol
@@ -56,7 +68,9 @@ typedef struct motorConfig_s {
     uint16_t minthrottle;                   // Set the minimum throttle command sent to the ESC (Electronic Speed Controller). This is the minimum value that allow motors to run at a idle speed.
     uint16_t maxthrottle;                   // This is the maximum value for the ESCs at full power this value can be increased up to 2000
     uint16_t mincommand;                    // This is the value for the ESCs when they are not armed. In some cases, this value must be lowered down to 900 for some specific ESCs
-    uint8_t motorPoleCount;                // Magnetic poles in the motors for calculating actual RPM from eRPM provided by ESC telemetry
+    uint8_t motorPoleCount[MAX_SUPPORTED_MOTORS];   // Magnetic poles in the motors for calculating actual RPM from eRPM provided by ESC telemetry
+    uint16_t motorGearRatio[MAX_SUPPORTED_MOTORS];  // HF3D:  Motor turns per rotor turn * 100 (main motor: main rotor, tail motor: tail rotor)
+    uint8_t motorRpmSource[MAX_SUPPORTED_MOTORS];   // HF3D:  rpmSource_e
 } motorConfig_t;
 
 PG_DECLARE(motorConfig_t, motorConfig);
@@ -149,7 +149,9 @@
 #define PG_SDIO_PIN_CONFIG 550
 #define PG_PULLUP_CONFIG 551
 #define PG_PULLDOWN_CONFIG 552
-#define PG_BETAFLIGHT_END 552
+#define PG_GOVERNOR_LOAD_MAP 553      // HF3D
+#define PG_SERVO_CURVE 554            // HF3D
+#define PG_BETAFLIGHT_END 554
 
 
 // OSD configuration (subject to change)
@@ -53,6 +53,8 @@ typedef enum {
     CRSF_FRAMETYPE_MSP_RESP = 0x7B,  // reply with 58 byte chunked binary
     CRSF_FRAMETYPE_MSP_WRITE = 0x7C,  // write with 8 byte chunked binary (OpenTX outbound telemetry buffer limit)
     CRSF_FRAMETYPE_DISPLAYPORT_CMD = 0x7D, // displayport control command
+    // HF3D:  Custom frames
+    CRSF_FRAMETYPE_GOVERNOR = 0x88,   // governor status, see crsfFrameGovernor()
 } crsfFrameType_e;
 
 enum {
@@ -74,6 +76,7 @@ enum {
     CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE = 10,
     CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE = 22, // 11 bits per channel * 16 channels = 22 bytes.
     CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE = 6,
+    CRSF_FRAME_GOVERNOR_PAYLOAD_SIZE = 17,
 };
 
 enum {
@@ -120,6 +120,7 @@ static volatile uint8_t bufferPosition = 0;
 static serialPort_t *escSensorPort = NULL;
 
 static escSensorData_t escSensorData[MAX_SUPPORTED_MOTORS];
+static uint32_t escSensorFrameCount[MAX_SUPPORTED_MOTORS];     // HF3D:  Valid telemetry frames received
 
 static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
 static uint32_t escTriggerTimestamp;
@@ -210,6 +211,16 @@ uint16_t getEscSensorRPM(uint8_t motorNumber)
         return 0;
     }
 }
+
+// HF3D:  Number of valid telemetry frames received, counts a new frame even when the rpm didn't change
+uint32_t getEscSensorFrameCount(uint8_t motorNumber)
+{
+    if (motorNumber < getMotorCount()) {
+        return escSensorFrameCount[motorNumber];
+    } else {
+        return 0;
+    }
+}
 // ------- End of code to provide RPM data to rpm filter and spoolup/governor logic
 
 
@@ -366,13 +377,14 @@ static uint8_t decodeEscFrame(void)
         escSensorData[escSensorMotor].current = telemetryBuffer[3] << 8 | telemetryBuffer[4];
         escSensorData[escSensorMotor].consumption = telemetryBuffer[5] << 8 | telemetryBuffer[6];
         escSensorData[escSensorMotor].rpm = telemetryBuffer[7] << 8 | telemetryBuffer[8];
+        escSensorFrameCount[escSensorMotor]++;
 
         combinedDataNeedsUpdate = true;
 
         frameStatus = ESC_SENSOR_FRAME_COMPLETE;
 
         if (escSensorMotor < 4) {
-            DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
+            DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorMotor, escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
             DEBUG_SET(DEBUG_ESC_SENSOR_TMP, escSensorMotor, escSensorData[escSensorMotor].temperature);
         }
     } else {
@@ -599,11 +611,12 @@ void escSensorProcess(timeUs_t currentTimeUs)
                 escSensorData[escSensorMotor].voltage = voltage * 100;
                 escSensorData[escSensorMotor].current = current * 100;
                 escSensorData[escSensorMotor].rpm = rpm / 100;
+                escSensorFrameCount[escSensorMotor]++;
 
                 // HF3D TODO:  Add a debug_ESC parameter for Hobbywing (Packet #, RPM, FET Temp, BEC Temp)
                 // HF3D TODO:  Hopefully we're bringing ESC Voltage and Current into the logs permanently anyway.... and probably should bring ESC Temp in permanently too.
                 if (escSensorMotor < 4) {
-                    DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
+                    DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorMotor, escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
                     DEBUG_SET(DEBUG_ESC_SENSOR_TMP, escSensorMotor, escSensorData[escSensorMotor].temperature);
                 }
                 
@@ -642,8 +655,10 @@ void escSensorProcess(timeUs_t currentTimeUs)
     }
 }
 
-int calcEscRpm(int erpm)
+// HF3D:  Combined ESC data uses the main motor (motor 0) pole count
+int calcEscRpm(int motor, int erpm)
 {
-    return (erpm * 100) / (motorConfig()->motorPoleCount / 2);
+    const int poles = motorConfig()->motorPoleCount[(motor >= 0 && motor < MAX_SUPPORTED_MOTORS) ? motor : 0];
+    return (erpm * 100) / (poles / 2);
 }
 #endif
@@ -52,6 +52,7 @@ bool escSensorInit(void);
 void escSensorProcess(timeUs_t currentTime);
 // bool isEscSensorActive(void);
 uint16_t getEscSensorRPM(uint8_t motorNumber);
+uint32_t getEscSensorFrameCount(uint8_t motorNumber);
 
 #define ESC_SENSOR_COMBINED 255
 
@@ -62,4 +63,4 @@ uint8_t getNumberEscBytesRead(void);
 
 uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen);
 
-int calcEscRpm(int erpm);
+int calcEscRpm(int motor, int erpm);
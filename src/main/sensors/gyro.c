@@ -71,6 +71,7 @@
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "flight/gyroanalyse.h"
 #endif
+#include "flight/loop_profile.h"
 #include "flight/rpm_filter.h"
 
 #include "io/beeper.h"
@@ -1060,6 +1061,7 @@ static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSens
 
 FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
 {
+    LOOP_PROFILE_BEGIN(gyroStartCycles);
 
     switch (gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
@@ -1091,6 +1093,9 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
 #endif
     }
 
+    LOOP_PROFILE_END(LOOP_PROFILE_GYRO, gyroStartCycles);
+    LOOP_PROFILE_BEGIN(filterStartCycles);
+
     if (gyroDebugMode == DEBUG_NONE) {
         filterGyro();
     } else {
@@ -1103,6 +1108,8 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
     }
 #endif
 
+    LOOP_PROFILE_END(LOOP_PROFILE_FILTER, filterStartCycles);
+
     if (useDualGyroDebugging) {
         switch (gyroToUse) {
         case GYRO_CONFIG_USE_GYRO_1:
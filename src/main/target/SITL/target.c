@@ -334,6 +334,19 @@ uint32_t millis(void) {
     return millis64() & 0xFFFFFFFF;
 }
 
+// HF3D:  Cycle counter for the loop profiler, one cycle per nanosecond of real time
+uint32_t getCycleCounter(void) {
+    return nanos64_real() & 0xFFFFFFFF;
+}
+
+uint32_t clockCyclesToMicros(uint32_t clockCycles) {
+    return clockCycles / 1000;
+}
+
+uint32_t clockMicrosToCycles(uint32_t micros) {
+    return micros * 1000;
+}
+
 void microsleep(uint32_t usec) {
     struct timespec ts;
     ts.tv_sec = 0;
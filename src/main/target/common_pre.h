@@ -220,6 +220,8 @@
 #endif
 
 #if (FLASH_SIZE > 128)
+#define USE_ACTUATOR_LOG
+#define USE_LOOP_PROFILE
 #define USE_GYRO_OVERFLOW_CHECK
 #define USE_YAW_SPIN_RECOVERY
 #define USE_DSHOT_DMAR
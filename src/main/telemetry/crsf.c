@@ -48,7 +48,9 @@
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
+#include "flight/governor.h"
 #include "flight/imu.h"
+#include "flight/mixer.h"
 #include "flight/position.h"
 
 #include "io/displayport_crsf.h"
@@ -336,6 +338,41 @@ void crsfFrameDeviceInfo(sbuf_t *dst) {
     *lengthPtr = sbufPtr(dst) - lengthPtr;
 }
 
+/*
+0x88 Governor (HF3D custom frame)
+Payload:
+uint8_t     Destination
+uint8_t     Origin
+uint16_t    Headspeed ( rpm )
+uint16_t    Headspeed setpoint ( rpm )
+uint16_t    Rate limited headspeed setpoint ( rpm )
+uint16_t    Throttle ( % * 10 )
+int16_t     PID sum ( * 1000 )
+int16_t     Collective feedforward ( * 1000 )
+int16_t     Collective impulse feedforward ( * 1000 )
+int16_t     Cyclic feedforward ( * 1000 )
+uint8_t     Status flags ( governorStatusFlags_e )
+*/
+void crsfFrameGovernor(sbuf_t *dst)
+{
+    governorTelemetry_t governor;
+    governorGetTelemetry(mixerGetGovernorState(), &governor);
+
+    sbufWriteU8(dst, CRSF_FRAME_GOVERNOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_EXT_TYPE_CRC);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_GOVERNOR);
+    sbufWriteU8(dst, CRSF_ADDRESS_RADIO_TRANSMITTER);
+    sbufWriteU8(dst, CRSF_ADDRESS_FLIGHT_CONTROLLER);
+    sbufWriteU16BigEndian(dst, governor.headspeed);
+    sbufWriteU16BigEndian(dst, governor.setpoint);
+    sbufWriteU16BigEndian(dst, governor.setpointLimited);
+    sbufWriteU16BigEndian(dst, governor.throttle);
+    sbufWriteU16BigEndian(dst, governor.pidSum);
+    sbufWriteU16BigEndian(dst, governor.collectiveFF);
+    sbufWriteU16BigEndian(dst, governor.collectivePulseFF);
+    sbufWriteU16BigEndian(dst, governor.cyclicFF);
+    sbufWriteU8(dst, governor.status);
+}
+
 #if defined(USE_CRSF_CMS_TELEMETRY)
 
 static void crsfFrameDisplayPortRow(sbuf_t *dst, uint8_t row)
@@ -382,6 +419,9 @@ typedef enum {
 static uint8_t crsfScheduleCount;
 static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
 
+// HF3D:  The governor frame has its own rate, independent of the 10Hz frame schedule
+static timeDelta_t crsfGovernorIntervalUs;
+
 #if defined(USE_MSP_OVER_TELEMETRY)
 
 static bool mspReplyPending;
@@ -482,6 +522,12 @@ void initCrsfTelemetry(void)
     }
 #endif
     crsfScheduleCount = (uint8_t)index;
+
+    if (telemetryConfig()->crsf_gov_rate && getMotorCount() > 0 && mixerConfig()->gov_max_headspeed) {
+        crsfGovernorIntervalUs = 1000000 / telemetryConfig()->crsf_gov_rate;
+    } else {
+        crsfGovernorIntervalUs = 0;
+    }
  }
 
 bool checkCrsfTelemetryState(void)
@@ -573,6 +619,19 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     }
 #endif
 
+    if (crsfGovernorIntervalUs) {
+        static timeUs_t crsfGovernorLastTime;
+        if (cmpTimeUs(currentTimeUs, crsfGovernorLastTime) >= crsfGovernorIntervalUs) {
+            sbuf_t crsfPayloadBuf;
+            sbuf_t *dst = &crsfPayloadBuf;
+            crsfInitializeFrame(dst);
+            crsfFrameGovernor(dst);
+            crsfFinalize(dst);
+            crsfGovernorLastTime = currentTimeUs;
+            return;
+        }
+    }
+
     // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
     // Spread out scheduled frames evenly so each frame is sent at the same frequency.
     if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
@@ -603,6 +662,9 @@ int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
         crsfFrameGps(sbuf);
         break;
 #endif
+    case CRSF_FRAMETYPE_GOVERNOR:
+        crsfFrameGovernor(sbuf);
+        break;
     }
     const int frameSize = crsfFinalizeBuf(sbuf, frame);
     return frameSize;
@@ -655,7 +655,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_RPM        :
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm)/mixerGetGovGearRatio());
+                    smartPortSendPackage(id, calcEscRpm(0, escData->rpm)/mixerGetGovGearRatio());
                     *clearToSend = false;
                 }
                 break;
@@ -669,7 +669,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_RPM8       :
                 escData = getEscSensorData(id - FSSP_DATAID_RPM1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm));
+                    smartPortSendPackage(id, calcEscRpm(id - FSSP_DATAID_RPM1, escData->rpm));
                     *clearToSend = false;
                 }
                 break;
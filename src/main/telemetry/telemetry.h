@@ -87,6 +87,7 @@ typedef struct telemetryConfig_s {
     uint8_t flysky_sensors[IBUS_SENSOR_COUNT];
     uint16_t mavlink_mah_as_heading_divisor;
     uint32_t disabledSensors; // bit flags
+    uint8_t crsf_gov_rate;    // HF3D:  CRSF governor frame rate (Hz), 0 = off
 } telemetryConfig_t;
 
 PG_DECLARE(telemetryConfig_t, telemetryConfig);
@@ -384,6 +384,11 @@ void mspSerialAllocatePorts(void) {}
 uint32_t getArmingBeepTimeMicros(void) {return 0;}
 uint16_t getBatteryVoltageLatest(void) {return 0;}
 uint8_t getMotorCount(void) {return 4;}
+bool isBatteryVoltageConfigured(void) {return false;}
+float mixerGetGovVbatCompensation(void) {return 1.0f;}
+float mixerGetTailPrecompensation(void) {return 0.0f;}
+const governorState_t *mixerGetGovernorState(void) {return NULL;}
+void governorGetTelemetry(const governorState_t *, governorTelemetry_t *telemetry) {memset(telemetry, 0, sizeof(*telemetry));}
 bool areMotorsRunning(void) { return false; }
 bool IS_RC_MODE_ACTIVE(boxId_e) {return false;}
 bool isModeActivationConditionPresent(boxId_e) {return false;}
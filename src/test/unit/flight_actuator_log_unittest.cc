@@ -0,0 +1,85 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "flight/actuator_log.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void writeEntries(unsigned first, unsigned count)
+{
+    for (unsigned i = first; i < first + count; i++) {
+        actuatorLogEntry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.time = i;
+        entry.servo[0] = 1000 + i;
+        actuatorLogWrite(&entry);
+    }
+}
+
+TEST(ActuatorLogTest, KeepsOldestFirst)
+{
+    actuatorLogReset();
+    EXPECT_EQ(0u, actuatorLogGetCount());
+    EXPECT_EQ(NULL, actuatorLogGetEntry(0));
+
+    writeEntries(0, 10);
+    EXPECT_EQ(10u, actuatorLogGetCount());
+    EXPECT_EQ(0u, actuatorLogGetEntry(0)->time);
+    EXPECT_EQ(9u, actuatorLogGetEntry(9)->time);
+    EXPECT_EQ(NULL, actuatorLogGetEntry(10));
+}
+
+TEST(ActuatorLogTest, WrapsAround)
+{
+    actuatorLogReset();
+    writeEntries(0, ACTUATOR_LOG_SIZE * 2 + 7);
+
+    EXPECT_EQ((unsigned)ACTUATOR_LOG_SIZE, actuatorLogGetCount());
+    for (unsigned i = 0; i < ACTUATOR_LOG_SIZE; i++) {
+        EXPECT_EQ(ACTUATOR_LOG_SIZE + 7 + i, actuatorLogGetEntry(i)->time);
+    }
+}
+
+TEST(ActuatorLogTest, FrozenUntilReset)
+{
+    actuatorLogReset();
+    writeEntries(0, 20);
+    actuatorLogFreeze();
+    EXPECT_TRUE(actuatorLogIsFrozen());
+
+    writeEntries(20, 100);
+    EXPECT_EQ(20u, actuatorLogGetCount());
+    EXPECT_EQ(19u, actuatorLogGetEntry(19)->time);
+    EXPECT_EQ(1019, actuatorLogGetEntry(19)->servo[0]);
+
+    actuatorLogReset();
+    EXPECT_FALSE(actuatorLogIsFrozen());
+    EXPECT_EQ(0u, actuatorLogGetCount());
+}
@@ -0,0 +1,161 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/flat_piro.h"
+    #include "flight/mixer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// tan(5 degrees)
+#define TAN_5_DEG 0.0874887f
+
+// Hover collective upright and inverted, rcCommand units
+#define COLLECTIVE_UP 150
+#define COLLECTIVE_INVERTED -150
+
+TEST(FlatPiroTest, OffWithoutTilt)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CW, 0, 0);
+
+    EXPECT_FLOAT_EQ(0, flatPiroApply(&piro, 500, 0, COLLECTIVE_UP));
+    EXPECT_FLOAT_EQ(0, flatPiroApply(&piro, -500, 2000, COLLECTIVE_UP));
+}
+
+TEST(FlatPiroTest, ClockwiseRotor)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CW, 50, 0);
+
+    // Disc leans right, nose left yaw (positive) pitches nose down (positive)
+    EXPECT_NEAR(360 * TAN_5_DEG, flatPiroApply(&piro, 360, 0, COLLECTIVE_UP), 0.01f);
+    // Nose right yaw pitches nose up
+    EXPECT_NEAR(-360 * TAN_5_DEG, flatPiroApply(&piro, -360, 0, COLLECTIVE_UP), 0.01f);
+    EXPECT_FLOAT_EQ(0, flatPiroApply(&piro, 0, 0, COLLECTIVE_UP));
+}
+
+TEST(FlatPiroTest, CounterClockwiseRotor)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CCW, 50, 0);
+
+    // Disc leans left, all directions reverse
+    EXPECT_NEAR(-360 * TAN_5_DEG, flatPiroApply(&piro, 360, 0, COLLECTIVE_UP), 0.01f);
+    EXPECT_NEAR(360 * TAN_5_DEG, flatPiroApply(&piro, -360, 0, COLLECTIVE_UP), 0.01f);
+}
+
+TEST(FlatPiroTest, RotorDirectionsMirror)
+{
+    flatPiro_t cw;
+    flatPiro_t ccw;
+    flatPiroInit(&cw, ROTOR_DIR_CW, 120, 0);
+    flatPiroInit(&ccw, ROTOR_DIR_CCW, 120, 0);
+
+    for (float yaw = -1000; yaw <= 1000; yaw += 125) {
+        EXPECT_FLOAT_EQ(-flatPiroApply(&cw, yaw, 0, COLLECTIVE_UP), flatPiroApply(&ccw, yaw, 0, COLLECTIVE_UP));
+        EXPECT_FLOAT_EQ(-flatPiroApply(&cw, yaw, 0, COLLECTIVE_UP), flatPiroApply(&cw, -yaw, 0, COLLECTIVE_UP));
+    }
+}
+
+TEST(FlatPiroTest, TiltLimit)
+{
+    flatPiro_t limited;
+    flatPiro_t piro;
+    flatPiroInit(&limited, ROTOR_DIR_CW, 255, 0);
+    flatPiroInit(&piro, ROTOR_DIR_CW, FLAT_PIRO_TILT_MAX, 0);
+
+    EXPECT_FLOAT_EQ(flatPiroApply(&piro, 100, 0, COLLECTIVE_UP), flatPiroApply(&limited, 100, 0, COLLECTIVE_UP));
+}
+
+TEST(FlatPiroTest, HeadspeedScaling)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CW, 50, 2000);
+
+    const float reference = flatPiroApply(&piro, 360, 2000, COLLECTIVE_UP);
+    EXPECT_NEAR(360 * TAN_5_DEG, reference, 0.01f);
+
+    // Tail thrust goes up as the headspeed drops
+    EXPECT_NEAR(reference * 1.25f, flatPiroApply(&piro, 360, 1600, COLLECTIVE_UP), 0.01f);
+    EXPECT_NEAR(reference * 0.8f, flatPiroApply(&piro, 360, 2500, COLLECTIVE_UP), 0.01f);
+
+    // Ratio limits
+    EXPECT_NEAR(reference * FLAT_PIRO_HS_RATIO_MAX, flatPiroApply(&piro, 360, 500, COLLECTIVE_UP), 0.01f);
+    EXPECT_NEAR(reference * FLAT_PIRO_HS_RATIO_MIN, flatPiroApply(&piro, 360, 8000, COLLECTIVE_UP), 0.01f);
+
+    // Fixed lean without a headspeed measurement
+    EXPECT_FLOAT_EQ(reference, flatPiroApply(&piro, 360, 0, COLLECTIVE_UP));
+
+    // Both rotor and yaw directions scale the same way
+    flatPiroInit(&piro, ROTOR_DIR_CCW, 50, 2000);
+    EXPECT_NEAR(reference * 1.25f, flatPiroApply(&piro, -360, 1600, COLLECTIVE_UP), 0.01f);
+}
+
+TEST(FlatPiroTest, InvertedReversesLean)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CW, 50, 0);
+
+    // Upright the disc leans right, nose left yaw pitches nose down
+    EXPECT_NEAR(360 * TAN_5_DEG, flatPiroApply(&piro, 360, 0, COLLECTIVE_UP), 0.01f);
+    EXPECT_NEAR(-360 * TAN_5_DEG, flatPiroApply(&piro, -360, 0, COLLECTIVE_UP), 0.01f);
+
+    // Inverted the thrust reverses, so does the lean and the pitch rate needed to keep it
+    EXPECT_NEAR(-360 * TAN_5_DEG, flatPiroApply(&piro, 360, 0, COLLECTIVE_INVERTED), 0.01f);
+    EXPECT_NEAR(360 * TAN_5_DEG, flatPiroApply(&piro, -360, 0, COLLECTIVE_INVERTED), 0.01f);
+
+    // Counter-clockwise rotor inverted leans right again
+    flatPiroInit(&piro, ROTOR_DIR_CCW, 50, 0);
+    EXPECT_NEAR(360 * TAN_5_DEG, flatPiroApply(&piro, 360, 0, COLLECTIVE_INVERTED), 0.01f);
+
+    // Headspeed scaling applies inverted too
+    flatPiroInit(&piro, ROTOR_DIR_CW, 50, 2000);
+    EXPECT_NEAR(-360 * TAN_5_DEG * 1.25f, flatPiroApply(&piro, 360, 1600, COLLECTIVE_INVERTED), 0.01f);
+}
+
+TEST(FlatPiroTest, FadeAroundZeroCollective)
+{
+    flatPiro_t piro;
+    flatPiroInit(&piro, ROTOR_DIR_CW, 50, 0);
+
+    const float full = flatPiroApply(&piro, 360, 0, COLLECTIVE_UP);
+
+    // No lean without thrust
+    EXPECT_FLOAT_EQ(0, flatPiroApply(&piro, 360, 0, 0));
+
+    // Linear fade in either direction, full lean past the fade band
+    EXPECT_NEAR(full * 0.5f, flatPiroApply(&piro, 360, 0, FLAT_PIRO_COLLECTIVE_FADE / 2), 0.01f);
+    EXPECT_NEAR(-full * 0.5f, flatPiroApply(&piro, 360, 0, -FLAT_PIRO_COLLECTIVE_FADE / 2), 0.01f);
+    EXPECT_FLOAT_EQ(full, flatPiroApply(&piro, 360, 0, FLAT_PIRO_COLLECTIVE_FADE));
+    EXPECT_FLOAT_EQ(-full, flatPiroApply(&piro, 360, 0, -FLAT_PIRO_COLLECTIVE_FADE));
+    EXPECT_FLOAT_EQ(full, flatPiroApply(&piro, 360, 0, 500));
+}
@@ -0,0 +1,637 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/maths.h"
+
+    #include "flight/governor.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Trace sample, values are linearly interpolated between samples
+typedef struct traceSample_s {
+    float time;
+    float throttle;
+    float collective;
+} traceSample_t;
+
+// Hover, then collective pumps and a full positive / negative punch, then back to hover
+static const traceSample_t collectivePumpTrace[] = {
+    {  0.0f, 0.8f,    0.0f },
+    { 12.0f, 0.8f,    0.0f },
+    { 12.2f, 0.8f,   80.0f },
+    { 13.0f, 0.8f,   80.0f },
+    { 13.2f, 0.8f,  -60.0f },
+    { 14.0f, 0.8f,  -60.0f },
+    { 14.2f, 0.8f,  100.0f },
+    { 15.5f, 0.8f,  100.0f },
+    { 15.7f, 0.8f, -100.0f },
+    { 17.0f, 0.8f, -100.0f },
+    { 17.2f, 0.8f,    0.0f },
+    { 25.0f, 0.8f,    0.0f },
+};
+
+// Spool up, throttle hold for one second, then back to the governed throttle
+static const traceSample_t throttleHoldTrace[] = {
+    {  0.0f, 0.8f, 0.0f },
+    { 12.0f, 0.8f, 0.0f },
+    { 12.0f, 0.0f, 0.0f },
+    { 13.0f, 0.0f, 0.0f },
+    { 13.0f, 0.8f, 0.0f },
+    { 16.0f, 0.8f, 0.0f },
+};
+
+// Slow collective steps with long holds, used to learn the load map
+static const traceSample_t loadMapLearnTrace[] = {
+    {  0.0f, 0.8f,    0.0f },
+    { 12.0f, 0.8f,    0.0f },
+    { 13.0f, 0.8f,   25.0f },
+    { 18.0f, 0.8f,   25.0f },
+    { 19.0f, 0.8f,   50.0f },
+    { 24.0f, 0.8f,   50.0f },
+    { 25.0f, 0.8f,   75.0f },
+    { 30.0f, 0.8f,   75.0f },
+    { 31.0f, 0.8f,  100.0f },
+    { 36.0f, 0.8f,  100.0f },
+    { 37.0f, 0.8f,    0.0f },
+    { 42.0f, 0.8f,    0.0f },
+};
+
+#define TRACE_LENGTH(trace) (sizeof(trace) / sizeof((trace)[0]))
+
+// Simple first order rotor model: steady state headspeed is proportional to throttle, collective adds load
+#define PLANT_HEADSPEED_PER_THROTTLE    9000.0f
+#define PLANT_HEADSPEED_PER_COLLECTIVE  20.0f
+#define PLANT_TIME_CONSTANT             0.5f
+#define PLANT_CELL_COUNT                6
+#define PLANT_CELL_VOLTAGE              4.2f
+
+typedef struct plant_s {
+    float headspeed;
+    float sag;                  // battery voltage drop, fraction of a full pack
+} plant_t;
+
+static float plantVoltage(const plant_t *plant)
+{
+    return PLANT_CELL_COUNT * PLANT_CELL_VOLTAGE * (1.0f - plant->sag);
+}
+
+static float plantUpdate(plant_t *plant, float throttle, float collective, float dt)
+{
+    // Motor power follows the battery voltage
+    const float target = MAX(throttle * (1.0f - plant->sag) * PLANT_HEADSPEED_PER_THROTTLE - fabsf(collective) * PLANT_HEADSPEED_PER_COLLECTIVE, 0.0f);
+    plant->headspeed += (target - plant->headspeed) * dt / (PLANT_TIME_CONSTANT + dt);
+    return plant->headspeed;
+}
+
+static void traceSample(const traceSample_t *trace, size_t length, float time, float *throttle, float *collective)
+{
+    size_t i = 0;
+    while (i < length - 2 && time >= trace[i + 1].time) {
+        i++;
+    }
+    const float span = trace[i + 1].time - trace[i].time;
+    const float k = span > 0 ? constrainf((time - trace[i].time) / span, 0.0f, 1.0f) : 1.0f;
+    *throttle = trace[i].throttle + (trace[i + 1].throttle - trace[i].throttle) * k;
+    *collective = trace[i].collective + (trace[i + 1].collective - trace[i].collective) * k;
+}
+
+typedef struct replayResult_s {
+    float maxHeadspeedError;        // while spooled up and governing
+    float finalHeadspeed;
+    float finalThrottle;
+    float spooledUpTime;
+    bool spooledUp;
+} replayResult_t;
+
+static const governorSettings_t testSettings = {
+    .maxHeadspeed = 7000.0f,
+    .rampRate = 1.0f / 5.0f,
+    .Kp = 2.0f,
+    .Ki = 4.0f,
+    .cyclicKf = 0.0f,
+    .collectiveKf = 0.0018f,
+    .collectivePulseKf = 0.0f,
+    .baseThrottleCutoff = 0.05f,
+    .loadMapMode = GOV_LOAD_MAP_OFF,
+    .vbatCellVoltage = 0,
+    .bailoutRampRate = 1.0f / 0.7f,
+    .bailoutMinHeadspeed = 0.5f,
+};
+
+static replayResult_t replay(governorState_t *gov, plant_t *plant, const traceSample_t *trace, size_t length, float fromTime, float dt)
+{
+    replayResult_t result = { 0, 0, 0, -1.0f, false };
+    const float endTime = trace[length - 1].time;
+
+    for (float time = fromTime; time < endTime; time += dt) {
+        governorInputs_t inputs;
+        traceSample(trace, length, time, &inputs.throttle, &inputs.collective);
+        inputs.headspeed = plant->headspeed;
+        inputs.collectiveHPF = 0;
+        inputs.swashRing = 0;
+        inputs.voltage = plantVoltage(plant);
+        inputs.cellCount = PLANT_CELL_COUNT;
+        inputs.autorotation = false;
+        inputs.armed = true;
+
+        const float throttle = governorUpdate(gov, &inputs, dt);
+        EXPECT_GE(throttle, 0.0f);
+        EXPECT_LE(throttle, 1.0f);
+
+        plantUpdate(plant, throttle, inputs.collective, dt);
+
+        if (gov->spooledUp && result.spooledUpTime < 0) {
+            result.spooledUpTime = time;
+        }
+        if (gov->spooledUp && gov->setpointLimited > 0 && gov->setpointLimited >= gov->setpoint) {
+            result.maxHeadspeedError = MAX(result.maxHeadspeedError, fabsf(plant->headspeed - gov->setpoint) / gov->setpoint);
+        }
+        result.finalThrottle = throttle;
+    }
+    result.finalHeadspeed = plant->headspeed;
+    result.spooledUp = gov->spooledUp;
+
+    return result;
+}
+
+TEST(GovernorUnittest, TestSpoolupRampWithoutHeadspeed)
+{
+    // Governor not in use (no headspeed): throttle ramps at 1/spoolup_time per second regardless of loop rate
+    const float loopTimes[] = { 1.0f / 1000, 1.0f / 4000, 1.0f / 8000 };
+
+    for (float dt : loopTimes) {
+        governorState_t gov;
+        governorInit(&gov, &testSettings);
+
+        governorInputs_t inputs = { 0.4f, 0, 0, 0, 0, 0, 0, false, true };
+        const int loops = lrintf(1.0f / dt);
+        float throttle = 0;
+        for (int i = 0; i < loops; i++) {
+            throttle = governorUpdate(&gov, &inputs, dt);
+        }
+        EXPECT_NEAR(0.2f, throttle, 0.001f);
+        EXPECT_FALSE(gov.spooledUp);
+
+        // Ramp stops at the requested throttle
+        for (int i = 0; i < 2 * loops; i++) {
+            throttle = governorUpdate(&gov, &inputs, dt);
+        }
+        EXPECT_FLOAT_EQ(0.4f, throttle);
+    }
+}
+
+TEST(GovernorUnittest, TestDisarmedResetsSpoolup)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+
+    governorInputs_t inputs = { 0.4f, 0, 0, 0, 0, 0, 0, false, true };
+    for (int i = 0; i < 1000; i++) {
+        governorUpdate(&gov, &inputs, 0.001f);
+    }
+    EXPECT_NEAR(0.2f, gov.lastSpoolThrottle, 0.001f);
+
+    inputs.armed = false;
+    governorUpdate(&gov, &inputs, 0.001f);
+    EXPECT_EQ(0.0f, gov.lastSpoolThrottle);
+}
+
+TEST(GovernorUnittest, TestGovernorSpoolupAndHold)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+
+    const replayResult_t result = replay(&gov, &plant, collectivePumpTrace, 2, 0.0f, 1.0f / 8000);
+
+    EXPECT_TRUE(result.spooledUp);
+    // Throttle for 97% of 5600rpm on the model is ~0.6, so spool-up takes around 3 seconds at 5s ramp time
+    EXPECT_GT(result.spooledUpTime, 2.0f);
+    EXPECT_LT(result.spooledUpTime, 5.0f);
+    EXPECT_NEAR(5600.0f, result.finalHeadspeed, 5600.0f * 0.005f);
+    EXPECT_NEAR(5600.0f / PLANT_HEADSPEED_PER_THROTTLE, result.finalThrottle, 0.01f);
+}
+
+TEST(GovernorUnittest, TestCollectivePumpTraceReplay)
+{
+    const float loopTimes[] = { 1.0f / 1000, 1.0f / 8000 };
+    float finalThrottle[2];
+
+    for (int n = 0; n < 2; n++) {
+        governorState_t gov;
+        governorInit(&gov, &testSettings);
+        plant_t plant = { 0, 0 };
+
+        const replayResult_t result = replay(&gov, &plant, collectivePumpTrace, TRACE_LENGTH(collectivePumpTrace), 0.0f, loopTimes[n]);
+
+        EXPECT_TRUE(result.spooledUp);
+        // Headspeed held within 15% during the punches, and recovered at the end of the trace
+        EXPECT_LT(result.maxHeadspeedError, 0.15f);
+        EXPECT_NEAR(5600.0f, result.finalHeadspeed, 5600.0f * 0.005f);
+        finalThrottle[n] = result.finalThrottle;
+    }
+
+    // Same response regardless of loop rate
+    EXPECT_NEAR(finalThrottle[0], finalThrottle[1], 0.005f);
+}
+
+TEST(GovernorUnittest, TestDecimatedUpdateRate)
+{
+    // PID loop at 8kHz, governor updated every loop and at the ESC sensor rate (100Hz) with the output held in between
+    const float dt = 1.0f / 8000;
+    const int decimation[] = { 1, 80 };
+    float maxError[2];
+    float spooledUpTime[2];
+    float finalThrottle[2];
+
+    for (int n = 0; n < 2; n++) {
+        governorState_t gov;
+        governorInit(&gov, &testSettings);
+        plant_t plant = { 0, 0 };
+
+        governorInputs_t inputs = { 0, 0, 0, 0, 0, 0, 0, false, true };
+        const float endTime = collectivePumpTrace[TRACE_LENGTH(collectivePumpTrace) - 1].time;
+        float throttle = 0;
+        float updateTime = 0;
+        int loop = 0;
+
+        maxError[n] = 0;
+        spooledUpTime[n] = -1.0f;
+
+        for (float time = 0; time < endTime; time += dt, loop++) {
+            traceSample(collectivePumpTrace, TRACE_LENGTH(collectivePumpTrace), time, &inputs.throttle, &inputs.collective);
+            updateTime += dt;
+            if (loop % decimation[n] == 0) {
+                inputs.headspeed = plant.headspeed;
+                throttle = governorUpdate(&gov, &inputs, updateTime);
+                updateTime = 0;
+            }
+            plantUpdate(&plant, throttle, inputs.collective, dt);
+
+            if (gov.spooledUp && spooledUpTime[n] < 0) {
+                spooledUpTime[n] = time;
+            }
+            if (gov.spooledUp && gov.setpointLimited > 0 && gov.setpointLimited >= gov.setpoint) {
+                maxError[n] = MAX(maxError[n], fabsf(plant.headspeed - gov.setpoint) / gov.setpoint);
+            }
+        }
+        finalThrottle[n] = throttle;
+        EXPECT_NEAR(5600.0f, plant.headspeed, 5600.0f * 0.005f);
+    }
+
+    // Same response at the decimated rate
+    EXPECT_NEAR(spooledUpTime[0], spooledUpTime[1], 0.05f);
+    EXPECT_NEAR(maxError[0], maxError[1], 0.01f);
+    EXPECT_NEAR(finalThrottle[0], finalThrottle[1], 0.005f);
+}
+
+TEST(GovernorUnittest, TestThrottleHoldRecovery)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+    const float dt = 1.0f / 8000;
+
+    replay(&gov, &plant, throttleHoldTrace, 2, 0.0f, dt);
+    ASSERT_TRUE(gov.spooledUp);
+
+    // Throttle hold for one second: spool-up stays locked in, so the governor recovers without a slow spool-up
+    const replayResult_t result = replay(&gov, &plant, throttleHoldTrace, TRACE_LENGTH(throttleHoldTrace), 12.0f, dt);
+    EXPECT_TRUE(result.spooledUp);
+    EXPECT_NEAR(5600.0f, result.finalHeadspeed, 5600.0f * 0.01f);
+    EXPECT_LT(gov.spoolEndTimer, 5.0f);
+}
+
+// Autorotation: throttle cut while the headspeed decays towards decayRatio of the governed headspeed,
+//   then throttle back.  Returns the time to recover to within 2% of the setpoint.
+static float autorotationRecovery(governorState_t *gov, float decayRatio, bool autorotationMode, bool *bailout)
+{
+    const float dt = 1.0f / 4000;
+    plant_t plant = { 0, 0 };
+
+    replay(gov, &plant, collectivePumpTrace, 2, 0.0f, dt);
+    EXPECT_TRUE(gov->spooledUp);
+
+    governorInputs_t inputs = { 0, 0, 0, 0, 0, 0, 0, autorotationMode, true };
+    const float startHeadspeed = plant.headspeed;
+    for (float time = 0; time < 6.0f; time += dt) {
+        inputs.headspeed = startHeadspeed * (decayRatio + (1.0f - decayRatio) * expf(-time / 0.8f));
+        EXPECT_EQ(0.0f, governorUpdate(gov, &inputs, dt));
+    }
+    plant.headspeed = inputs.headspeed;
+
+    *bailout = false;
+    inputs.throttle = 0.8f;
+    for (float time = 0; time < 5.0f; time += dt) {
+        inputs.headspeed = plant.headspeed;
+        const float throttle = governorUpdate(gov, &inputs, dt);
+        plantUpdate(&plant, throttle, 0, dt);
+        *bailout |= gov->bailout;
+        if (fabsf(plant.headspeed - 5600.0f) < 5600.0f * 0.02f) {
+            return time;
+        }
+    }
+    return 5.0f;
+}
+
+TEST(GovernorUnittest, TestAutorotationBailout)
+{
+    governorState_t gov;
+    bool bailout;
+
+    // Headspeed decays to ~80% in the autorotation, bailout is detected when the throttle returns
+    governorInit(&gov, &testSettings);
+    const float bailoutRecovery = autorotationRecovery(&gov, 0.75f, false, &bailout);
+    EXPECT_TRUE(bailout);
+    EXPECT_FALSE(gov.bailout);
+    EXPECT_GT(gov.bailoutTime, 0.0f);
+    EXPECT_LT(gov.bailoutTime, 0.7f * 0.25f + 0.01f);    // setpoint ramp over the last ~20% of max headspeed
+    EXPECT_LT(bailoutRecovery, 1.0f);
+
+    // Same without the bailout ramp
+    governorSettings_t settings = testSettings;
+    settings.bailoutRampRate = 0;
+    governorInit(&gov, &settings);
+    const float normalRecovery = autorotationRecovery(&gov, 0.75f, false, &bailout);
+    EXPECT_FALSE(bailout);
+    EXPECT_GT(normalRecovery, bailoutRecovery * 1.5f);
+}
+
+TEST(GovernorUnittest, TestAutorotationBailoutModeBox)
+{
+    governorState_t gov;
+    bool bailout;
+
+    // Headspeed decayed below bailoutMinHeadspeed in a long autorotation, not detected as a bailout
+    governorInit(&gov, &testSettings);
+    autorotationRecovery(&gov, 0.35f, false, &bailout);
+    EXPECT_FALSE(bailout);
+
+    // Autorotation mode always bails out
+    governorInit(&gov, &testSettings);
+    const float recovery = autorotationRecovery(&gov, 0.35f, true, &bailout);
+    EXPECT_TRUE(bailout);
+    EXPECT_LT(gov.bailoutTime, 3.0f);
+    EXPECT_LT(recovery, 2.0f);
+}
+
+TEST(GovernorUnittest, TestNoBailoutOnFirstSpoolup)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+    const float dt = 1.0f / 1000;
+
+    // Rotor already turning at arming (e.g. re-arm after a ground reset), but never spooled up
+    plant.headspeed = 4000;
+    governorInputs_t inputs = { 0.8f, 0, 0, 0, 0, 0, 0, true, true };
+    for (float time = 0; time < 12.0f; time += dt) {
+        inputs.headspeed = plant.headspeed;
+        plantUpdate(&plant, governorUpdate(&gov, &inputs, dt), 0, dt);
+        EXPECT_FALSE(gov.bailout);
+    }
+    EXPECT_TRUE(gov.spooledUp);
+}
+
+TEST(GovernorUnittest, TestSpoolupResetAfterLowHeadspeed)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+    const float dt = 1.0f / 1000;
+
+    replay(&gov, &plant, throttleHoldTrace, 2, 0.0f, dt);
+    ASSERT_TRUE(gov.spooledUp);
+
+    // Throttle cut and rotor stopped: still spooled up within the lock time, reset after it
+    governorInputs_t inputs = { 0, 0, 0, 0, 0, 0, 0, false, true };
+    for (int i = 0; i < 2000; i++) {
+        governorUpdate(&gov, &inputs, dt);
+    }
+    EXPECT_TRUE(gov.spooledUp);
+    for (int i = 0; i < 2000; i++) {
+        governorUpdate(&gov, &inputs, dt);
+    }
+    EXPECT_FALSE(gov.spooledUp);
+}
+
+TEST(GovernorUnittest, TestHeadspeedLossFallsBackToThrottle)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+    const float dt = 1.0f / 1000;
+
+    replay(&gov, &plant, throttleHoldTrace, 2, 0.0f, dt);
+    ASSERT_TRUE(gov.spooledUp);
+
+    // RPM signal lost: governor is disabled and the requested throttle is passed through
+    governorInputs_t inputs = { 0.8f, 0, 0, 0, 0, 0, 0, false, true };
+    const float throttle = governorUpdate(&gov, &inputs, dt);
+    EXPECT_EQ(0.0f, gov.setpoint);
+    EXPECT_FLOAT_EQ(0.8f, throttle);
+    EXPECT_TRUE(gov.spooledUp);
+}
+
+TEST(GovernorUnittest, TestLoadMapStoreRoundTrip)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+
+    governorLoadMap_t map = { GOV_LOAD_MAP_ON, { { 0 } } };
+    for (int i = 0; i < GOV_LOAD_MAP_HEADSPEED_POINTS; i++) {
+        for (int j = 0; j < GOV_LOAD_MAP_COLLECTIVE_POINTS; j++) {
+            map.throttle[i][j] = 100 + i * 10 + j;
+        }
+    }
+    map.throttle[0][0] = 0;
+
+    governorLoadMapLoad(&gov, &map);
+    EXPECT_FLOAT_EQ(101 / GOV_LOAD_MAP_SCALE, gov.loadMap[0][1]);
+    EXPECT_EQ(0.0f, gov.loadMap[0][0]);
+
+    governorLoadMap_t stored = { GOV_LOAD_MAP_ON, { { 0 } } };
+    EXPECT_FALSE(governorLoadMapStore(&gov, &stored));
+    EXPECT_EQ(0, memcmp(map.throttle, stored.throttle, sizeof(map.throttle)));
+}
+
+TEST(GovernorUnittest, TestLoadMapClampedOnLoad)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+
+    governorLoadMap_t map = { GOV_LOAD_MAP_ON, { { 0 } } };
+    map.throttle[2][3] = 255;
+
+    governorLoadMapLoad(&gov, &map);
+    EXPECT_FLOAT_EQ(1.0f, gov.loadMap[2][3]);
+
+    governorLoadMap_t stored = { GOV_LOAD_MAP_ON, { { 0 } } };
+    governorLoadMapStore(&gov, &stored);
+    EXPECT_EQ(GOV_LOAD_MAP_THROTTLE_MAX, stored.throttle[2][3]);
+}
+
+TEST(GovernorUnittest, TestLoadMapNotLearnedWhenOff)
+{
+    governorState_t gov;
+    governorInit(&gov, &testSettings);
+    plant_t plant = { 0, 0 };
+
+    replay(&gov, &plant, loadMapLearnTrace, TRACE_LENGTH(loadMapLearnTrace), 0.0f, 1.0f / 1000);
+
+    governorLoadMap_t map = { GOV_LOAD_MAP_OFF, { { 0 } } };
+    EXPECT_FALSE(governorLoadMapStore(&gov, &map));
+    EXPECT_FALSE(gov.loadMapValid);
+}
+
+TEST(GovernorUnittest, TestLoadMapLearnAndReplay)
+{
+    const float dt = 1.0f / 4000;
+
+    // Learning flight
+    governorSettings_t settings = testSettings;
+    settings.loadMapMode = GOV_LOAD_MAP_LEARN;
+
+    governorState_t gov;
+    governorInit(&gov, &settings);
+    plant_t plant = { 0, 0 };
+
+    const replayResult_t learn = replay(&gov, &plant, loadMapLearnTrace, TRACE_LENGTH(loadMapLearnTrace), 0.0f, dt);
+    EXPECT_LT(learn.maxHeadspeedError, 0.10f);
+    EXPECT_TRUE(gov.loadMapValid);
+
+    governorLoadMap_t map = { GOV_LOAD_MAP_ON, { { 0 } } };
+    EXPECT_TRUE(governorLoadMapStore(&gov, &map));
+
+    // Learned points at 80% headspeed match the steady state throttle of the model
+    for (int j = 0; j < GOV_LOAD_MAP_COLLECTIVE_POINTS; j += 5) {
+        const float expected = (5600.0f + j * 10.0f * PLANT_HEADSPEED_PER_COLLECTIVE) / PLANT_HEADSPEED_PER_THROTTLE;
+        EXPECT_NEAR(expected, map.throttle[3][j] / GOV_LOAD_MAP_SCALE, 0.02f);
+    }
+
+    // Collective punches without and with the learned map
+    governorInit(&gov, &testSettings);
+    plant.headspeed = 0;
+    const replayResult_t linear = replay(&gov, &plant, collectivePumpTrace, TRACE_LENGTH(collectivePumpTrace), 0.0f, dt);
+
+    settings.loadMapMode = GOV_LOAD_MAP_ON;
+    governorInit(&gov, &settings);
+    governorLoadMapLoad(&gov, &map);
+    plant.headspeed = 0;
+    const replayResult_t mapped = replay(&gov, &plant, collectivePumpTrace, TRACE_LENGTH(collectivePumpTrace), 0.0f, dt);
+
+    EXPECT_TRUE(gov.loadMapValid);
+    EXPECT_NEAR(5600.0f, mapped.finalHeadspeed, 5600.0f * 0.005f);
+    EXPECT_LT(mapped.maxHeadspeedError, linear.maxHeadspeedError * 0.25f);
+
+    // Not learning, so the map is unchanged
+    EXPECT_FALSE(governorLoadMapStore(&gov, &map));
+}
+
+TEST(GovernorUnittest, TestVbatCompensationFactor)
+{
+    governorSettings_t settings = testSettings;
+    settings.vbatCellVoltage = PLANT_CELL_VOLTAGE;
+
+    governorState_t gov;
+    governorInit(&gov, &settings);
+
+    // Starts from the first reading, no filter ramp from zero
+    governorInputs_t inputs = { 0, 0, 0, 0, 0, 6 * 4.2f, 6, false, true };
+    governorUpdate(&gov, &inputs, 0.001f);
+    EXPECT_FLOAT_EQ(1.0f, gov.vbatCompensation);
+
+    // Filtered, settles on the voltage ratio
+    inputs.voltage = 6 * 3.7f;
+    governorUpdate(&gov, &inputs, 0.001f);
+    EXPECT_GT(gov.vbatCompensation, 1.0f);
+    EXPECT_LT(gov.vbatCompensation, 1.01f);
+    for (int i = 0; i < 5000; i++) {
+        governorUpdate(&gov, &inputs, 0.001f);
+    }
+    EXPECT_NEAR(4.2f / 3.7f, gov.vbatCompensation, 0.001f);
+
+    // Limited
+    inputs.voltage = 6 * 2.0f;
+    for (int i = 0; i < 5000; i++) {
+        governorUpdate(&gov, &inputs, 0.001f);
+    }
+    EXPECT_FLOAT_EQ(1.33f, gov.vbatCompensation);
+
+    // No voltage or cell count
+    inputs.cellCount = 0;
+    governorUpdate(&gov, &inputs, 0.001f);
+    EXPECT_FLOAT_EQ(1.0f, gov.vbatCompensation);
+}
+
+TEST(GovernorUnittest, TestVbatCompensationHoldsHeadspeed)
+{
+    const float dt = 1.0f / 4000;
+    float maxError[2];
+    float baseThrottleChange[2];
+
+    for (int n = 0; n < 2; n++) {
+        governorSettings_t settings = testSettings;
+        settings.vbatCellVoltage = n ? PLANT_CELL_VOLTAGE : 0;
+
+        governorState_t gov;
+        governorInit(&gov, &settings);
+        plant_t plant = { 0, 0 };
+
+        replay(&gov, &plant, collectivePumpTrace, 2, 0.0f, dt);
+        ASSERT_TRUE(gov.spooledUp);
+
+        governorInputs_t inputs = { 0.8f, 0, 0, 0, 0, 0, PLANT_CELL_COUNT, false, true };
+        float startBaseThrottle = 0;
+        maxError[n] = 0;
+
+        // Settle in hover, then the pack sags by 15% over 30 seconds
+        for (float time = -20.0f; time < 30.0f; time += dt) {
+            plant.sag = 0.15f * MAX(time, 0.0f) / 30.0f;
+            inputs.headspeed = plant.headspeed;
+            inputs.voltage = plantVoltage(&plant);
+            const float throttle = governorUpdate(&gov, &inputs, dt);
+            plantUpdate(&plant, throttle, inputs.collective, dt);
+            if (time < 0) {
+                startBaseThrottle = gov.baseThrottle;
+            } else {
+                maxError[n] = MAX(maxError[n], fabsf(plant.headspeed - 5600.0f) / 5600.0f);
+            }
+        }
+        EXPECT_NEAR(5600.0f, plant.headspeed, 5600.0f * 0.005f);
+        baseThrottleChange[n] = fabsf(gov.baseThrottle - startBaseThrottle);
+    }
+
+    // Feedforward follows the pack voltage, so the controller doesn't have to chase the sag
+    EXPECT_LT(maxError[1], maxError[0] * 0.5f);
+
+    // Base throttle stays in full pack terms
+    EXPECT_LT(baseThrottleChange[1], 0.005f);
+    EXPECT_GT(baseThrottleChange[0], 0.05f);
+}
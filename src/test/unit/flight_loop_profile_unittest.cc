@@ -0,0 +1,113 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "flight/loop_profile.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(LoopProfileTest, RecordsOnlyWhileRunning)
+{
+    loopProfileInit(100);
+    EXPECT_FALSE(loopProfileIsActive());
+
+    loopProfileRecord(LOOP_PROFILE_PID, 500);
+    EXPECT_EQ(0u, loopProfileGetStats(LOOP_PROFILE_PID)->count);
+
+    loopProfileStart();
+    EXPECT_TRUE(loopProfileIsActive());
+    loopProfileRecord(LOOP_PROFILE_PID, 500);
+    EXPECT_EQ(1u, loopProfileGetStats(LOOP_PROFILE_PID)->count);
+
+    loopProfileStop();
+    loopProfileRecord(LOOP_PROFILE_PID, 500);
+    EXPECT_EQ(1u, loopProfileGetStats(LOOP_PROFILE_PID)->count);
+}
+
+TEST(LoopProfileTest, KeepsMinAverageMax)
+{
+    loopProfileInit(100);
+    loopProfileStart();
+    EXPECT_EQ(0u, loopProfileGetAverage(LOOP_PROFILE_MIXER));
+
+    loopProfileRecord(LOOP_PROFILE_MIXER, 300);
+    loopProfileRecord(LOOP_PROFILE_MIXER, 100);
+    loopProfileRecord(LOOP_PROFILE_MIXER, 800);
+
+    const loopProfileStats_t *stats = loopProfileGetStats(LOOP_PROFILE_MIXER);
+    EXPECT_EQ(3u, stats->count);
+    EXPECT_EQ(100u, stats->min);
+    EXPECT_EQ(800u, stats->max);
+    EXPECT_EQ(400u, loopProfileGetAverage(LOOP_PROFILE_MIXER));
+
+    // Other stages untouched
+    EXPECT_EQ(0u, loopProfileGetStats(LOOP_PROFILE_MOTOR)->count);
+}
+
+TEST(LoopProfileTest, HistogramBuckets)
+{
+    loopProfileInit(100);
+    loopProfileStart();
+
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 99);          // 0us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 100);         // 1us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 399);         // 3us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 400);         // 4us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 12500);       // 125us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, 25600);       // 256us
+    loopProfileRecord(LOOP_PROFILE_TOTAL, UINT32_MAX);
+
+    const loopProfileStats_t *stats = loopProfileGetStats(LOOP_PROFILE_TOTAL);
+    EXPECT_EQ(1u, stats->histogram[0]);
+    EXPECT_EQ(1u, stats->histogram[1]);
+    EXPECT_EQ(1u, stats->histogram[2]);
+    EXPECT_EQ(1u, stats->histogram[3]);
+    EXPECT_EQ(1u, stats->histogram[7]);
+    EXPECT_EQ(0u, stats->histogram[8]);
+    EXPECT_EQ(2u, stats->histogram[LOOP_PROFILE_BUCKETS - 1]);
+    EXPECT_EQ(UINT32_MAX, stats->max);
+}
+
+TEST(LoopProfileTest, ResetKeepsRunning)
+{
+    loopProfileInit(100);
+    loopProfileStart();
+    loopProfileRecord(LOOP_PROFILE_GYRO, 250);
+
+    loopProfileReset();
+    EXPECT_TRUE(loopProfileIsActive());
+
+    const loopProfileStats_t *stats = loopProfileGetStats(LOOP_PROFILE_GYRO);
+    EXPECT_EQ(0u, stats->count);
+    EXPECT_EQ(0u, stats->max);
+    EXPECT_EQ(0u, stats->histogram[2]);
+
+    loopProfileRecord(LOOP_PROFILE_GYRO, 150);
+    EXPECT_EQ(150u, stats->min);
+    EXPECT_EQ(150u, stats->max);
+}
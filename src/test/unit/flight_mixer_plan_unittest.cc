@@ -0,0 +1,195 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/mixer_plan.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_DSHOT_MIN_THROTTLE     48
+#define TEST_DSHOT_MAX_THROTTLE     2047
+#define TEST_DSHOT_IDLE_OUTPUT      (TEST_DSHOT_MIN_THROTTLE + 110)     // 5.5% dshot_idle_value
+#define TEST_DSHOT_DISARM_OUTPUT    0
+#define TEST_PWM_MIN_COMMAND        1000
+#define TEST_PWM_MIN_THROTTLE       1070
+#define TEST_PWM_MAX_THROTTLE       2000
+
+// Per-loop state seen by the reference (pre-plan) motor output stage
+static bool testDshot;
+static bool testFailsafe;
+static float testDisarmOutput;
+static float testOutputHigh;
+static float testRangeMin;
+static float testRangeMax;
+
+static bool isMotorProtocolDshot(void) { return testDshot; }
+static bool failsafeIsActive(void) { return testFailsafe; }
+
+// The main and tail motor output stage as it was before the plan, including the integer clamp
+static float referenceMainMotor(float throttle)
+{
+    float motorOutput;
+    if (isMotorProtocolDshot()) {
+        motorOutput = TEST_DSHOT_MIN_THROTTLE + (testOutputHigh - TEST_DSHOT_MIN_THROTTLE) * throttle;
+    } else {
+        motorOutput = testDisarmOutput + (testOutputHigh - testDisarmOutput) * throttle;
+    }
+
+    if (failsafeIsActive()) {
+        if (isMotorProtocolDshot()) {
+            motorOutput = (motorOutput < TEST_DSHOT_MIN_THROTTLE) ? testDisarmOutput : motorOutput;
+        }
+        motorOutput = constrain(motorOutput, testDisarmOutput, testRangeMax);
+    } else {
+        if (isMotorProtocolDshot()) {
+            motorOutput = constrain(motorOutput, TEST_DSHOT_MIN_THROTTLE, testRangeMax);
+        } else {
+            motorOutput = constrain(motorOutput, testDisarmOutput, testRangeMax);
+        }
+    }
+    return motorOutput;
+}
+
+static float referenceTailMotor(float motorOutput, float mainMotorThrottle)
+{
+    if (failsafeIsActive()) {
+        if (isMotorProtocolDshot()) {
+            motorOutput = (motorOutput < testRangeMin) ? testDisarmOutput : motorOutput;
+        }
+        motorOutput = constrain(motorOutput, testDisarmOutput, testRangeMax);
+    } else {
+        if (isMotorProtocolDshot()) {
+            if (mainMotorThrottle > 0.0f) {
+                motorOutput = constrain(motorOutput, testRangeMin, testRangeMax);
+            } else {
+                motorOutput = constrain(motorOutput, TEST_DSHOT_MIN_THROTTLE, testRangeMax);
+            }
+        } else {
+            if (mainMotorThrottle > 0.0f) {
+                motorOutput = constrain(motorOutput, testRangeMin, testRangeMax);
+            } else {
+                motorOutput = constrain(motorOutput, testDisarmOutput, testRangeMax);
+            }
+        }
+    }
+    return motorOutput;
+}
+
+static void setupOutput(bool dshot, bool failsafe)
+{
+    testDshot = dshot;
+    testFailsafe = failsafe;
+    if (dshot) {
+        testDisarmOutput = TEST_DSHOT_DISARM_OUTPUT;
+        testOutputHigh = TEST_DSHOT_MAX_THROTTLE;
+        testRangeMin = TEST_DSHOT_IDLE_OUTPUT;
+    } else {
+        testDisarmOutput = TEST_PWM_MIN_COMMAND;
+        testOutputHigh = TEST_PWM_MAX_THROTTLE;
+        testRangeMin = TEST_PWM_MIN_THROTTLE;
+    }
+    testRangeMax = testOutputHigh;
+}
+
+static void buildPlan(mixerPlan_t *plan)
+{
+    const mixerPlanInputs_t inputs = {
+        .dshot = testDshot,
+        .failsafe = testFailsafe,
+        .disarmOutput = testDisarmOutput,
+        .dshotMinOutput = TEST_DSHOT_MIN_THROTTLE,
+        .outputHigh = testOutputHigh,
+        .rangeMin = testRangeMin,
+        .rangeMax = testRangeMax,
+    };
+    mixerPlanBuild(plan, &inputs);
+}
+
+TEST(MixerPlanTest, MatchesReferenceOutputStage)
+{
+    for (int dshot = 0; dshot <= 1; dshot++) {
+        for (int failsafe = 0; failsafe <= 1; failsafe++) {
+            setupOutput(dshot, failsafe);
+
+            mixerPlan_t plan;
+            buildPlan(&plan);
+
+            // Main motor over the full throttle range
+            for (int i = 0; i <= 1000; i++) {
+                const float throttle = i / 1000.0f;
+                EXPECT_EQ((int)referenceMainMotor(throttle), (int)mixerPlanMainMotor(&plan, throttle))
+                    << "dshot " << dshot << " failsafe " << failsafe << " throttle " << throttle;
+            }
+
+            // Tail motor, including outputs below the reserved range and above the top end
+            for (int i = -500; i <= 2500; i++) {
+                const float output = i;
+                for (int running = 0; running <= 1; running++) {
+                    const float mainMotorThrottle = running ? 0.5f : 0.0f;
+                    EXPECT_EQ((int)referenceTailMotor(output, mainMotorThrottle), (int)mixerPlanTailMotor(&plan, output, running))
+                        << "dshot " << dshot << " failsafe " << failsafe << " running " << running << " output " << output;
+                }
+            }
+        }
+    }
+}
+
+TEST(MixerPlanTest, MainMotorStopsAtZeroThrottle)
+{
+    mixerPlan_t plan;
+
+    // The idle offset must never keep the main motor spinning
+    setupOutput(true, false);
+    buildPlan(&plan);
+    EXPECT_FLOAT_EQ(TEST_DSHOT_MIN_THROTTLE, mixerPlanMainMotor(&plan, 0.0f));
+    EXPECT_FLOAT_EQ(TEST_DSHOT_MAX_THROTTLE, mixerPlanMainMotor(&plan, 1.0f));
+
+    setupOutput(false, false);
+    buildPlan(&plan);
+    EXPECT_FLOAT_EQ(TEST_PWM_MIN_COMMAND, mixerPlanMainMotor(&plan, 0.0f));
+
+    // Tail motor only idles while the main motor runs
+    setupOutput(true, false);
+    buildPlan(&plan);
+    EXPECT_FLOAT_EQ(TEST_DSHOT_MIN_THROTTLE, mixerPlanTailMotor(&plan, 0.0f, false));
+    EXPECT_FLOAT_EQ(TEST_DSHOT_IDLE_OUTPUT, mixerPlanTailMotor(&plan, 0.0f, true));
+}
+
+TEST(MixerPlanTest, FailsafeAvoidsDshotReservedRange)
+{
+    mixerPlan_t plan;
+
+    setupOutput(true, true);
+    buildPlan(&plan);
+
+    // Tail outputs below the idle range go to the disarm value instead of a DShot command
+    EXPECT_FLOAT_EQ(TEST_DSHOT_DISARM_OUTPUT, mixerPlanTailMotor(&plan, TEST_DSHOT_MIN_THROTTLE - 10, true));
+    EXPECT_FLOAT_EQ(TEST_DSHOT_DISARM_OUTPUT, mixerPlanTailMotor(&plan, TEST_DSHOT_IDLE_OUTPUT - 1, true));
+    EXPECT_FLOAT_EQ(TEST_DSHOT_IDLE_OUTPUT, mixerPlanTailMotor(&plan, TEST_DSHOT_IDLE_OUTPUT, false));
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/servo_calib.h"
+    #include "flight/swash.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const int16_t angles120[SWASH_SERVO_COUNT] = { 240, 120, 0 };
+
+TEST(ServoCalibTest, GridTravelFollowsSwashPlane)
+{
+    for (int step = 0; step < SERVO_CALIB_STEPS; step++) {
+        float travel[SWASH_SERVO_COUNT];
+        servoCalibTravel(SWASH_TYPE_120, angles120, step, travel);
+
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            const double angle = angles120[i] * M_PI / 180.0;
+            const double expected = servoCalibGrid[step][SWASH_INPUT_COLLECTIVE] +
+                servoCalibGrid[step][SWASH_INPUT_ROLL] * sin(angle) +
+                servoCalibGrid[step][SWASH_INPUT_PITCH] * cos(angle);
+            EXPECT_NEAR(expected, travel[i], 1e-3) << "step " << step << " servo " << i;
+        }
+    }
+}
+
+TEST(ServoCalibTest, RecoversCentreRateAndDirection)
+{
+    // Servos with off centre middles, odd rates and one reversed servo, trimmed to within 1us at each step
+    const float middle[SWASH_SERVO_COUNT] = { 1512, 1488, 1530 };
+    const float scale[SWASH_SERVO_COUNT] = { 0.92f, -1.07f, 1.15f };
+    const float noise[SERVO_CALIB_STEPS] = { 0.5f, -1.0f, 0.8f, -0.3f, 1.0f };
+
+    float travel[SERVO_CALIB_STEPS][SWASH_SERVO_COUNT];
+    for (int step = 0; step < SERVO_CALIB_STEPS; step++) {
+        servoCalibTravel(SWASH_TYPE_120, angles120, step, travel[step]);
+    }
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        float t[SERVO_CALIB_STEPS];
+        float pulse[SERVO_CALIB_STEPS];
+        for (int step = 0; step < SERVO_CALIB_STEPS; step++) {
+            t[step] = travel[step][i];
+            pulse[step] = middle[i] + scale[i] * t[step] + noise[step];
+        }
+
+        servoCalibFit_t fit;
+        ASSERT_TRUE(servoCalibSolve(t, pulse, SERVO_CALIB_STEPS, &fit)) << "servo " << i;
+        EXPECT_NEAR(middle[i], fit.middle, 1.0f) << "servo " << i;
+        EXPECT_NEAR(scale[i], fit.scale, 0.01f) << "servo " << i;
+    }
+}
+
+TEST(ServoCalibTest, FailsWithoutTravel)
+{
+    const float travel[SERVO_CALIB_STEPS] = { 0, 0, 0, 0, 0 };
+    const float pulse[SERVO_CALIB_STEPS] = { 1500, 1510, 1490, 1500, 1500 };
+    servoCalibFit_t fit;
+    EXPECT_FALSE(servoCalibSolve(travel, pulse, SERVO_CALIB_STEPS, &fit));
+
+    // Servo that was never trimmed away from one pulse didn't move at all
+    const float travel2[SERVO_CALIB_STEPS] = { 0, 250, -250, 100, -100 };
+    const float pulse2[SERVO_CALIB_STEPS] = { 1500, 1500, 1500, 1500, 1500 };
+    EXPECT_FALSE(servoCalibSolve(travel2, pulse2, SERVO_CALIB_STEPS, &fit));
+    EXPECT_FALSE(servoCalibSolve(travel2, pulse2, 1, &fit));
+}
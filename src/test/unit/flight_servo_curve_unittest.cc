@@ -0,0 +1,117 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/servo_curve.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(ServoCurveTest, DefaultIsStraightLine)
+{
+    servoCurve_t curve;
+    servoCurveReset(&curve);
+
+    servoCurveTable_t table;
+    servoCurveBuild(&table, &curve);
+
+    EXPECT_FALSE(table.active);
+    for (int x = -600; x <= 600; x += 5) {
+        EXPECT_NEAR((float)x, servoCurveApply(&table, x), 1e-3f);
+    }
+}
+
+TEST(ServoCurveTest, MatchesTableSearch)
+{
+    const servoCurve_t curve = { { -520, -390, -270, -130, 10, 140, 260, 400, 530 } };
+
+    servoCurveTable_t table;
+    servoCurveBuild(&table, &curve);
+    EXPECT_TRUE(table.active);
+
+    float x[SERVO_CURVE_POINTS];
+    float y[SERVO_CURVE_POINTS];
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        x[i] = i * SERVO_CURVE_STEP - SERVO_CURVE_RANGE;
+        y[i] = curve.point[i];
+    }
+
+    for (float offset = -SERVO_CURVE_RANGE; offset <= SERVO_CURVE_RANGE; offset += 0.7f) {
+        EXPECT_NEAR(interpolateTablef(offset, x, y, SERVO_CURVE_POINTS), servoCurveApply(&table, offset), 1e-3f) << "offset " << offset;
+    }
+
+    // The end segments are extended beyond the table
+    EXPECT_NEAR(-520 - 130 * 0.4f, servoCurveApply(&table, -SERVO_CURVE_RANGE - 50), 1e-3f);
+    EXPECT_NEAR(530 + 130 * 0.4f, servoCurveApply(&table, SERVO_CURVE_RANGE + 50), 1e-3f);
+}
+
+TEST(ServoCurveTest, ArmCurveGivesLinearLinkTravel)
+{
+    const float armAngle = 45.0f;
+
+    servoCurve_t curve;
+    servoCurveGenerateArm(&curve, armAngle);
+
+    // End points and centre are unchanged, and the curve is symmetric
+    EXPECT_EQ(-SERVO_CURVE_RANGE, curve.point[0]);
+    EXPECT_EQ(0, curve.point[SERVO_CURVE_POINTS / 2]);
+    EXPECT_EQ(SERVO_CURVE_RANGE, curve.point[SERVO_CURVE_POINTS - 1]);
+    for (int i = 0; i < SERVO_CURVE_POINTS; i++) {
+        EXPECT_EQ(-curve.point[i], curve.point[SERVO_CURVE_POINTS - 1 - i]);
+    }
+
+    servoCurveTable_t table;
+    servoCurveBuild(&table, &curve);
+
+    // Link height for the servo pulse is sin(arm angle), it must follow the command
+    const float maxAngle = armAngle * M_PI / 180.0f;
+    float maxError = 0;
+    float maxErrorLinear = 0;
+    for (int command = -SERVO_CURVE_RANGE; command <= SERVO_CURVE_RANGE; command++) {
+        const float pulse = servoCurveApply(&table, command);
+        const float height = SERVO_CURVE_RANGE * sinf(pulse / SERVO_CURVE_RANGE * maxAngle) / sinf(maxAngle);
+        const float heightLinear = SERVO_CURVE_RANGE * sinf((float)command / SERVO_CURVE_RANGE * maxAngle) / sinf(maxAngle);
+        maxError = fmaxf(maxError, fabsf(height - command));
+        maxErrorLinear = fmaxf(maxErrorLinear, fabsf(heightLinear - command));
+    }
+
+    // Within a few us over the whole travel, against over 20us without the curve
+    EXPECT_LT(maxError, 3.5f);
+    EXPECT_GT(maxErrorLinear, 20.0f);
+}
+
+TEST(ServoCurveTest, ZeroArmAngleResets)
+{
+    servoCurve_t curve = { { 1, 2, 3, 4, 5, 6, 7, 8, 9 } };
+    servoCurveGenerateArm(&curve, 0);
+
+    servoCurveTable_t table;
+    servoCurveBuild(&table, &curve);
+    EXPECT_FALSE(table.active);
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/servo_slew.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void setupSlew(servoSlew_t *slew, uint16_t rateLimit, uint16_t accelLimit)
+{
+    memset(slew, 0, sizeof(*slew));
+    servoSlewInit(slew, rateLimit, accelLimit);
+    servoSlewApply(slew, 0, 0.001f);
+}
+
+// Run a step from 0 to target for the given time, returns the final position
+static float runStep(servoSlew_t *slew, float target, float dt, float time)
+{
+    const int steps = lrintf(time / dt);
+    float position = 0;
+    for (int i = 0; i < steps; i++) {
+        position = servoSlewApply(slew, target, dt);
+    }
+    return position;
+}
+
+TEST(ServoSlewTest, UnlimitedFollowsTarget)
+{
+    servoSlew_t slew;
+    setupSlew(&slew, 0, 0);
+
+    EXPECT_FLOAT_EQ(300.0f, servoSlewApply(&slew, 300, 0.002f));
+    EXPECT_FLOAT_EQ(-200.0f, servoSlewApply(&slew, -200, 0.002f));
+    EXPECT_FALSE(servoSlewIsSaturated(&slew, -200));
+}
+
+TEST(ServoSlewTest, FirstSampleInitialises)
+{
+    servoSlew_t slew;
+    memset(&slew, 0, sizeof(slew));
+    servoSlewInit(&slew, 1000, 0);
+
+    EXPECT_FLOAT_EQ(400.0f, servoSlewApply(&slew, 400, 0.002f));
+    EXPECT_FALSE(servoSlewIsSaturated(&slew, 400));
+}
+
+TEST(ServoSlewTest, RateLimit)
+{
+    servoSlew_t slew;
+    setupSlew(&slew, 5000, 0);
+
+    // 5000 us/s for 20ms is 100us
+    EXPECT_NEAR(100.0f, runStep(&slew, 500, 0.002f, 0.020f), 1e-3f);
+    EXPECT_TRUE(servoSlewIsSaturated(&slew, 500));
+
+    // Reaches the target after 100ms and stays there
+    EXPECT_NEAR(500.0f, runStep(&slew, 500, 0.002f, 0.100f), 1e-3f);
+    EXPECT_FALSE(servoSlewIsSaturated(&slew, 500));
+}
+
+TEST(ServoSlewTest, AccelLimitStopsWithoutOvershoot)
+{
+    servoSlew_t slew;
+    setupSlew(&slew, 10000, 500);
+
+    float maxPosition = 0;
+    float maxVelocity = 0;
+    for (int i = 0; i < 500; i++) {
+        const float previous = slew.velocity;
+        const float position = servoSlewApply(&slew, 400, 0.001f);
+        maxPosition = MAX(maxPosition, position);
+        maxVelocity = MAX(maxVelocity, slew.velocity);
+        EXPECT_LE(fabsf(slew.velocity - previous), 500000.0f * 0.001f + 1e-2f);
+    }
+
+    EXPECT_LE(maxVelocity, 10000.0f + 1e-3f);
+    EXPECT_LE(maxPosition, 400.0f + 1e-3f);
+    EXPECT_NEAR(400.0f, slew.position, 1e-2f);
+    EXPECT_FALSE(servoSlewIsSaturated(&slew, 400));
+}
+
+TEST(ServoSlewTest, SameResponseAtAnyUpdateRate)
+{
+    // The servo update period depends on the PID loop rate and pid_process_denom,
+    // the movement in real time must not
+    const float periods[] = { 0.000125f, 0.00025f, 0.0005f, 0.002f, 0.004f };
+    float reference = 0;
+
+    for (unsigned i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+        servoSlew_t slew;
+        setupSlew(&slew, 4000, 0);
+        const float position = runStep(&slew, 500, periods[i], 0.040f);
+        if (i == 0) {
+            reference = position;
+            EXPECT_NEAR(160.0f, reference, 1e-2f);
+        }
+        EXPECT_NEAR(reference, position, 0.05f) << "period " << periods[i];
+    }
+
+    for (unsigned i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+        servoSlew_t slew;
+        setupSlew(&slew, 0, 200);
+        const float position = runStep(&slew, 500, periods[i], 0.040f);
+        // a*t^2/2 = 200000 * 0.04^2 / 2 = 160us, give or take the first step
+        EXPECT_NEAR(160.0f, position, 200000.0f * periods[i] * 0.040f) << "period " << periods[i];
+    }
+}
@@ -0,0 +1,402 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/swash.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void setupInputs(swashMixerInputs_t *inputs, uint8_t type)
+{
+    memset(inputs, 0, sizeof(*inputs));
+    inputs->type = type;
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        inputs->rate[i] = 100;
+        for (int j = 0; j < SWASH_INPUT_COUNT; j++) {
+            inputs->direction[i][j] = 1;
+        }
+    }
+}
+
+// The 120 degree smix rules the heli mixer used, in LEFT, RIGHT, TOP order: roll, pitch, collective rates
+static const int8_t legacyHeliRules[SWASH_SERVO_COUNT][SWASH_INPUT_COUNT] = {
+    { -87, -50, 100 },
+    {  87, -50, 100 },
+    {   0, 100, 100 },
+};
+
+TEST(SwashMixerTest, MatchesLegacy120Smix)
+{
+    swashMixerInputs_t inputs;
+    setupInputs(&inputs, SWASH_TYPE_120);
+
+    swashMixer_t swash;
+    swashMixerBuild(&swash, &inputs);
+
+    for (int roll = -350; roll <= 350; roll += 25) {
+        for (int pitch = -350; pitch <= 350; pitch += 25) {
+            for (int collective = -500; collective <= 500; collective += 100) {
+                const float input[SWASH_INPUT_COUNT] = { (float)roll, (float)pitch, (float)collective };
+                float output[SWASH_SERVO_COUNT];
+                swashMixerApply(&swash, input, output);
+
+                for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+                    const int legacy = roll * legacyHeliRules[i][0] / 100 + pitch * legacyHeliRules[i][1] / 100 + collective * legacyHeliRules[i][2] / 100;
+                    // sin(120) = 0.866 instead of 0.87, and no integer truncation
+                    EXPECT_NEAR(legacy, output[i], 3.0f) << "servo " << i << " roll " << roll << " pitch " << pitch << " collective " << collective;
+                }
+            }
+        }
+    }
+}
+
+TEST(SwashMixerTest, ServosFollowSwashPlane)
+{
+    // Any servo geometry: each servo moves by the height of the tilted swash plane at its position
+    const int16_t angles[][SWASH_SERVO_COUNT] = {
+        { 240, 120, 0 },
+        { 225, 135, 0 },
+        { 220, 140, 0 },
+        { 270, 90, 0 },
+        { 200, 100, 10 },
+    };
+    const uint8_t types[] = { SWASH_TYPE_120, SWASH_TYPE_135, SWASH_TYPE_140, SWASH_TYPE_90, SWASH_TYPE_CUSTOM };
+
+    for (unsigned t = 0; t < sizeof(types); t++) {
+        swashMixerInputs_t inputs;
+        setupInputs(&inputs, types[t]);
+        memcpy(inputs.angle, angles[t], sizeof(inputs.angle));
+
+        swashMixer_t swash;
+        swashMixerBuild(&swash, &inputs);
+
+        const float input[SWASH_INPUT_COUNT] = { 123.4f, -56.7f, 89.0f };
+        float output[SWASH_SERVO_COUNT];
+        swashMixerApply(&swash, input, output);
+
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            const double angle = angles[t][i] * M_PI / 180.0;
+            const double expected = input[2] + input[0] * sin(angle) + input[1] * cos(angle);
+            EXPECT_NEAR(expected, output[i], 1e-3) << "type " << (int)types[t] << " servo " << i;
+        }
+    }
+}
+
+TEST(SwashMixerTest, NinetyDegreeHasNoCrossCoupling)
+{
+    swashMixerInputs_t inputs;
+    setupInputs(&inputs, SWASH_TYPE_90);
+
+    swashMixer_t swash;
+    swashMixerBuild(&swash, &inputs);
+
+    EXPECT_EQ(0.0f, swash.mix[0][SWASH_INPUT_PITCH]);
+    EXPECT_EQ(0.0f, swash.mix[1][SWASH_INPUT_PITCH]);
+    EXPECT_EQ(0.0f, swash.mix[2][SWASH_INPUT_ROLL]);
+    EXPECT_EQ(-1.0f, swash.mix[0][SWASH_INPUT_ROLL]);
+    EXPECT_EQ(1.0f, swash.mix[1][SWASH_INPUT_ROLL]);
+    EXPECT_EQ(1.0f, swash.mix[2][SWASH_INPUT_PITCH]);
+}
+
+TEST(SwashMixerTest, DirectionAndRateInMatrix)
+{
+    swashMixerInputs_t inputs;
+    setupInputs(&inputs, SWASH_TYPE_120);
+    inputs.direction[0][SWASH_INPUT_ROLL] = -1;
+    inputs.direction[2][SWASH_INPUT_COLLECTIVE] = -1;
+    inputs.rate[1] = 50;
+
+    swashMixer_t swash;
+    swashMixerBuild(&swash, &inputs);
+
+    EXPECT_NEAR(0.866f, swash.mix[0][SWASH_INPUT_ROLL], 1e-3f);
+    EXPECT_NEAR(-0.5f, swash.mix[0][SWASH_INPUT_PITCH], 1e-6f);
+    EXPECT_NEAR(0.433f, swash.mix[1][SWASH_INPUT_ROLL], 1e-3f);
+    EXPECT_NEAR(0.5f, swash.mix[1][SWASH_INPUT_COLLECTIVE], 1e-6f);
+    EXPECT_NEAR(-1.0f, swash.mix[2][SWASH_INPUT_COLLECTIVE], 1e-6f);
+
+    // The build inputs are kept for change detection
+    EXPECT_EQ(0, memcmp(&inputs, &swash.inputs, sizeof(inputs)));
+}
+
+TEST(SwashMixerTest, ServoInputsFollowGeometry)
+{
+    swashMixerInputs_t inputs;
+    swashMixer_t swash;
+    const uint8_t all = (1 << SWASH_INPUT_ROLL) | (1 << SWASH_INPUT_PITCH) | (1 << SWASH_INPUT_COLLECTIVE);
+
+    // 120: the side servos move with roll and pitch
+    setupInputs(&inputs, SWASH_TYPE_120);
+    swashMixerBuild(&swash, &inputs);
+    EXPECT_EQ(all, swashMixerGetServoInputs(&swash, 1 << 0));
+    EXPECT_EQ((1 << SWASH_INPUT_PITCH) | (1 << SWASH_INPUT_COLLECTIVE), swashMixerGetServoInputs(&swash, 1 << 2));
+
+    // 90: the side servos are roll only, the front servo pitch only
+    setupInputs(&inputs, SWASH_TYPE_90);
+    swashMixerBuild(&swash, &inputs);
+    EXPECT_EQ((1 << SWASH_INPUT_ROLL) | (1 << SWASH_INPUT_COLLECTIVE), swashMixerGetServoInputs(&swash, 1 << 0));
+    EXPECT_EQ((1 << SWASH_INPUT_ROLL) | (1 << SWASH_INPUT_COLLECTIVE), swashMixerGetServoInputs(&swash, 1 << 1));
+    EXPECT_EQ((1 << SWASH_INPUT_PITCH) | (1 << SWASH_INPUT_COLLECTIVE), swashMixerGetServoInputs(&swash, 1 << 2));
+    EXPECT_EQ(all, swashMixerGetServoInputs(&swash, (1 << 1) | (1 << 2)));
+
+    // Custom: a servo at 180 degrees is pitch only
+    setupInputs(&inputs, SWASH_TYPE_CUSTOM);
+    inputs.angle[0] = 180;
+    inputs.angle[1] = 90;
+    inputs.angle[2] = 270;
+    swashMixerBuild(&swash, &inputs);
+    EXPECT_EQ((1 << SWASH_INPUT_PITCH) | (1 << SWASH_INPUT_COLLECTIVE), swashMixerGetServoInputs(&swash, 1 << 0));
+
+    EXPECT_EQ(0, swashMixerGetServoInputs(&swash, 0));
+}
+
+TEST(SwashMixerTest, SmixTypeLeavesMatrixEmpty)
+{
+    swashMixerInputs_t inputs;
+    setupInputs(&inputs, SWASH_TYPE_SMIX);
+
+    swashMixer_t swash;
+    memset(&swash, 0xff, sizeof(swash));
+    swashMixerBuild(&swash, &inputs);
+
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        for (int j = 0; j < SWASH_INPUT_COUNT; j++) {
+            EXPECT_EQ(0.0f, swash.mix[i][j]);
+        }
+    }
+}
+
+#define TEST_MAX_CYCLIC     350.0f
+
+// Ring size in the direction of (roll, pitch), from the quadrant ellipse
+static float ringRadius(const uint8_t *limit, float roll, float pitch)
+{
+    const float a = limit[(roll < 0) ? SWASH_RING_ROLL_NEG : SWASH_RING_ROLL_POS] * TEST_MAX_CYCLIC / 100.0f;
+    const float b = limit[(pitch < 0) ? SWASH_RING_PITCH_NEG : SWASH_RING_PITCH_POS] * TEST_MAX_CYCLIC / 100.0f;
+    const float angle = atan2f(pitch, roll);
+    return 1.0f / sqrtf(powf(cosf(angle) / a, 2) + powf(sinf(angle) / b, 2));
+}
+
+static void sweepRing(uint8_t mode, const uint8_t *configLimit, const uint8_t *ringLimit)
+{
+    swashRing_t ring;
+    swashRingInit(&ring, mode, configLimit, TEST_MAX_CYCLIC);
+
+    for (int r = -700; r <= 700; r += 7) {
+        for (int p = -700; p <= 700; p += 7) {
+            float roll = r;
+            float pitch = p;
+            const float value = swashRingApply(&ring, &roll, &pitch);
+
+            if (r == 0 && p == 0) {
+                EXPECT_EQ(0.0f, value);
+                continue;
+            }
+
+            const float radius = ringRadius(ringLimit, r, p);
+            const float length = sqrtf(r * r + p * p);
+            const float limited = sqrtf(roll * roll + pitch * pitch);
+
+            if (length < radius * 0.9999f) {
+                // Inside the ring: untouched
+                EXPECT_EQ((float)r, roll);
+                EXPECT_EQ((float)p, pitch);
+                EXPECT_NEAR(length / radius, value, 0.002f);
+            } else if (length > radius * 1.0001f) {
+                // Never outside the ring, and no more than the inverse sqrt error inside it
+                EXPECT_LE(limited, radius * 1.0001f) << "roll " << r << " pitch " << p;
+                EXPECT_GE(limited, radius * 0.998f) << "roll " << r << " pitch " << p;
+                EXPECT_NEAR(1.0f, value, 0.002f);
+
+                // Direction is kept
+                EXPECT_NEAR(0.0f, (roll * p - pitch * r) / length, 1e-3f);
+                EXPECT_GE(roll * r + pitch * p, 0.0f);
+            }
+        }
+    }
+}
+
+TEST(SwashRingTest, CircularSweep)
+{
+    const uint8_t limit[SWASH_RING_LIMIT_COUNT] = { 100, 50, 50, 50 };
+    const uint8_t circle[SWASH_RING_LIMIT_COUNT] = { 100, 100, 100, 100 };
+    sweepRing(SWASH_RING_CIRCULAR, limit, circle);
+}
+
+TEST(SwashRingTest, EllipticalSweep)
+{
+    const uint8_t limit[SWASH_RING_LIMIT_COUNT] = { 120, 50, 80, 50 };
+    const uint8_t ellipse[SWASH_RING_LIMIT_COUNT] = { 120, 120, 80, 80 };
+    sweepRing(SWASH_RING_ELLIPTICAL, limit, ellipse);
+}
+
+TEST(SwashRingTest, QuadrantSweep)
+{
+    const uint8_t limit[SWASH_RING_LIMIT_COUNT] = { 110, 90, 130, 70 };
+    sweepRing(SWASH_RING_QUADRANT, limit, limit);
+}
+
+TEST(SwashRingTest, CornerStickGivesSingleAxisMaximum)
+{
+    const uint8_t limit[SWASH_RING_LIMIT_COUNT] = { 100, 100, 100, 100 };
+    swashRing_t ring;
+    swashRingInit(&ring, SWASH_RING_CIRCULAR, limit, TEST_MAX_CYCLIC);
+
+    // Full roll and pitch together is 141%, limited to the same blade pitch as full roll alone
+    float roll = TEST_MAX_CYCLIC;
+    float pitch = TEST_MAX_CYCLIC;
+    swashRingApply(&ring, &roll, &pitch);
+    EXPECT_NEAR(TEST_MAX_CYCLIC * M_SQRT1_2, roll, 1.0f);
+    EXPECT_NEAR(TEST_MAX_CYCLIC * M_SQRT1_2, pitch, 1.0f);
+    EXPECT_LE(sqrtf(roll * roll + pitch * pitch), TEST_MAX_CYCLIC);
+}
+
+TEST(SwashRingTest, OffOnlyMeasures)
+{
+    const uint8_t limit[SWASH_RING_LIMIT_COUNT] = { 50, 50, 50, 50 };
+    swashRing_t ring;
+    swashRingInit(&ring, SWASH_RING_OFF, limit, TEST_MAX_CYCLIC);
+
+    float roll = TEST_MAX_CYCLIC;
+    float pitch = TEST_MAX_CYCLIC;
+    const float value = swashRingApply(&ring, &roll, &pitch);
+    EXPECT_EQ(TEST_MAX_CYCLIC, roll);
+    EXPECT_EQ(TEST_MAX_CYCLIC, pitch);
+    EXPECT_NEAR(M_SQRT2, value, 0.003f);
+}
+
+TEST(SwashStallLimitTest, InsideLimitUntouched)
+{
+    float roll = 100, pitch = -50, collective = 200;
+    EXPECT_EQ(1.0f, swashStallLimitApply(400, &roll, &pitch, &collective));
+    EXPECT_EQ(100.0f, roll);
+    EXPECT_EQ(-50.0f, pitch);
+    EXPECT_EQ(200.0f, collective);
+
+    // Zero limit is off
+    roll = 350; pitch = 350; collective = 500;
+    EXPECT_EQ(1.0f, swashStallLimitApply(0, &roll, &pitch, &collective));
+    EXPECT_EQ(500.0f, collective);
+}
+
+TEST(SwashStallLimitTest, TotalPitchLimited)
+{
+    for (int collective = -500; collective <= 500; collective += 50) {
+        float roll = 300, pitch = -400, coll = collective;
+        const float total = 500 + fabsf(collective);
+        const float scale = swashStallLimitApply(450, &roll, &pitch, &coll);
+
+        EXPECT_NEAR(450.0f / total, scale, 1e-6f);
+        EXPECT_NEAR(450.0f, sqrtf(roll * roll + pitch * pitch) + fabsf(coll), 1e-3f);
+
+        // Collective and cyclic keep their ratio and direction
+        EXPECT_NEAR(-4.0f / 3.0f, pitch / roll, 1e-5f);
+        EXPECT_NEAR(collective * scale, coll, 1e-3f);
+    }
+}
+
+TEST(SwashLoadCompTest, OffsetsFollowCyclicDirection)
+{
+    const int8_t table[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT] = {
+        { 10, -20,  0,  5 },
+        {  0,   0, 30, -8 },
+        {  0,   0,  0,  0 },
+    };
+    swashLoadComp_t comp;
+    swashLoadCompInit(&comp, table, TEST_MAX_CYCLIC);
+    EXPECT_TRUE(comp.enabled);
+
+    float offset[SWASH_SERVO_COUNT];
+
+    swashLoadCompApply(&comp, TEST_MAX_CYCLIC, 0, offset);
+    EXPECT_NEAR(10.0f, offset[0], 1e-4f);
+    EXPECT_NEAR(0.0f, offset[1], 1e-4f);
+
+    swashLoadCompApply(&comp, -TEST_MAX_CYCLIC / 2, -TEST_MAX_CYCLIC, offset);
+    EXPECT_NEAR(-10.0f + 5.0f, offset[0], 1e-4f);
+    EXPECT_NEAR(-8.0f, offset[1], 1e-4f);
+    EXPECT_EQ(0.0f, offset[2]);
+
+    swashLoadCompApply(&comp, 0, TEST_MAX_CYCLIC / 4, offset);
+    EXPECT_NEAR(0.0f, offset[0], 1e-4f);
+    EXPECT_NEAR(7.5f, offset[1], 1e-4f);
+
+    // No cyclic, no offset
+    swashLoadCompApply(&comp, 0, 0, offset);
+    for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+        EXPECT_EQ(0.0f, offset[i]);
+    }
+}
+
+TEST(SwashLoadCompTest, EmptyTableDisabled)
+{
+    int8_t table[SWASH_SERVO_COUNT][SWASH_RING_LIMIT_COUNT];
+    memset(table, 0, sizeof(table));
+    swashLoadComp_t comp;
+    swashLoadCompInit(&comp, table, TEST_MAX_CYCLIC);
+    EXPECT_FALSE(comp.enabled);
+}
+
+TEST(SwashPhaseTest, SameAsTurningServoAngles)
+{
+    // Rotating the cyclic by the phase angle gives the servo travel of a swash turned by that angle
+    const int16_t phases[] = { 0, 150, -225, 900, 1800 };
+
+    for (unsigned t = 0; t < sizeof(phases) / sizeof(phases[0]); t++) {
+        swashPhase_t phase;
+        swashPhaseInit(&phase, phases[t]);
+        EXPECT_EQ(phases[t] != 0, phase.enabled);
+
+        swashMixerInputs_t inputs;
+        setupInputs(&inputs, SWASH_TYPE_CUSTOM);
+        const int16_t angles[SWASH_SERVO_COUNT] = { 240, 120, 0 };
+        memcpy(inputs.angle, angles, sizeof(inputs.angle));
+        swashMixer_t swash;
+        swashMixerBuild(&swash, &inputs);
+
+        float roll = 123.4f;
+        float pitch = -56.7f;
+        swashPhaseApply(&phase, &roll, &pitch);
+
+        const float input[SWASH_INPUT_COUNT] = { roll, pitch, 0 };
+        float output[SWASH_SERVO_COUNT];
+        swashMixerApply(&swash, input, output);
+
+        for (int i = 0; i < SWASH_SERVO_COUNT; i++) {
+            const double angle = (angles[i] + phases[t] / 10.0) * M_PI / 180.0;
+            const double expected = 123.4 * sin(angle) - 56.7 * cos(angle);
+            EXPECT_NEAR(expected, output[i], 1e-2) << "phase " << phases[t] << " servo " << i;
+        }
+
+        // Length is kept
+        EXPECT_NEAR(sqrtf(123.4f * 123.4f + 56.7f * 56.7f), sqrtf(roll * roll + pitch * pitch), 1e-3f);
+    }
+}
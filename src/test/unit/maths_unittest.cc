@@ -108,6 +108,41 @@ TEST(MathsUnittest, TestScaleRangeReverse)
     EXPECT_EQ(scaleRange(50, 0, 100, 10, 0), 5);
 }
 
+TEST(MathsUnittest, TestInterpolateTable)
+{
+    const float x[] = { 50, 60, 80, 80, 100 };
+    const float y[] = { 2.0f, 1.5f, 1.2f, 1.1f, 1.0f };
+
+    // Clamped to the end points
+    EXPECT_FLOAT_EQ(interpolateTablef(0, x, y, 5), 2.0f);
+    EXPECT_FLOAT_EQ(interpolateTablef(50, x, y, 5), 2.0f);
+    EXPECT_FLOAT_EQ(interpolateTablef(100, x, y, 5), 1.0f);
+    EXPECT_FLOAT_EQ(interpolateTablef(150, x, y, 5), 1.0f);
+
+    // Linear between break points
+    EXPECT_FLOAT_EQ(interpolateTablef(55, x, y, 5), 1.75f);
+    EXPECT_FLOAT_EQ(interpolateTablef(70, x, y, 5), 1.35f);
+    EXPECT_FLOAT_EQ(interpolateTablef(90, x, y, 5), 1.05f);
+
+    // Repeated break points make a step instead of dividing by zero
+    EXPECT_NEAR(interpolateTablef(79.999f, x, y, 5), 1.2f, 1e-3f);
+    EXPECT_FLOAT_EQ(interpolateTablef(80, x, y, 5), 1.1f);
+
+    // Single point table is a constant
+    EXPECT_FLOAT_EQ(interpolateTablef(10, x, y, 1), 2.0f);
+    EXPECT_FLOAT_EQ(interpolateTablef(90, x, y, 1), 2.0f);
+}
+
+TEST(MathsUnittest, TestInvSqrt)
+{
+    for (float x = 1e-4f; x < 1e6f; x *= 1.01f) {
+        const float exact = 1.0f / sqrtf(x);
+        const float approx = invSqrtf(x);
+        EXPECT_LE(approx, exact * (1.0f + 1e-6f)) << "x " << x;
+        EXPECT_GE(approx, exact * (1.0f - 0.0018f)) << "x " << x;
+    }
+}
+
 TEST(MathsUnittest, TestConstrain)
 {
     // Within bounds
@@ -29,6 +29,7 @@ float simulatedSetpointRate[3] = { 0,0,0 };
 float simulatedRcDeflection[3] = { 0,0,0 };
 float simulatedThrottlePIDAttenuation = 1.0f;
 float simulatedMotorMixRange = 0.0f;
+bool simulatedServoSaturated[3] = { false, false, false };
 
 int16_t debug[DEBUG16_VALUE_COUNT];
 uint8_t debugMode;
@@ -56,8 +57,12 @@ extern "C" {
     #include "flight/imu.h"
     #include "flight/mixer.h"
 
+    #include "flight/servos.h"
+
     #include "io/gps.h"
 
+    #include "pg/rx.h"
+
     #include "sensors/gyro.h"
     #include "sensors/acceleration.h"
 
@@ -65,6 +70,10 @@ extern "C" {
     attitudeEulerAngles_t attitude;
 
     PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+    PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+
+    float rcCommand[5];
 
     float getThrottlePIDAttenuation(void) { return simulatedThrottlePIDAttenuation; }
     float getMotorMixRange(void) { return simulatedMotorMixRange; }
@@ -76,6 +85,12 @@ extern "C" {
     float getRcDeflection(int axis) { return simulatedRcDeflection[axis]; }
     void beeperConfirmationBeeps(uint8_t) { }
     void disarm(void) { }
+    uint8_t getMotorCount(void) { return 1; }
+    uint8_t isHeliSpooledUp(void) { return true; }
+    float mixerGetHeadspeed(void) { return 0; }
+    float servosGetOutputLatency(void) { return 0; }
+    float servosGetSwashRingValue(void) { return 0; }
+    bool servosIsAxisSaturated(int axis) { return simulatedServoSaturated[axis]; }
     float applyFFLimit(int axis, float value, float Kp, float currentPidSetpoint) {
         UNUSED(axis);
         UNUSED(Kp);
@@ -162,6 +177,7 @@ void resetTest(void) {
         pidData[axis].Sum = 0;
         simulatedSetpointRate[axis] = 0;
         simulatedRcDeflection[axis] = 0;
+        simulatedServoSaturated[axis] = false;
         gyro.gyroADCf[axis] = 0;
     }
     attitude.values.roll = 0;
@@ -239,17 +255,18 @@ TEST(pidControllerTest, testPidLoop) {
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].D);
 
     // Add some rotation on ROLL to generate error
+    // HF3D:  Roll and pitch P and D are scaled down by 10 and I by 5 for helicopters, yaw I is no longer boosted by 2.5
     gyro.gyroADCf[FD_ROLL] = 100;
     pidController(pidProfile, currentTestTime());
 
     // Loop 2 - Expect PID loop reaction to ROLL error
-    EXPECT_NEAR(-128.1, pidData[FD_ROLL].P, calculateTolerance(-128.1));
+    EXPECT_NEAR(-12.81, pidData[FD_ROLL].P, calculateTolerance(-12.81));
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].P);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].P);
-    EXPECT_NEAR(-7.8, pidData[FD_ROLL].I, calculateTolerance(-7.8));
+    EXPECT_NEAR(-1.56, pidData[FD_ROLL].I, calculateTolerance(-1.56));
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].I);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].I);
-    EXPECT_NEAR(-198.4, pidData[FD_ROLL].D, calculateTolerance(-198.4));
+    EXPECT_NEAR(-19.84, pidData[FD_ROLL].D, calculateTolerance(-19.84));
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].D);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].D);
 
@@ -258,14 +275,14 @@ TEST(pidControllerTest, testPidLoop) {
     pidController(pidProfile, currentTestTime());
 
     // Loop 3 - Expect PID loop reaction to PITCH error, ROLL is still in error
-    EXPECT_NEAR(-128.1, pidData[FD_ROLL].P, calculateTolerance(-128.1));
-    EXPECT_NEAR(185.8, pidData[FD_PITCH].P, calculateTolerance(185.8));
+    EXPECT_NEAR(-12.81, pidData[FD_ROLL].P, calculateTolerance(-12.81));
+    EXPECT_NEAR(18.58, pidData[FD_PITCH].P, calculateTolerance(18.58));
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].P);
-    EXPECT_NEAR(-15.6, pidData[FD_ROLL].I, calculateTolerance(-15.6));
-    EXPECT_NEAR(9.8, pidData[FD_PITCH].I, calculateTolerance(9.8));
+    EXPECT_NEAR(-3.12, pidData[FD_ROLL].I, calculateTolerance(-3.12));
+    EXPECT_NEAR(1.96, pidData[FD_PITCH].I, calculateTolerance(1.96));
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].I);
     EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].D);
-    EXPECT_NEAR(231.4, pidData[FD_PITCH].D, calculateTolerance(231.4));
+    EXPECT_NEAR(23.14, pidData[FD_PITCH].D, calculateTolerance(23.14));
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].D);
 
     // Add some rotation on YAW to generate error
@@ -273,23 +290,28 @@ TEST(pidControllerTest, testPidLoop) {
     pidController(pidProfile, currentTestTime());
 
     // Loop 4 - Expect PID loop reaction to PITCH error, ROLL and PITCH are still in error
-    EXPECT_NEAR(-128.1, pidData[FD_ROLL].P, calculateTolerance(-128.1));
-    EXPECT_NEAR(185.8, pidData[FD_PITCH].P, calculateTolerance(185.8));
+    EXPECT_NEAR(-12.81, pidData[FD_ROLL].P, calculateTolerance(-12.81));
+    EXPECT_NEAR(18.58, pidData[FD_PITCH].P, calculateTolerance(18.58));
     EXPECT_NEAR(-224.2, pidData[FD_YAW].P, calculateTolerance(-224.2));
-    EXPECT_NEAR(-23.5, pidData[FD_ROLL].I, calculateTolerance(-23.5));
-    EXPECT_NEAR(19.6, pidData[FD_PITCH].I, calculateTolerance(19.6));
-    EXPECT_NEAR(-8.7, pidData[FD_YAW].I, calculateTolerance(-8.7));
+    EXPECT_NEAR(-4.7, pidData[FD_ROLL].I, calculateTolerance(-4.7));
+    EXPECT_NEAR(3.92, pidData[FD_PITCH].I, calculateTolerance(3.92));
+    EXPECT_NEAR(-3.48, pidData[FD_YAW].I, calculateTolerance(-3.48));
     EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].D);
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].D);
     EXPECT_NEAR(-132.25, pidData[FD_YAW].D, calculateTolerance(-132.25));
 
-    // Simulate Iterm behaviour during mixer saturation
-    simulatedMotorMixRange = 1.2f;
+    // Simulate Iterm behaviour during servo saturation
+    // HF3D:  The I-term is held while the servos can't keep up, motor mix range doesn't apply to a heli
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        simulatedServoSaturated[axis] = true;
+    }
     pidController(pidProfile, currentTestTime());
-    EXPECT_NEAR(-23.5, pidData[FD_ROLL].I, calculateTolerance(-23.5));
-    EXPECT_NEAR(19.6, pidData[FD_PITCH].I, calculateTolerance(19.6));
-    EXPECT_NEAR(-8.8, pidData[FD_YAW].I, calculateTolerance(-8.8));
-    simulatedMotorMixRange = 0;
+    EXPECT_NEAR(-4.7, pidData[FD_ROLL].I, calculateTolerance(-4.7));
+    EXPECT_NEAR(3.92, pidData[FD_PITCH].I, calculateTolerance(3.92));
+    EXPECT_NEAR(-3.52, pidData[FD_YAW].I, calculateTolerance(-3.52));
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        simulatedServoSaturated[axis] = false;
+    }
 
     // Match the stick to gyro to stop error
     simulatedSetpointRate[FD_ROLL] = 100;
@@ -303,9 +325,9 @@ TEST(pidControllerTest, testPidLoop) {
     EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].P);
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].P);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].P);
-    EXPECT_NEAR(-23.5, pidData[FD_ROLL].I, calculateTolerance(-23.5));
-    EXPECT_NEAR(19.6, pidData[FD_PITCH].I, calculateTolerance(19.6));
-    EXPECT_NEAR(-10.6, pidData[FD_YAW].I, calculateTolerance(-10.6));
+    EXPECT_NEAR(-4.7, pidData[FD_ROLL].I, calculateTolerance(-4.7));
+    EXPECT_NEAR(3.92, pidData[FD_PITCH].I, calculateTolerance(3.92));
+    EXPECT_NEAR(-4.24, pidData[FD_YAW].I, calculateTolerance(-4.24));
     EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].D);
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].D);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].D);
@@ -333,6 +355,7 @@ TEST(pidControllerTest, testPidLevel) {
     pidStabilisationState(PID_STABILISATION_ON);
 
     // Test Angle mode response
+    // HF3D:  Angle mode is rescue mode, it levels to upright or inverted, whichever is closer, and ignores the sticks
     enableFlightMode(ANGLE_MODE);
     float currentPidSetpoint = 30;
     rollAndPitchTrims_t angleTrim = { { 0, 0 } };
@@ -342,33 +365,45 @@ TEST(pidControllerTest, testPidLevel) {
     currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
     EXPECT_FLOAT_EQ(0, currentPidSetpoint);
 
-    // Test attitude response
+    // Sticks have no effect
     setStickPosition(FD_ROLL, 1.0f);
     setStickPosition(FD_PITCH, -1.0f);
     currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, currentPidSetpoint);
-    EXPECT_FLOAT_EQ(275, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(0, currentPidSetpoint);
     currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
-    EXPECT_FLOAT_EQ(-275, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(0, currentPidSetpoint);
 
-    setStickPosition(FD_ROLL, -0.5f);
-    setStickPosition(FD_PITCH, 0.5f);
+    // Test attitude response, closer to upright
+    attitude.values.roll = -275;
+    attitude.values.pitch = 275;
     currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(137.5, currentPidSetpoint);
+    currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
     EXPECT_FLOAT_EQ(-137.5, currentPidSetpoint);
+
+    // Closer to inverted, keep rolling the same way to inverted and reverse the pitch correction
+    attitude.values.roll = 1200;
+    attitude.values.pitch = 100;
+    currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(300, currentPidSetpoint);
     currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
-    EXPECT_FLOAT_EQ(137.5, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(50, currentPidSetpoint);
 
-    attitude.values.roll = -275;
-    attitude.values.pitch = 275;
+    attitude.values.roll = -1200;
     currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, currentPidSetpoint);
-    EXPECT_FLOAT_EQ(0, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(-300, currentPidSetpoint);
     currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
-    EXPECT_FLOAT_EQ(0, currentPidSetpoint);
+    EXPECT_FLOAT_EQ(50, currentPidSetpoint);
 
-    // Disable ANGLE_MODE
+    // Disable ANGLE_MODE, no level correction when the stick matches the attitude
     disableFlightMode(ANGLE_MODE);
-    currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, currentPidSetpoint);
+    setStickPosition(FD_ROLL, -0.5f);
+    setStickPosition(FD_PITCH, 0.5f);
+    attitude.values.roll = -275;
+    attitude.values.pitch = 275;
+    currentPidSetpoint = pidLevel(FD_ROLL, pidProfile, &angleTrim, 0);
     EXPECT_FLOAT_EQ(0, currentPidSetpoint);
-    currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, currentPidSetpoint);
+    currentPidSetpoint = pidLevel(FD_PITCH, pidProfile, &angleTrim, 0);
     EXPECT_FLOAT_EQ(0, currentPidSetpoint);
 }
 
@@ -397,6 +432,8 @@ TEST(pidControllerTest, testPidHorizon) {
 }
 
 TEST(pidControllerTest, testMixerSaturation) {
+    // HF3D:  The I-term is held while the servos can't keep up, see servosIsAxisSaturated()
+    //   The motor mix range doesn't limit the I-term on a heli.
     resetTest();
     ENABLE_ARMING_FLAG(ARMED);
     pidStabilisationState(PID_STABILISATION_ON);
@@ -405,7 +442,9 @@ TEST(pidControllerTest, testMixerSaturation) {
     setStickPosition(FD_ROLL, 1.0f);
     setStickPosition(FD_PITCH, -1.0f);
     setStickPosition(FD_YAW, 1.0f);
-    simulatedMotorMixRange = 2.0f;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        simulatedServoSaturated[axis] = true;
+    }
     pidController(pidProfile, currentTestTime());
 
     // Expect no iterm accumulation
@@ -413,36 +452,45 @@ TEST(pidControllerTest, testMixerSaturation) {
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].I);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].I);
 
-    // Test itermWindup limit
-    // First store values without exceeding iterm windup limit
+    // First build up some iterm without saturation, no yaw acceleration limit so all axes see the same error
     resetTest();
+    pidProfile->yawRateAccelLimit = 0;
+    pidInit(pidProfile);
     ENABLE_ARMING_FLAG(ARMED);
     pidStabilisationState(PID_STABILISATION_ON);
     setStickPosition(FD_ROLL, 0.1f);
     setStickPosition(FD_PITCH, -0.1f);
     setStickPosition(FD_YAW, 0.1f);
-    simulatedMotorMixRange = 0.0f;
     pidController(pidProfile, currentTestTime());
     float rollTestIterm = pidData[FD_ROLL].I;
     float pitchTestIterm = pidData[FD_PITCH].I;
     float yawTestIterm = pidData[FD_YAW].I;
+    EXPECT_GT(rollTestIterm, 0);
+    EXPECT_LT(pitchTestIterm, 0);
+    EXPECT_GT(yawTestIterm, 0);
 
-    // Now compare values when exceeding the limit
-    resetTest();
-    ENABLE_ARMING_FLAG(ARMED);
-    pidStabilisationState(PID_STABILISATION_ON);
-    setStickPosition(FD_ROLL, 0.1f);
-    setStickPosition(FD_PITCH, -0.1f);
-    setStickPosition(FD_YAW, 0.1f);
-    simulatedMotorMixRange = (pidProfile->itermWindupPointPercent + 1) / 100.0f;
+    // Saturated, the iterm doesn't grow any further
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        simulatedServoSaturated[axis] = true;
+    }
+    pidController(pidProfile, currentTestTime());
+    EXPECT_FLOAT_EQ(rollTestIterm, pidData[FD_ROLL].I);
+    EXPECT_FLOAT_EQ(pitchTestIterm, pidData[FD_PITCH].I);
+    EXPECT_FLOAT_EQ(yawTestIterm, pidData[FD_YAW].I);
+
+    // but it may still unwind when the heli overshoots
+    gyro.gyroADCf[FD_ROLL] = 250;
+    gyro.gyroADCf[FD_PITCH] = -250;
+    gyro.gyroADCf[FD_YAW] = 250;
     pidController(pidProfile, currentTestTime());
     EXPECT_LT(pidData[FD_ROLL].I, rollTestIterm);
-    EXPECT_GE(pidData[FD_PITCH].I, pitchTestIterm);
+    EXPECT_GT(pidData[FD_PITCH].I, pitchTestIterm);
     EXPECT_LT(pidData[FD_YAW].I, yawTestIterm);
 }
 
 // TODO - Add more scenarios
-TEST(pidControllerTest, testCrashRecoveryMode) {
+// HF3D:  Crash recovery is not part of the heli PID controller, handleCrashRecovery() is compiled out
+TEST(pidControllerTest, DISABLED_testCrashRecoveryMode) {
     resetTest();
     pidProfile->crash_recovery = PID_CRASH_RECOVERY_ON;
     pidInit(pidProfile);
@@ -472,6 +520,9 @@ TEST(pidControllerTest, testFeedForward) {
     ENABLE_ARMING_FLAG(ARMED);
     pidStabilisationState(PID_STABILISATION_ON);
 
+    // HF3D:  No tail base thrust, so yaw only has the stick delta feedforward
+    pidProfile->yawBaseThrust = 0;
+
     EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].F);
     EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].F);
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].F);
@@ -483,8 +534,9 @@ TEST(pidControllerTest, testFeedForward) {
 
     pidController(pidProfile, currentTestTime());
 
-    EXPECT_NEAR(2232.78, pidData[FD_ROLL].F, calculateTolerance(2232.78));
-    EXPECT_NEAR(-2061.03, pidData[FD_PITCH].F, calculateTolerance(-2061.03));
+    // HF3D:  Direct stick feedforward on roll and pitch, Kf * 90 * transition * setpoint
+    EXPECT_NEAR(1607.6, pidData[FD_ROLL].F, calculateTolerance(1607.6));
+    EXPECT_NEAR(-1483.9, pidData[FD_PITCH].F, calculateTolerance(-1483.9));
     EXPECT_NEAR(-82.52, pidData[FD_YAW].F, calculateTolerance(-82.5));
 
     // Match the stick to gyro to stop error
@@ -494,8 +546,8 @@ TEST(pidControllerTest, testFeedForward) {
 
     pidController(pidProfile, currentTestTime());
 
-    EXPECT_NEAR(-558.20, pidData[FD_ROLL].F, calculateTolerance(-558.20));
-    EXPECT_NEAR(515.26, pidData[FD_PITCH].F, calculateTolerance(515.26));
+    EXPECT_NEAR(401.9, pidData[FD_ROLL].F, calculateTolerance(401.9));
+    EXPECT_NEAR(-371.0, pidData[FD_PITCH].F, calculateTolerance(-371.0));
     EXPECT_NEAR(-41.26, pidData[FD_YAW].F, calculateTolerance(-41.26));
 
     for (int loop =0; loop <= 15; loop++) {
@@ -503,8 +555,9 @@ TEST(pidControllerTest, testFeedForward) {
         pidController(pidProfile, currentTestTime());
     }
 
-    EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].F);
-    EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].F);
+    // Roll and pitch follow the stick, yaw goes to zero with the stick held
+    EXPECT_NEAR(401.9, pidData[FD_ROLL].F, calculateTolerance(401.9));
+    EXPECT_NEAR(-371.0, pidData[FD_PITCH].F, calculateTolerance(-371.0));
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].F);
 
 }
@@ -657,7 +710,8 @@ TEST(pidControllerTest, testItermRotationHandling) {
     EXPECT_NEAR(1139.6, pidData[FD_YAW].I, calculateTolerance(1139.6));
 }
 
-TEST(pidControllerTest, testLaunchControl) {
+// HF3D:  Launch control is a multirotor feature that the heli PID controller doesn't have
+TEST(pidControllerTest, DISABLED_testLaunchControl) {
     // The launchControlGain is indirectly tested since when launch control is active the
     // the gain overrides the PID settings. If the logic to use launchControlGain wasn't
     // working then any I calculations would be incorrect.
@@ -764,3 +818,45 @@ TEST(pidControllerTest, testLaunchControl) {
     EXPECT_NEAR(44.84,  pidData[FD_YAW].P,   calculateTolerance(44.84));
     EXPECT_NEAR(1.56,   pidData[FD_YAW].I,  calculateTolerance(1.56));
 }
+
+TEST(pidControllerTest, testCollectivePrecomp) {
+    resetTest();
+    rxConfigMutable()->midrc = 1500;
+    mixerConfigMutable()->gov_collective_ff_impulse_freq = 100;
+    pidProfile->rollColKf = -50;
+    pidProfile->rollColPulseKf = 0;
+    pidProfile->pitchColKf = 100;
+    pidProfile->pitchColPulseKf = 200;
+    pidProfile->yawColKf = 300;
+    pidProfile->yawColPulseKf = 300;
+    pidProfile->yawCycKf = 0;
+    pidProfile->yawBaseThrust = 0;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    rcCommand[COLLECTIVE] = 0;
+    pidController(pidProfile, currentTestTime());
+    EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].F);
+    EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].F);
+    EXPECT_FLOAT_EQ(0, pidData[FD_YAW].F);
+
+    // Negative collective step, the impulse starts out at nearly the full step
+    rcCommand[COLLECTIVE] = -250;
+    pidController(pidProfile, currentTestTime());
+    EXPECT_FLOAT_EQ(25, pidData[FD_ROLL].F);
+    EXPECT_GT(pidData[FD_PITCH].F, -150);
+    EXPECT_LT(pidData[FD_PITCH].F, -140);
+    EXPECT_GT(pidData[FD_YAW].F, -300);
+    EXPECT_LT(pidData[FD_YAW].F, -280);
+
+    // Impulse decays, the static part follows the signed collective on cyclic and its magnitude on yaw
+    for (int loop = 0; loop < 5000; loop++) {
+        pidController(pidProfile, currentTestTime());
+    }
+    EXPECT_FLOAT_EQ(25, pidData[FD_ROLL].F);
+    EXPECT_NEAR(-50, pidData[FD_PITCH].F, 0.1);
+    EXPECT_NEAR(-150, pidData[FD_YAW].F, 0.1);
+
+    rcCommand[COLLECTIVE] = 0;
+}
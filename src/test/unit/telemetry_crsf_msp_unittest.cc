@@ -45,7 +45,9 @@ extern "C" {
 
     #include "fc/runtime_config.h"
     #include "config/config.h"
+    #include "flight/governor.h"
     #include "flight/imu.h"
+    #include "flight/mixer.h"
 
     #include "io/serial.h"
     #include "io/gps.h"
@@ -84,6 +86,7 @@ extern "C" {
     PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
     PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
     PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG,0);
+    PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
 
     extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
@@ -285,6 +288,10 @@ extern "C" {
 
     bool airmodeIsEnabled(void) {return true;}
 
+    uint8_t getMotorCount(void) {return 0;}
+    const governorState_t *mixerGetGovernorState(void) {return NULL;}
+    void governorGetTelemetry(const governorState_t *, governorTelemetry_t *) {}
+
     mspDescriptor_t mspDescriptorAlloc(void) {return 0;}
 
     mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn) {
@@ -44,8 +44,10 @@ extern "C" {
     #include "config/config.h"
     #include "fc/runtime_config.h"
 
+    #include "flight/governor.h"
     #include "flight/pid.h"
     #include "flight/imu.h"
+    #include "flight/mixer.h"
 
     #include "io/gps.h"
     #include "io/serial.h"
@@ -74,6 +76,9 @@ extern "C" {
     PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
     PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
     PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+    PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+
+    governorState_t testGovernor;
 }
 
 #include "unittest_macros.h"
@@ -294,6 +299,43 @@ TEST(TelemetryCrsfTest, TestFlightMode)
     EXPECT_EQ(crfsCrc(frame, frameLen), frame[7]);
 }
 
+/*
+0x88 Governor (HF3D custom frame)
+*/
+TEST(TelemetryCrsfTest, TestGovernor)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+
+    memset(&testGovernor, 0, sizeof(testGovernor));
+    testGovernor.headspeed = 2148.6f;
+    testGovernor.setpoint = 2200;
+    testGovernor.setpointLimited = 2150.2f;
+    testGovernor.throttle = 0.6426f;
+    testGovernor.pidSum = -0.0123f;
+    testGovernor.collectiveFF = 0.05f;
+    testGovernor.collectivePulseFF = -0.002f;
+    testGovernor.cyclicFF = 0.0104f;
+    testGovernor.spooledUp = true;
+
+    int frameLen = getCrsfFrame(frame, CRSF_FRAMETYPE_GOVERNOR);
+    EXPECT_EQ(CRSF_FRAME_GOVERNOR_PAYLOAD_SIZE + 2 + FRAME_HEADER_FOOTER_LEN, frameLen);
+    EXPECT_EQ(CRSF_SYNC_BYTE, frame[0]); // address
+    EXPECT_EQ(21, frame[1]); // length
+    EXPECT_EQ(0x88, frame[2]); // type
+    EXPECT_EQ(CRSF_ADDRESS_RADIO_TRANSMITTER, frame[3]);
+    EXPECT_EQ(CRSF_ADDRESS_FLIGHT_CONTROLLER, frame[4]);
+    EXPECT_EQ(2149, frame[5] << 8 | frame[6]);      // headspeed
+    EXPECT_EQ(2200, frame[7] << 8 | frame[8]);      // setpoint
+    EXPECT_EQ(2150, frame[9] << 8 | frame[10]);     // rate limited setpoint
+    EXPECT_EQ(643, frame[11] << 8 | frame[12]);     // throttle
+    EXPECT_EQ(-12, (int16_t)(frame[13] << 8 | frame[14]));  // PID sum
+    EXPECT_EQ(50, (int16_t)(frame[15] << 8 | frame[16]));   // collective FF
+    EXPECT_EQ(-2, (int16_t)(frame[17] << 8 | frame[18]));   // collective impulse FF
+    EXPECT_EQ(10, (int16_t)(frame[19] << 8 | frame[20]));   // cyclic FF
+    EXPECT_EQ(GOV_STATUS_SPOOLED_UP | GOV_STATUS_ACTIVE, frame[21]);
+    EXPECT_EQ(crfsCrc(frame, frameLen), frame[22]);
+}
+
 // STUBS
 
 extern "C" {
@@ -375,4 +417,7 @@ void crsfScheduleMspResponse(void) {};
 bool isBatteryVoltageConfigured(void) { return true; }
 bool isAmperageConfigured(void) { return true; }
 
+uint8_t getMotorCount(void) { return 2; }
+const governorState_t *mixerGetGovernorState(void) { return &testGovernor; }
+
 }